@@ -0,0 +1,106 @@
+#include "AIScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+AIScheduler::AIScheduler()
+    : frameBudget(DEFAULT_FRAME_BUDGET_US), intervalStretch(1.0f)
+{
+}
+
+void AIScheduler::setFrameBudget(int microseconds)
+{
+    frameBudget = std::max(0, microseconds);
+}
+
+int AIScheduler::getFrameBudget() const
+{
+    return frameBudget;
+}
+
+void AIScheduler::request(int id, float distanceToPlayer)
+{
+    if (id < 0)
+        return;
+
+    if (id >= static_cast<int>(queuedSlot.size()))
+        queuedSlot.resize(id + 1, -1);
+
+    if (queuedSlot[id] != -1)
+    {
+        pending[queuedSlot[id]].distance = distanceToPlayer;
+        return;
+    }
+
+    queuedSlot[id] = static_cast<int>(pending.size());
+    pending.push_back({id, distanceToPlayer, 0});
+}
+
+int AIScheduler::runFrame(const std::function<void(int)> &think)
+{
+    if (pending.empty())
+    {
+        intervalStretch = std::max(1.0f, intervalStretch - STRETCH_DECAY);
+        return 0;
+    }
+
+    // Carried-over work first, longest waiting first; then nearest to the player
+    std::sort(pending.begin(), pending.end(),
+              [](const Entry &a, const Entry &b)
+              {
+                  if (a.waited != b.waited)
+                      return a.waited > b.waited;
+                  if (a.distance != b.distance)
+                      return a.distance < b.distance;
+                  return a.id < b.id;
+              });
+
+    auto frameStart = std::chrono::steady_clock::now();
+    size_t ran = 0;
+
+    while (ran < pending.size())
+    {
+        if (ran > 0)
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - frameStart);
+            if (elapsed.count() >= frameBudget)
+                break;
+        }
+
+        int id = pending[ran].id;
+        queuedSlot[id] = -1;
+        ran++;
+        think(id);
+    }
+
+    pending.erase(pending.begin(), pending.begin() + ran);
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        pending[i].waited++;
+        queuedSlot[pending[i].id] = static_cast<int>(i);
+    }
+
+    if (pending.empty())
+        intervalStretch = std::max(1.0f, intervalStretch - STRETCH_DECAY);
+    else
+        intervalStretch = std::min(MAX_INTERVAL_STRETCH, intervalStretch + STRETCH_GROWTH);
+
+    return static_cast<int>(ran);
+}
+
+float AIScheduler::getIntervalStretch() const
+{
+    return intervalStretch;
+}
+
+int AIScheduler::getPendingCount() const
+{
+    return static_cast<int>(pending.size());
+}
+
+void AIScheduler::clear()
+{
+    pending.clear();
+    queuedSlot.clear();
+    intervalStretch = 1.0f;
+}
@@ -0,0 +1,93 @@
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Spreads monster decisions across frames within a time budget
+ *
+ * Monsters whose think timer has run out are queued with their distance to
+ * the player. Each frame the queue is drained nearest first until the
+ * microsecond budget is spent; whatever is left carries over and goes ahead
+ * of newly queued work next frame, so nobody starves. At least one decision
+ * runs every frame, whatever the budget.
+ *
+ * While work keeps carrying over, the think interval is stretched so fewer
+ * monsters come due; once frames finish inside the budget again it relaxes
+ * back to the configured interval.
+ */
+class AIScheduler
+{
+public:
+    static constexpr int DEFAULT_FRAME_BUDGET_US = 2000; ///< Budget per frame (an eighth of a 60 Hz frame)
+    static constexpr float MAX_INTERVAL_STRETCH = 4.0f;  ///< Longest the think interval may grow to
+    static constexpr float STRETCH_GROWTH = 0.25f;       ///< Stretch added after a frame that carried work over
+    static constexpr float STRETCH_DECAY = 0.05f;        ///< Stretch removed after a frame that finished its work
+
+    /**
+     * @brief Constructor for AIScheduler
+     */
+    AIScheduler();
+
+    /**
+     * @brief Set the time decisions may take each frame
+     * @param microseconds Budget in microseconds (0 runs one decision per frame)
+     */
+    void setFrameBudget(int microseconds);
+
+    /**
+     * @brief Get the time decisions may take each frame
+     * @return Budget in microseconds
+     */
+    int getFrameBudget() const;
+
+    /**
+     * @brief Queue a decision, or refresh the priority of one already queued
+     * @param id Caller's identifier for the monster (its index)
+     * @param distanceToPlayer Distance used to order the queue, nearest first
+     */
+    void request(int id, float distanceToPlayer);
+
+    /**
+     * @brief Run queued decisions until the frame budget is spent
+     * @param think Called with the id of each decision to run
+     * @return Number of decisions run this frame
+     */
+    int runFrame(const std::function<void(int)> &think);
+
+    /**
+     * @brief Get the factor the think interval is currently stretched by
+     * @return 1.0 when keeping up, up to MAX_INTERVAL_STRETCH under load
+     */
+    float getIntervalStretch() const;
+
+    /**
+     * @brief Get the number of decisions waiting for a later frame
+     * @return Queue length
+     */
+    int getPendingCount() const;
+
+    /**
+     * @brief Drop all queued work and relax the stretch
+     */
+    void clear();
+
+private:
+    /**
+     * @brief One queued decision
+     */
+    struct Entry
+    {
+        int id;         ///< Caller's identifier
+        float distance; ///< Distance to the player when last queued
+        int waited;     ///< Frames the decision has already been carried over
+    };
+
+    int frameBudget;              ///< Microseconds of decisions per frame
+    float intervalStretch;        ///< Current think interval multiplier
+    std::vector<Entry> pending;   ///< Queued decisions
+    std::vector<int> queuedSlot;  ///< Per id: index into pending, or -1
+};
+
+#endif // AI_SCHEDULER_H
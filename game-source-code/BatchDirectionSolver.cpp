@@ -0,0 +1,187 @@
+#include "BatchDirectionSolver.h"
+#include "UtilityAI.h"
+#include <cstdlib>
+
+BatchDirectionSolver::BatchDirectionSolver()
+    : tablesVersion(0)
+{
+}
+
+void BatchDirectionSolver::clear()
+{
+    startX.clear();
+    startY.clear();
+    goalX.clear();
+    goalY.clear();
+    movementClasses.clear();
+}
+
+int BatchDirectionSolver::addQuery(Vector2 currentPos, Vector2 targetPos,
+                                   MonsterState movementClass, const Grid &grid)
+{
+    Vector2 startGridPos = grid.worldToGrid(currentPos);
+    Vector2 goalGridPos = grid.worldToGrid(targetPos);
+    int sx = static_cast<int>(startGridPos.x);
+    int sy = static_cast<int>(startGridPos.y);
+
+    // Mid-tile positions probe different neighbours; leave them to PathFinding
+    Vector2 snapped = grid.gridToWorld(sx, sy);
+    if (snapped.x != currentPos.x || snapped.y != currentPos.y)
+        return -1;
+
+    startX.push_back(sx);
+    startY.push_back(sy);
+    goalX.push_back(static_cast<int>(goalGridPos.x));
+    goalY.push_back(static_cast<int>(goalGridPos.y));
+    movementClasses.push_back(movementClass);
+
+    return static_cast<int>(startX.size()) - 1;
+}
+
+const std::vector<Direction> &BatchDirectionSolver::solve(const Grid &grid)
+{
+    refreshTables(grid);
+
+    const int count = getQueryCount();
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+
+    results.assign(count, Direction::NONE);
+    bestScores.assign(count, 0.0f);
+    validMoves.assign(4 * count, 0);
+    considerations.reset(4 * count);
+
+    // Same probe order and considerations as PathFinding::findBestDirectionToTarget
+    static const Direction directions[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static const int stepX[4] = {0, 0, -1, 1};
+    static const int stepY[4] = {-1, 1, 0, 0};
+
+    float *distanceGain = considerations.column(MoveConsideration::DISTANCE_GAIN);
+    float *alignment = considerations.column(MoveConsideration::ALIGNMENT);
+    float *deadEnd = considerations.column(MoveConsideration::DEAD_END);
+    float *playerThreat = considerations.column(MoveConsideration::PLAYER_THREAT);
+    float *fireDanger = considerations.column(MoveConsideration::FIRE_DANGER);
+    float *rockDanger = considerations.column(MoveConsideration::ROCK_DANGER);
+    float *crowding = considerations.column(MoveConsideration::CROWDING);
+    const bool sampleInfluence = UtilityAI::getWeights().usesInfluence();
+
+    // Candidate d * count + i is query i stepping in direction d
+    for (int d = 0; d < 4; d++)
+    {
+        const int dx = stepX[d];
+        const int dy = stepY[d];
+
+        for (int i = 0; i < count; i++)
+        {
+            int nx = startX[i] + dx;
+            int ny = startY[i] + dy;
+
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+                continue;
+
+            int tile = ny * width + nx;
+            bool canMove = (movementClasses[i] == MonsterState::IN_TUNNEL && tunnelTiles[tile]) ||
+                           (movementClasses[i] == MonsterState::DISEMBODIED && openTiles[tile]);
+            if (!canMove)
+                continue;
+
+            int candidate = d * count + i;
+            int toGoalX = goalX[i] - startX[i];
+            int toGoalY = goalY[i] - startY[i];
+            int dot = dx * toGoalX + dy * toGoalY;
+
+            validMoves[candidate] = 1;
+            distanceGain[candidate] = static_cast<float>(std::abs(toGoalX) + std::abs(toGoalY) -
+                                                         std::abs(goalX[i] - nx) - std::abs(goalY[i] - ny));
+            alignment[candidate] = dot > 0 ? static_cast<float>(dot) : 0.0f;
+            deadEnd[candidate] = deadEndTiles[tile];
+
+            if (sampleInfluence)
+            {
+                float values[static_cast<int>(MoveConsideration::COUNT)] = {};
+                UtilityAI::sampleInfluence(nx, ny, grid, values);
+                playerThreat[candidate] = values[static_cast<int>(MoveConsideration::PLAYER_THREAT)];
+                fireDanger[candidate] = values[static_cast<int>(MoveConsideration::FIRE_DANGER)];
+                rockDanger[candidate] = values[static_cast<int>(MoveConsideration::ROCK_DANGER)];
+                crowding[candidate] = values[static_cast<int>(MoveConsideration::CROWDING)];
+            }
+        }
+    }
+
+    // One weighted sum over every candidate of every query
+    const std::vector<float> &scores = considerations.score(UtilityAI::getWeights());
+
+    for (int d = 0; d < 4; d++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            int candidate = d * count + i;
+            if (!validMoves[candidate])
+                continue;
+
+            if (results[i] == Direction::NONE || scores[candidate] > bestScores[i])
+            {
+                results[i] = directions[d];
+                bestScores[i] = scores[candidate];
+            }
+        }
+    }
+
+    return results;
+}
+
+int BatchDirectionSolver::getQueryCount() const
+{
+    return static_cast<int>(startX.size());
+}
+
+Vector2 BatchDirectionSolver::getStartTile(int index) const
+{
+    return Vector2{static_cast<float>(startX[index]), static_cast<float>(startY[index])};
+}
+
+Vector2 BatchDirectionSolver::getGoalTile(int index) const
+{
+    return Vector2{static_cast<float>(goalX[index]), static_cast<float>(goalY[index])};
+}
+
+MonsterState BatchDirectionSolver::getMovementClass(int index) const
+{
+    return movementClasses[index];
+}
+
+void BatchDirectionSolver::refreshTables(const Grid &grid)
+{
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    const size_t tileCount = static_cast<size_t>(width * height);
+
+    if (tablesVersion == grid.getVersion() && tunnelTiles.size() == tileCount)
+        return;
+
+    tunnelTiles.assign(tileCount, 0);
+    openTiles.assign(tileCount, 0);
+    deadEndTiles.assign(tileCount, 0);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            TileType type = grid.getTile(x, y);
+            tunnelTiles[y * width + x] = type == TileType::TUNNEL;
+            openTiles[y * width + x] = type != TileType::ROCK;
+        }
+    }
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int exits = grid.isTunnel(x, y - 1) + grid.isTunnel(x, y + 1) +
+                        grid.isTunnel(x - 1, y) + grid.isTunnel(x + 1, y);
+            deadEndTiles[y * width + x] = exits <= 1;
+        }
+    }
+
+    tablesVersion = grid.getVersion();
+}
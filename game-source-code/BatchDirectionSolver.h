@@ -0,0 +1,106 @@
+#ifndef BATCH_DIRECTION_SOLVER_H
+#define BATCH_DIRECTION_SOLVER_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+#include "UtilityAI.h"
+
+/**
+ * @brief Scores the moves of many monsters in one pass over packed arrays
+ *
+ * Applies the same utility considerations as PathFinding::scoreDirection to
+ * every queued query: the four candidate moves of every query are written
+ * into packed consideration columns, scored by one weighted sum over the
+ * whole batch, and the best candidate of each query is kept. Buffers are
+ * reused between ticks, so a solve performs no per-monster allocation once
+ * warmed up.
+ */
+class BatchDirectionSolver
+{
+public:
+    /**
+     * @brief Constructor for BatchDirectionSolver
+     */
+    BatchDirectionSolver();
+
+    /**
+     * @brief Remove all queued queries (keeps buffer capacity)
+     */
+    void clear();
+
+    /**
+     * @brief Queue a query for the next solve
+     * @param currentPos Monster world position (must be tile-aligned)
+     * @param targetPos Target world position
+     * @param movementClass Movement rules of the monster
+     * @param grid Reference to the game grid
+     * @return Index of the query, or -1 if the position is not tile-aligned
+     */
+    int addQuery(Vector2 currentPos, Vector2 targetPos, MonsterState movementClass, const Grid &grid);
+
+    /**
+     * @brief Score every queued query
+     * @param grid Reference to the game grid
+     * @return One best direction per query, in query order (NONE if stuck)
+     */
+    const std::vector<Direction> &solve(const Grid &grid);
+
+    /**
+     * @brief Get the number of queued queries
+     * @return Query count
+     */
+    int getQueryCount() const;
+
+    /**
+     * @brief Get the start tile of a query
+     * @param index Query index
+     * @return Start tile in grid coordinates
+     */
+    Vector2 getStartTile(int index) const;
+
+    /**
+     * @brief Get the goal tile of a query
+     * @param index Query index
+     * @return Goal tile in grid coordinates
+     */
+    Vector2 getGoalTile(int index) const;
+
+    /**
+     * @brief Get the movement class of a query
+     * @param index Query index
+     * @return Movement class
+     */
+    MonsterState getMovementClass(int index) const;
+
+private:
+    // Packed query arrays
+    std::vector<int> startX;
+    std::vector<int> startY;
+    std::vector<int> goalX;
+    std::vector<int> goalY;
+    std::vector<MonsterState> movementClasses;
+
+    // Per-query working state
+    std::vector<float> bestScores;
+    std::vector<Direction> results;
+
+    // Per-candidate working state (four candidates per query)
+    std::vector<unsigned char> validMoves; // 1 if the move is allowed
+    UtilityBatch considerations;           // Consideration values of every candidate
+
+    // Per-tile tables derived from the grid, rebuilt when the grid version changes
+    std::vector<unsigned char> tunnelTiles;   // 1 if the tile is a tunnel
+    std::vector<unsigned char> openTiles;     // 1 if the tile is not rock
+    std::vector<unsigned char> deadEndTiles;  // 1 if the tile has at most one tunnel neighbour
+    unsigned int tablesVersion;               // Grid version the tables were built for
+
+    /**
+     * @brief Rebuild the per-tile tables if the grid changed
+     * @param grid Reference to the game grid
+     */
+    void refreshTables(const Grid &grid);
+};
+
+#endif // BATCH_DIRECTION_SOLVER_H
@@ -0,0 +1,237 @@
+#include "BehaviorLibrary.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // File names of the trees, indexed by MonsterKind
+    const char *const TREE_NAMES[3] = {"monster", "red_monster", "green_dragon"};
+
+    bool sameNode(const BehaviorNode &a, const BehaviorNode &b)
+    {
+        return a.type == b.type && a.leaf == b.leaf && a.end == b.end && a.value == b.value && a.modulus == b.modulus;
+    }
+}
+
+const char *const BehaviorLibrary::DEFAULT_BEHAVIORS = R"(
+tree monster
+  selector
+    sequence
+      condition in_tunnel
+      selector
+        sequence                      # settle in for two seconds unless the player lines up
+          condition state_time_below 2
+          invert
+            condition player_in_same_tunnel
+        action follow_corridor        # between junctions there is only one way on
+        sequence                      # close in on a nearby player
+          condition player_closer_than 96
+          selector
+            sequence
+              condition idle
+              action chase_player
+            succeed
+        sequence
+          condition may_disembody
+          condition wants_to_disembody
+          action become_disembodied
+        sequence                      # hold a chokepoint the player's escape runs through
+          condition idle
+          condition ambushes_chokepoints
+          action take_ambush_position
+        sequence                      # otherwise drift toward the player now and then
+          condition idle
+          chance 1 3
+          action wander
+    sequence
+      condition disembodied
+      selector
+        sequence                      # surface once the ghost time is up and there is tunnel below
+          condition state_time_above 4
+          condition over_tunnel
+          action resurface
+        succeed
+      condition idle
+      action chase_player
+
+tree green_dragon
+  selector
+    sequence
+      condition in_tunnel
+      selector
+        sequence                      # fire along a clear tunnel whenever possible
+          condition can_breathe_fire
+          condition player_in_fire_range
+          condition fire_line_to_player
+          action breathe_fire
+        sequence                      # hard mode: plan by looking ahead
+          condition idle
+          action search_ahead
+        branch
+          condition player_closer_than 96
+          sequence                    # close: chase
+            condition idle
+            action chase_player
+          branch
+            condition player_within 192
+            sequence                  # mid range: mostly chase, sometimes line up a shot
+              condition idle
+              branch
+                chance 1 5
+                action take_firing_position
+                action chase_player
+            selector                  # far: go ghost, or keep coming
+              sequence
+                condition may_disembody
+                condition state_time_above 2
+                action become_disembodied
+              sequence
+                condition idle
+                chance 3 5
+                action chase_player
+        sequence                      # nothing else worked: the odd random step
+          condition idle
+          invert
+            condition awaiting_route
+          chance 1 10
+          action random_step
+    sequence
+      condition disembodied
+      selector
+        sequence
+          condition state_time_above 4
+          condition over_tunnel
+          action resurface
+        succeed
+      condition idle
+      action home_in_on_player        # ghosts ignore tunnels, so head straight in
+)";
+
+BehaviorLibrary::BehaviorLibrary()
+{
+    std::string error;
+    parse(DEFAULT_BEHAVIORS, error);
+}
+
+bool BehaviorLibrary::parse(const std::string &text, std::string &error)
+{
+    std::vector<std::string> bodies[KIND_COUNT];
+    int firstLines[KIND_COUNT] = {0, 0, 0};
+    bool defined[KIND_COUNT] = {false, false, false};
+    int current = -1;
+
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+        std::string code = line.substr(0, line.find('#'));
+        if (code.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            if (current != -1)
+                bodies[current].push_back(line);
+            continue;
+        }
+
+        if (code[0] != ' ')
+        {
+            std::istringstream words(code);
+            std::string keyword, name, rest;
+            words >> keyword >> name;
+            if (keyword != "tree" || name.empty() || (words >> rest))
+            {
+                error = "line " + std::to_string(lineNumber) + ": expected \"tree <name>\"";
+                return false;
+            }
+
+            current = -1;
+            for (int k = 0; k < KIND_COUNT; k++)
+            {
+                if (name == TREE_NAMES[k])
+                    current = k;
+            }
+            if (current == -1 || defined[current])
+            {
+                error = "line " + std::to_string(lineNumber) + ": " +
+                        (current == -1 ? "unknown tree '" : "tree defined twice '") + name + "'";
+                return false;
+            }
+
+            defined[current] = true;
+            firstLines[current] = lineNumber + 1;
+            continue;
+        }
+
+        if (current == -1)
+        {
+            error = "line " + std::to_string(lineNumber) + ": node outside a tree";
+            return false;
+        }
+        bodies[current].push_back(line);
+    }
+
+    const int basic = static_cast<int>(MonsterKind::BASIC);
+    const int red = static_cast<int>(MonsterKind::RED);
+    const int dragon = static_cast<int>(MonsterKind::GREEN_DRAGON);
+    if (!defined[basic] || !defined[dragon])
+    {
+        error = std::string("missing tree '") + TREE_NAMES[defined[basic] ? dragon : basic] + "'";
+        return false;
+    }
+    if (!defined[red])
+    {
+        bodies[red] = bodies[basic];
+        firstLines[red] = firstLines[basic];
+    }
+
+    BehaviorTree compiled[KIND_COUNT];
+    for (int k = 0; k < KIND_COUNT; k++)
+    {
+        if (!compiled[k].compile(bodies[k], error, firstLines[k]))
+        {
+            error = std::string("tree '") + TREE_NAMES[k] + "', " + error;
+            return false;
+        }
+    }
+
+    for (int k = 0; k < KIND_COUNT; k++)
+        trees[k] = compiled[k];
+    return true;
+}
+
+bool BehaviorLibrary::load(const std::string &path, std::string &error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parse(contents.str(), error);
+}
+
+const BehaviorTree &BehaviorLibrary::getTree(MonsterKind kind) const
+{
+    return trees[static_cast<int>(kind)];
+}
+
+bool BehaviorLibrary::isBuiltIn(MonsterKind kind) const
+{
+    static const BehaviorLibrary builtIn;
+    const std::vector<BehaviorNode> &nodes = getTree(kind).getNodes();
+    const std::vector<BehaviorNode> &expected = builtIn.getTree(kind).getNodes();
+    return nodes.size() == expected.size() && std::equal(nodes.begin(), nodes.end(), expected.begin(), sameNode);
+}
+
+BehaviorLibrary &BehaviorLibrary::getShared()
+{
+    static BehaviorLibrary library;
+    return library;
+}
@@ -0,0 +1,72 @@
+#ifndef BEHAVIOR_LIBRARY_H
+#define BEHAVIOR_LIBRARY_H
+
+#include <string>
+#include "BehaviorTree.h"
+#include "GameEnums.h"
+
+/**
+ * @brief The behavior tree each kind of monster runs
+ *
+ * Trees come from a text file of "tree <name>" sections, each holding one
+ * tree in BehaviorTree::compile() syntax, so designers can change how
+ * monsters act without rebuilding. The built-in trees reproduce the
+ * hand-written AI and stand until a file replaces them; a test keeps them
+ * the same as the shipped resources/behaviors.txt.
+ */
+class BehaviorLibrary
+{
+public:
+    static const char *const DEFAULT_BEHAVIORS; ///< Built-in trees, in file syntax
+
+    /**
+     * @brief Constructor, compiles the built-in trees
+     */
+    BehaviorLibrary();
+
+    /**
+     * @brief Replace the trees with the ones in a behaviors file
+     *
+     * The file must define "monster" and "green_dragon"; "red_monster" falls
+     * back to the monster tree. Anything after a '#' is a comment.
+     * @param text Contents of a behaviors file
+     * @param error Receives a description of the first problem found
+     * @return true if every tree compiled; the trees are unchanged otherwise
+     */
+    bool parse(const std::string &text, std::string &error);
+
+    /**
+     * @brief Replace the trees with the ones in a file
+     * @param path Path of the behaviors file
+     * @param error Receives a description of the problem if loading fails
+     * @return true if the file was read and parsed; the trees are unchanged otherwise
+     */
+    bool load(const std::string &path, std::string &error);
+
+    /**
+     * @brief Get the tree a kind of monster runs
+     * @param kind Monster kind
+     * @return Compiled tree
+     */
+    const BehaviorTree &getTree(MonsterKind kind) const;
+
+    /**
+     * @brief Check whether a kind of monster runs the built-in tree
+     * @param kind Monster kind
+     * @return true if its tree compiles to the same nodes as the built-in one
+     */
+    bool isBuiltIn(MonsterKind kind) const;
+
+    /**
+     * @brief Get the library every monster uses
+     * @return Shared library
+     */
+    static BehaviorLibrary &getShared();
+
+private:
+    static const int KIND_COUNT = 3;
+
+    BehaviorTree trees[KIND_COUNT]; ///< Indexed by MonsterKind
+};
+
+#endif // BEHAVIOR_LIBRARY_H
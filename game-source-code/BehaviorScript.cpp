@@ -0,0 +1,220 @@
+#include "BehaviorScript.h"
+#include "Monster.h"
+#include <exception>
+#include <new>
+#include <utility>
+
+ScriptFramePool::ScriptFramePool()
+    : freeList(nullptr), blockCount(0), blocksInUse(0), oversizeCount(0)
+{
+}
+
+void *ScriptFramePool::allocate(std::size_t size)
+{
+    if (size > BLOCK_SIZE)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        oversizeCount++;
+        return ::operator new(size);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!freeList)
+        grow();
+
+    FreeBlock *block = freeList;
+    freeList = block->next;
+    blocksInUse++;
+    return block;
+}
+
+void ScriptFramePool::deallocate(void *frame, std::size_t size)
+{
+    if (size > BLOCK_SIZE)
+    {
+        ::operator delete(frame);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock *block = static_cast<FreeBlock *>(frame);
+    block->next = freeList;
+    freeList = block;
+    blocksInUse--;
+}
+
+int ScriptFramePool::getBlocksInUse() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocksInUse;
+}
+
+int ScriptFramePool::getBlockCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blockCount;
+}
+
+int ScriptFramePool::getOversizeCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return oversizeCount;
+}
+
+ScriptFramePool &ScriptFramePool::getShared()
+{
+    static ScriptFramePool pool;
+    return pool;
+}
+
+void ScriptFramePool::grow()
+{
+    // new[] memory is aligned for any frame the default operator new would serve
+    static_assert(BLOCK_SIZE % alignof(std::max_align_t) == 0, "blocks must keep frames aligned");
+
+    chunks.push_back(std::make_unique<unsigned char[]>(BLOCK_SIZE * BLOCKS_PER_CHUNK));
+    unsigned char *chunk = chunks.back().get();
+
+    for (int i = BLOCKS_PER_CHUNK - 1; i >= 0; i--)
+    {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + i * BLOCK_SIZE);
+        block->next = freeList;
+        freeList = block;
+    }
+    blockCount += BLOCKS_PER_CHUNK;
+}
+
+BehaviorTask BehaviorTask::promise_type::get_return_object()
+{
+    auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+    resumePoint = handle;
+    return BehaviorTask(handle);
+}
+
+BehaviorTask::FinalAwaiter BehaviorTask::promise_type::final_suspend() noexcept
+{
+    return {};
+}
+
+void BehaviorTask::promise_type::unhandled_exception()
+{
+    std::terminate();
+}
+
+void *BehaviorTask::promise_type::operator new(std::size_t size)
+{
+    return ScriptFramePool::getShared().allocate(size);
+}
+
+void BehaviorTask::promise_type::operator delete(void *frame, std::size_t size)
+{
+    ScriptFramePool::getShared().deallocate(frame, size);
+}
+
+std::coroutine_handle<> BehaviorTask::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> finished) noexcept
+{
+    promise_type &promise = finished.promise();
+    if (!promise.continuation)
+        return std::noop_coroutine();
+
+    promise.root->resumePoint = promise.continuation;
+    return promise.continuation;
+}
+
+BehaviorTask::BehaviorTask(std::coroutine_handle<promise_type> handle)
+    : handle(handle)
+{
+}
+
+BehaviorTask::BehaviorTask(BehaviorTask &&other) noexcept
+    : handle(std::exchange(other.handle, nullptr))
+{
+}
+
+BehaviorTask &BehaviorTask::operator=(BehaviorTask &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (handle)
+            handle.destroy();
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+BehaviorTask::~BehaviorTask()
+{
+    if (handle)
+        handle.destroy();
+}
+
+bool BehaviorTask::isValid() const
+{
+    return static_cast<bool>(handle);
+}
+
+bool BehaviorTask::isDone() const
+{
+    return !handle || handle.done();
+}
+
+void BehaviorTask::resume()
+{
+    if (isDone())
+        return;
+
+    handle.promise().resumePoint.resume();
+}
+
+ScriptWait BehaviorTask::getWait() const
+{
+    return handle ? handle.promise().wait : ScriptWait::NEXT_THINK;
+}
+
+float BehaviorTask::getSleepSeconds() const
+{
+    return handle ? handle.promise().sleepSeconds : 0.0f;
+}
+
+bool BehaviorTask::await_ready() const noexcept
+{
+    return !handle || handle.done();
+}
+
+std::coroutine_handle<> BehaviorTask::await_suspend(std::coroutine_handle<promise_type> awaiting) noexcept
+{
+    // The sub-script joins the awaiting chain and starts straight away
+    promise_type &promise = handle.promise();
+    promise.root = awaiting.promise().root;
+    promise.continuation = awaiting;
+    promise.root->resumePoint = handle;
+    return handle;
+}
+
+void ScriptSuspend::await_suspend(std::coroutine_handle<BehaviorTask::promise_type> script) noexcept
+{
+    BehaviorTask::promise_type &root = *script.promise().root;
+    root.resumePoint = script;
+    root.wait = wait;
+    root.sleepSeconds = seconds;
+}
+
+ScriptAgent::ScriptAgent(Monster *monster)
+    : monster(monster)
+{
+}
+
+bool ScriptAgent::check(BehaviorCondition condition, float value) const
+{
+    return monster->checkBehaviorCondition(condition, value, *monster->scriptContext);
+}
+
+BehaviorStatus ScriptAgent::act(BehaviorAction action) const
+{
+    return monster->runBehaviorAction(action, *monster->scriptContext);
+}
+
+int ScriptAgent::random() const
+{
+    return monster->random();
+}
@@ -0,0 +1,234 @@
+#ifndef BEHAVIOR_SCRIPT_H
+#define BEHAVIOR_SCRIPT_H
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "BehaviorTree.h"
+
+class Monster;
+
+/**
+ * @brief Free-list allocator for behavior script coroutine frames
+ *
+ * Frames are carved from fixed-size blocks in chunks that are kept for the
+ * life of the pool, so starting a script or awaiting a sub-script reuses a
+ * block instead of going to the heap, and resuming never allocates at all.
+ * Frames too big for a block fall back to the heap and are counted.
+ * Allocation is locked, as scripts may start sub-scripts while monsters
+ * decide in parallel.
+ */
+class ScriptFramePool
+{
+public:
+    static const std::size_t BLOCK_SIZE = 512; ///< Largest frame served from the pool (bytes)
+    static const int BLOCKS_PER_CHUNK = 64;    ///< Blocks allocated together when the pool runs dry
+
+    /**
+     * @brief Constructor for ScriptFramePool
+     */
+    ScriptFramePool();
+
+    ScriptFramePool(const ScriptFramePool &) = delete;
+    ScriptFramePool &operator=(const ScriptFramePool &) = delete;
+
+    /**
+     * @brief Get memory for a coroutine frame
+     * @param size Frame size in bytes
+     * @return Block from the free list, or heap memory for an oversized frame
+     */
+    void *allocate(std::size_t size);
+
+    /**
+     * @brief Give a frame back
+     * @param frame Memory returned by allocate()
+     * @param size Size it was allocated with
+     */
+    void deallocate(void *frame, std::size_t size);
+
+    /**
+     * @brief Get the number of blocks holding a live frame
+     * @return Blocks in use
+     */
+    int getBlocksInUse() const;
+
+    /**
+     * @brief Get the number of blocks the pool owns
+     * @return Blocks allocated so far, used or free
+     */
+    int getBlockCount() const;
+
+    /**
+     * @brief Get the number of frames that were too big for a block
+     * @return Heap allocations made since start-up
+     */
+    int getOversizeCount() const;
+
+    /**
+     * @brief Get the pool every script frame comes from
+     * @return Process-wide pool
+     */
+    static ScriptFramePool &getShared();
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next; ///< Next free block
+    };
+
+    mutable std::mutex mutex;                             ///< Guards everything below
+    std::vector<std::unique_ptr<unsigned char[]>> chunks; ///< Memory the blocks are carved from
+    FreeBlock *freeList;                                  ///< Blocks ready for reuse
+    int blockCount;                                       ///< Blocks carved so far
+    int blocksInUse;                                      ///< Blocks holding a frame
+    int oversizeCount;                                    ///< Frames sent to the heap
+
+    // Carve another chunk into free blocks; mutex must be held
+    void grow();
+};
+
+/**
+ * @brief What a suspended behavior script is waiting for
+ */
+enum class ScriptWait
+{
+    NEXT_THINK, // Resume on the monster's next think
+    TIME,       // Sleep; the monster does not think until the time is up
+    TILE        // Resume once the monster has finished its step
+};
+
+/**
+ * @brief Coroutine a monster behavior is written as
+ *
+ * A script runs as plain sequential code and suspends with co_await:
+ * seconds(s) sleeps, reachedTile() waits for the current step to finish and
+ * nextThink() yields until the next think. Awaiting another BehaviorTask runs
+ * it as a step of this one. Scripts start suspended; the monster resumes the
+ * innermost suspended task each think.
+ */
+class BehaviorTask
+{
+public:
+    struct FinalAwaiter;
+
+    struct promise_type
+    {
+        promise_type *root = this;                ///< Outermost script of the chain
+        std::coroutine_handle<> continuation;     ///< Task awaiting this one, if any
+        std::coroutine_handle<> resumePoint;      ///< Root only: innermost suspended task
+        ScriptWait wait = ScriptWait::NEXT_THINK; ///< Root only: what the last suspension waits for
+        float sleepSeconds = 0.0f;                ///< Root only: how long a TIME wait lasts
+
+        BehaviorTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept;
+        void return_void() {}
+        void unhandled_exception();
+
+        static void *operator new(std::size_t size);
+        static void operator delete(void *frame, std::size_t size);
+    };
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        // Carry on in the awaiting task, if there is one
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    BehaviorTask() = default;
+    BehaviorTask(BehaviorTask &&other) noexcept;
+    BehaviorTask &operator=(BehaviorTask &&other) noexcept;
+    BehaviorTask(const BehaviorTask &) = delete;
+    BehaviorTask &operator=(const BehaviorTask &) = delete;
+    ~BehaviorTask();
+
+    bool isValid() const;
+    bool isDone() const;
+
+    /**
+     * @brief Run the script until it next suspends
+     */
+    void resume();
+
+    /**
+     * @brief Get what the script is waiting for
+     * @return Wait of the last suspension
+     */
+    ScriptWait getWait() const;
+
+    /**
+     * @brief Get how long a TIME wait lasts
+     * @return Seconds
+     */
+    float getSleepSeconds() const;
+
+    // Awaiting a task runs it as a step of the awaiting script
+    bool await_ready() const noexcept;
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> awaiting) noexcept;
+    void await_resume() const noexcept {}
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit BehaviorTask(std::coroutine_handle<promise_type> handle);
+};
+
+/**
+ * @brief Awaitable that suspends a script until its wait is over
+ */
+struct ScriptSuspend
+{
+    ScriptWait wait; ///< What to wait for
+    float seconds;   ///< Length of a TIME wait
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<BehaviorTask::promise_type> script) noexcept;
+    void await_resume() const noexcept {}
+};
+
+// Sleep; the monster costs nothing until it wakes (at the earliest on the think after)
+inline ScriptSuspend seconds(float duration)
+{
+    return ScriptSuspend{ScriptWait::TIME, duration};
+}
+
+// Wait until the step under way is finished
+inline ScriptSuspend reachedTile()
+{
+    return ScriptSuspend{ScriptWait::TILE, 0.0f};
+}
+
+// Yield until the next think
+inline ScriptSuspend nextThink()
+{
+    return ScriptSuspend{ScriptWait::NEXT_THINK, 0.0f};
+}
+
+/**
+ * @brief A monster as a behavior script sees it
+ *
+ * Conditions and actions are the behavior tree leaves, answered and carried
+ * out exactly as they are for the trees.
+ */
+class ScriptAgent
+{
+public:
+    explicit ScriptAgent(Monster *monster);
+
+    bool check(BehaviorCondition condition, float value = 0.0f) const;
+    BehaviorStatus act(BehaviorAction action) const;
+    // rand(), or the decision's own stream while deciding
+    int random() const;
+
+private:
+    Monster *monster; ///< Not owned; outlives its script
+};
+
+// Starts a script for a monster
+using BehaviorScript = BehaviorTask (*)(ScriptAgent monster);
+
+#endif // BEHAVIOR_SCRIPT_H
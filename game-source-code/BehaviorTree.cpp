@@ -0,0 +1,224 @@
+#include "BehaviorTree.h"
+#include <sstream>
+#include <utility>
+
+namespace
+{
+    const int CONDITION_COUNT = static_cast<int>(BehaviorCondition::COUNT);
+    const int ACTION_COUNT = static_cast<int>(BehaviorAction::COUNT);
+    const int MAX_NODES = 65535; // Subtree ends are stored in an unsigned short
+
+    // Names used in behavior files, in enum order
+    const char *const CONDITION_NAMES[CONDITION_COUNT] = {
+        "in_tunnel", "disembodied", "idle", "awaiting_route",
+        "player_closer_than", "player_within", "player_beyond", "player_in_same_tunnel",
+        "state_time_above", "state_time_below", "over_tunnel",
+        "may_disembody", "wants_to_disembody", "ambushes_chokepoints",
+        "can_breathe_fire", "player_in_fire_range", "fire_line_to_player",
+        "player_facing_me", "player_approaching", "harpoon_out"};
+    const char *const ACTION_NAMES[ACTION_COUNT] = {
+        "follow_corridor", "chase_player", "wander", "random_step", "home_in_on_player",
+        "take_ambush_position", "become_disembodied", "resurface",
+        "breathe_fire", "take_firing_position", "search_ahead"};
+
+    bool conditionTakesValue(BehaviorCondition condition)
+    {
+        switch (condition)
+        {
+        case BehaviorCondition::PLAYER_CLOSER_THAN:
+        case BehaviorCondition::PLAYER_WITHIN:
+        case BehaviorCondition::PLAYER_BEYOND:
+        case BehaviorCondition::STATE_TIME_ABOVE:
+        case BehaviorCondition::STATE_TIME_BELOW:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool isComposite(BehaviorNodeType type)
+    {
+        return type == BehaviorNodeType::SELECTOR || type == BehaviorNodeType::SEQUENCE ||
+               type == BehaviorNodeType::BRANCH || type == BehaviorNodeType::INVERT;
+    }
+
+    int findName(const std::string &name, const char *const *names, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (name == names[i])
+                return i;
+        }
+        return -1;
+    }
+
+    // Parse one node line (indentation already removed); returns an empty string or an error
+    std::string parseNode(const std::string &text, BehaviorNode &node)
+    {
+        std::istringstream words(text);
+        std::string keyword, name, rest;
+        words >> keyword;
+
+        node = BehaviorNode{BehaviorNodeType::SUCCEED, 0, 0, 0.0f, 1};
+
+        if (keyword == "selector" || keyword == "sequence" || keyword == "branch" ||
+            keyword == "invert" || keyword == "succeed")
+        {
+            node.type = keyword == "selector"   ? BehaviorNodeType::SELECTOR
+                        : keyword == "sequence" ? BehaviorNodeType::SEQUENCE
+                        : keyword == "branch"   ? BehaviorNodeType::BRANCH
+                        : keyword == "invert"   ? BehaviorNodeType::INVERT
+                                                : BehaviorNodeType::SUCCEED;
+        }
+        else if (keyword == "chance")
+        {
+            int numerator = 0;
+            if (!(words >> numerator >> node.modulus) || numerator < 0 || node.modulus <= 0)
+                return "chance needs two whole numbers, the second above zero";
+            node.type = BehaviorNodeType::CHANCE;
+            node.value = static_cast<float>(numerator);
+        }
+        else if (keyword == "condition")
+        {
+            words >> name;
+            int condition = findName(name, CONDITION_NAMES, CONDITION_COUNT);
+            if (condition == -1)
+                return "unknown condition '" + name + "'";
+
+            node.type = BehaviorNodeType::CONDITION;
+            node.leaf = static_cast<unsigned char>(condition);
+            if (conditionTakesValue(static_cast<BehaviorCondition>(condition)) && !(words >> node.value))
+                return "condition '" + name + "' needs a value";
+        }
+        else if (keyword == "action")
+        {
+            words >> name;
+            int action = findName(name, ACTION_NAMES, ACTION_COUNT);
+            if (action == -1)
+                return "unknown action '" + name + "'";
+
+            node.type = BehaviorNodeType::ACTION;
+            node.leaf = static_cast<unsigned char>(action);
+        }
+        else
+        {
+            return "unknown node '" + keyword + "'";
+        }
+
+        if (words >> rest)
+            return "unexpected '" + rest + "'";
+        return "";
+    }
+
+    // Check the child count of a composite whose subtree is complete
+    std::string checkChildren(const std::vector<BehaviorNode> &nodes, int index)
+    {
+        int children = 0;
+        for (int child = index + 1; child < nodes[index].end; child = nodes[child].end)
+            children++;
+
+        switch (nodes[index].type)
+        {
+        case BehaviorNodeType::BRANCH:
+            return children == 3 ? "" : "branch needs exactly three children (condition, then, else)";
+        case BehaviorNodeType::INVERT:
+            return children == 1 ? "" : "invert needs exactly one child";
+        default:
+            return children >= 1 ? "" : "selector and sequence need at least one child";
+        }
+    }
+}
+
+BehaviorTree::BehaviorTree()
+{
+}
+
+bool BehaviorTree::compile(const std::vector<std::string> &lines, std::string &error, int firstLineNumber)
+{
+    std::vector<BehaviorNode> compiled;
+    std::vector<int> open;     // Composites whose children are still being read
+    std::vector<int> openLine; // Line number of each open composite
+    int baseIndent = -1;
+
+    auto fail = [&error](int lineNumber, const std::string &message)
+    {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    // Close composites until the given number remain open
+    auto closeTo = [&](size_t depth)
+    {
+        while (open.size() > depth)
+        {
+            compiled[open.back()].end = static_cast<unsigned short>(compiled.size());
+            std::string problem = checkChildren(compiled, open.back());
+            if (!problem.empty())
+                return fail(openLine.back(), problem);
+            open.pop_back();
+            openLine.pop_back();
+        }
+        return true;
+    };
+
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        int lineNumber = firstLineNumber + static_cast<int>(i);
+        std::string line = lines[i].substr(0, lines[i].find('#'));
+        size_t first = line.find_first_not_of(' ');
+        if (first == std::string::npos || line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        if (line[first] == '\t')
+            return fail(lineNumber, "indent with spaces, not tabs");
+
+        int indent = static_cast<int>(first);
+        if (baseIndent == -1)
+            baseIndent = indent;
+        if (indent < baseIndent || (indent - baseIndent) % 2 != 0)
+            return fail(lineNumber, "indent by two spaces per level");
+
+        size_t depth = static_cast<size_t>((indent - baseIndent) / 2);
+        if (depth > open.size())
+            return fail(lineNumber, "indented deeper than its parent allows");
+        if (!closeTo(depth))
+            return false;
+        if (depth == 0 && !compiled.empty())
+            return fail(lineNumber, "a tree has only one root");
+
+        BehaviorNode node;
+        std::string problem = parseNode(line.substr(first), node);
+        if (!problem.empty())
+            return fail(lineNumber, problem);
+        if (static_cast<int>(compiled.size()) >= MAX_NODES)
+            return fail(lineNumber, "too many nodes");
+
+        node.end = static_cast<unsigned short>(compiled.size() + 1);
+        compiled.push_back(node);
+        if (isComposite(node.type))
+        {
+            open.push_back(static_cast<int>(compiled.size()) - 1);
+            openLine.push_back(lineNumber);
+        }
+    }
+
+    if (!closeTo(0))
+        return false;
+    if (compiled.empty())
+    {
+        error = "tree is empty";
+        return false;
+    }
+
+    nodes = std::move(compiled);
+    return true;
+}
+
+const std::vector<BehaviorNode> &BehaviorTree::getNodes() const
+{
+    return nodes;
+}
+
+BehaviorState BehaviorTree::initialState()
+{
+    return BehaviorState{0, BehaviorStatus::SUCCESS, 0};
+}
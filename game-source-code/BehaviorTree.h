@@ -0,0 +1,245 @@
+#ifndef BEHAVIOR_TREE_H
+#define BEHAVIOR_TREE_H
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Result of ticking a behavior tree node
+ */
+enum class BehaviorStatus : unsigned char
+{
+    SUCCESS,
+    FAILURE,
+    RUNNING // Still working on it (e.g. waiting for a route); stops the tick like SUCCESS
+};
+
+/**
+ * @brief Kinds of behavior tree node
+ */
+enum class BehaviorNodeType : unsigned char
+{
+    SELECTOR,  // Ticks children in order until one does not fail
+    SEQUENCE,  // Ticks children in order until one does not succeed
+    BRANCH,    // Three children: if the first succeeds tick the second, otherwise the third
+    INVERT,    // One child: swaps success and failure
+    SUCCEED,   // Leaf that always succeeds
+    CHANCE,    // Leaf that succeeds when agent.random() % modulus < value
+    CONDITION, // Leaf asking the agent a question
+    ACTION     // Leaf asking the agent to act
+};
+
+/**
+ * @brief Questions a monster's behavior tree can ask
+ */
+enum class BehaviorCondition : unsigned char
+{
+    IN_TUNNEL,
+    DISEMBODIED,
+    IDLE,                  // Not moving between tiles
+    AWAITING_ROUTE,        // An asynchronous route request is outstanding
+    PLAYER_CLOSER_THAN,    // Distance to the player < value (pixels)
+    PLAYER_WITHIN,         // Distance to the player <= value (pixels)
+    PLAYER_BEYOND,         // Distance to the player > value (pixels)
+    PLAYER_IN_SAME_TUNNEL, // Same row or column as the player
+    STATE_TIME_ABOVE,      // Seconds in the current state > value
+    STATE_TIME_BELOW,      // Seconds in the current state < value
+    OVER_TUNNEL,           // Standing on a tunnel tile
+    MAY_DISEMBODY,         // The game allows a monster to go disembodied now
+    WANTS_TO_DISEMBODY,    // The monster's own (random) wish to go disembodied
+    AMBUSHES_CHOKEPOINTS,  // The monster holds chokepoints instead of wandering
+    CAN_BREATHE_FIRE,      // Dragon: fire ready and not in flight
+    PLAYER_IN_FIRE_RANGE,  // Dragon: player within breath range
+    FIRE_LINE_TO_PLAYER,   // Dragon: straight clear tunnel to the player
+    PLAYER_FACING_ME,      // In line ahead of the way the player faces
+    PLAYER_APPROACHING,    // The player moved this way since the last tick
+    HARPOON_OUT,           // The harpoon is in flight
+    COUNT
+};
+
+/**
+ * @brief Things a monster's behavior tree can ask it to do
+ */
+enum class BehaviorAction : unsigned char
+{
+    FOLLOW_CORRIDOR,      // Step onward along the corridor; fails at junctions
+    CHASE_PLAYER,         // Step along the chase route; running while a route is on its way
+    WANDER,               // Chase step, or a random step if there is no route
+    RANDOM_STEP,          // Step in a random open direction
+    HOME_IN_ON_PLAYER,    // Greedy step toward the player, ignoring planned routes
+    TAKE_AMBUSH_POSITION, // Hold or step onto a chokepoint near the player
+    BECOME_DISEMBODIED,
+    RESURFACE,            // Back to tunnel movement
+    BREATHE_FIRE,         // Dragon: breathe toward the player
+    TAKE_FIRING_POSITION, // Dragon: step to a better firing tile
+    SEARCH_AHEAD,         // Dragon: act on a lookahead search; fails when none is attached
+    COUNT
+};
+
+/**
+ * @brief One node of a flattened tree
+ *
+ * Nodes are stored in pre-order: the first child of node i is node i + 1,
+ * and each child's next sibling starts at the child's end index.
+ */
+struct BehaviorNode
+{
+    BehaviorNodeType type; ///< Node kind
+    unsigned char leaf;    ///< BehaviorCondition or BehaviorAction of a leaf
+    unsigned short end;    ///< Index one past the last node of this subtree
+    float value;           ///< Condition threshold or chance numerator
+    int modulus;           ///< Chance denominator
+};
+
+/**
+ * @brief Per-agent record of the last tick, small enough to embed in every monster
+ */
+struct BehaviorState
+{
+    unsigned short lastLeaf;    ///< Leaf that decided the last tick's outcome
+    BehaviorStatus lastStatus;  ///< Outcome of the last tick
+    unsigned char runningTicks; ///< Consecutive ticks the same leaf has been running (saturates)
+};
+
+/**
+ * @brief Behavior tree compiled into one contiguous node array
+ *
+ * Trees are written as indented text, one node per line, two spaces per
+ * level, and compiled once; ticking walks the array with no allocation.
+ * Ticks are reactive: every tick starts again at the root, so a higher
+ * priority branch always gets to pre-empt a running one. All the state an
+ * agent needs between ticks is its BehaviorState.
+ */
+class BehaviorTree
+{
+public:
+    /**
+     * @brief Constructor for an empty tree (ticks to FAILURE)
+     */
+    BehaviorTree();
+
+    /**
+     * @brief Compile a tree from text
+     *
+     * Lines are "selector", "sequence", "branch", "invert", "succeed",
+     * "chance <n> <m>", "condition <name> [value]" or "action <name>",
+     * indented two spaces under their parent. Anything after a '#' is a
+     * comment. The text must hold exactly one root.
+     * @param lines Lines of the tree, indented relative to the first
+     * @param error Receives a description of the first problem found
+     * @param firstLineNumber Line number of lines[0], for error messages
+     * @return true if the tree compiled; the tree is unchanged otherwise
+     */
+    bool compile(const std::vector<std::string> &lines, std::string &error, int firstLineNumber = 1);
+
+    /**
+     * @brief Tick the tree for one agent
+     * @param state The agent's state between ticks
+     * @param agent Object with checkCondition(BehaviorCondition, float), runAction(BehaviorAction)
+     *              and random(), a rand()-like source for chance leaves
+     * @return Outcome of the root
+     */
+    template <typename Agent>
+    BehaviorStatus tick(BehaviorState &state, Agent &agent) const;
+
+    /**
+     * @brief Get the flattened nodes
+     * @return Nodes in pre-order
+     */
+    const std::vector<BehaviorNode> &getNodes() const;
+
+    /**
+     * @brief Get a fresh per-agent state
+     * @return State for an agent that has not ticked yet
+     */
+    static BehaviorState initialState();
+
+private:
+    std::vector<BehaviorNode> nodes; ///< Pre-order node array
+
+    template <typename Agent>
+    BehaviorStatus tickNode(int index, int &decidingLeaf, Agent &agent) const;
+};
+
+template <typename Agent>
+BehaviorStatus BehaviorTree::tick(BehaviorState &state, Agent &agent) const
+{
+    if (nodes.empty())
+        return BehaviorStatus::FAILURE;
+
+    int decidingLeaf = 0;
+    BehaviorStatus status = tickNode(0, decidingLeaf, agent);
+
+    bool stillRunning = status == BehaviorStatus::RUNNING && state.lastStatus == BehaviorStatus::RUNNING &&
+                        state.lastLeaf == decidingLeaf;
+    state.runningTicks = stillRunning ? static_cast<unsigned char>(state.runningTicks < 255 ? state.runningTicks + 1 : 255)
+                                      : static_cast<unsigned char>(status == BehaviorStatus::RUNNING ? 1 : 0);
+    state.lastLeaf = static_cast<unsigned short>(decidingLeaf);
+    state.lastStatus = status;
+    return status;
+}
+
+template <typename Agent>
+BehaviorStatus BehaviorTree::tickNode(int index, int &decidingLeaf, Agent &agent) const
+{
+    const BehaviorNode &node = nodes[index];
+
+    switch (node.type)
+    {
+    case BehaviorNodeType::SELECTOR:
+    case BehaviorNodeType::SEQUENCE:
+    {
+        BehaviorStatus carryOn = node.type == BehaviorNodeType::SELECTOR ? BehaviorStatus::FAILURE : BehaviorStatus::SUCCESS;
+        BehaviorStatus status = carryOn;
+        for (int child = index + 1; child < node.end; child = nodes[child].end)
+        {
+            status = tickNode(child, decidingLeaf, agent);
+            if (status != carryOn)
+                break;
+        }
+        return status;
+    }
+
+    case BehaviorNodeType::BRANCH:
+    {
+        int condition = index + 1;
+        int thenChild = nodes[condition].end;
+        int elseChild = nodes[thenChild].end;
+        BehaviorStatus test = tickNode(condition, decidingLeaf, agent);
+        if (test == BehaviorStatus::RUNNING)
+            return test;
+        return tickNode(test == BehaviorStatus::SUCCESS ? thenChild : elseChild, decidingLeaf, agent);
+    }
+
+    case BehaviorNodeType::INVERT:
+    {
+        BehaviorStatus status = tickNode(index + 1, decidingLeaf, agent);
+        if (status == BehaviorStatus::RUNNING)
+            return status;
+        return status == BehaviorStatus::SUCCESS ? BehaviorStatus::FAILURE : BehaviorStatus::SUCCESS;
+    }
+
+    case BehaviorNodeType::SUCCEED:
+        decidingLeaf = index;
+        return BehaviorStatus::SUCCESS;
+
+    case BehaviorNodeType::CHANCE:
+        decidingLeaf = index;
+        return (agent.random() % node.modulus) < node.value ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
+
+    case BehaviorNodeType::CONDITION:
+        decidingLeaf = index;
+        return agent.checkCondition(static_cast<BehaviorCondition>(node.leaf), node.value)
+                   ? BehaviorStatus::SUCCESS
+                   : BehaviorStatus::FAILURE;
+
+    case BehaviorNodeType::ACTION:
+        decidingLeaf = index;
+        return agent.runAction(static_cast<BehaviorAction>(node.leaf));
+    }
+
+    return BehaviorStatus::FAILURE;
+}
+
+#endif // BEHAVIOR_TREE_H
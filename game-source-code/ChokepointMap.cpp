@@ -0,0 +1,147 @@
+#include "ChokepointMap.h"
+#include <algorithm>
+
+ChokepointMap::ChokepointMap()
+    : width(0), height(0), gridVersion(0), chokepointCount(0)
+{
+}
+
+void ChokepointMap::refresh(const Grid &grid)
+{
+    if (gridVersion == grid.getVersion() && width == grid.getWidth() && height == grid.getHeight())
+        return;
+
+    rebuild(grid);
+}
+
+bool ChokepointMap::isChokepoint(int x, int y) const
+{
+    if (!inBounds(x, y))
+        return false;
+
+    return (flags[y * width + x] & CHOKEPOINT) != 0;
+}
+
+bool ChokepointMap::isBridge(int x, int y, Direction direction) const
+{
+    // Each passage is stored once, on its left or upper tile
+    switch (direction)
+    {
+    case Direction::RIGHT:
+        return inBounds(x, y) && (flags[y * width + x] & BRIDGE_RIGHT) != 0;
+    case Direction::LEFT:
+        return inBounds(x - 1, y) && (flags[y * width + x - 1] & BRIDGE_RIGHT) != 0;
+    case Direction::DOWN:
+        return inBounds(x, y) && (flags[y * width + x] & BRIDGE_DOWN) != 0;
+    case Direction::UP:
+        return inBounds(x, y - 1) && (flags[(y - 1) * width + x] & BRIDGE_DOWN) != 0;
+    default:
+        return false;
+    }
+}
+
+int ChokepointMap::getChokepointCount() const
+{
+    return chokepointCount;
+}
+
+unsigned int ChokepointMap::getGridVersion() const
+{
+    return gridVersion;
+}
+
+void ChokepointMap::rebuild(const Grid &grid)
+{
+    static const int stepX[4] = {0, 0, -1, 1};
+    static const int stepY[4] = {-1, 1, 0, 0};
+
+    width = grid.getWidth();
+    height = grid.getHeight();
+    gridVersion = grid.getVersion();
+    chokepointCount = 0;
+
+    const int tileCount = width * height;
+    flags.assign(tileCount, 0);
+    discovery.assign(tileCount, 0);
+    low.assign(tileCount, 0);
+    parent.assign(tileCount, -1);
+    nextEdge.assign(tileCount, 0);
+
+    auto markChokepoint = [this](int tile)
+    {
+        if ((flags[tile] & CHOKEPOINT) == 0)
+        {
+            flags[tile] |= CHOKEPOINT;
+            chokepointCount++;
+        }
+    };
+
+    // Tarjan's depth-first search with an explicit stack; a level can hold
+    // hundreds of tunnel tiles in one chain
+    int order = 0;
+    for (int root = 0; root < tileCount; root++)
+    {
+        if (discovery[root] != 0 || !grid.isTunnel(root % width, root / width))
+            continue;
+
+        int rootChildren = 0;
+        discovery[root] = low[root] = ++order;
+        stack.clear();
+        stack.push_back(root);
+
+        while (!stack.empty())
+        {
+            int tile = stack.back();
+
+            if (nextEdge[tile] < 4)
+            {
+                int d = nextEdge[tile]++;
+                int nx = tile % width + stepX[d];
+                int ny = tile / width + stepY[d];
+                if (!inBounds(nx, ny) || !grid.isTunnel(nx, ny))
+                    continue;
+
+                int neighbour = ny * width + nx;
+                if (discovery[neighbour] == 0)
+                {
+                    parent[neighbour] = tile;
+                    discovery[neighbour] = low[neighbour] = ++order;
+                    stack.push_back(neighbour);
+                    if (tile == root)
+                        rootChildren++;
+                }
+                else if (neighbour != parent[tile])
+                {
+                    low[tile] = std::min(low[tile], discovery[neighbour]);
+                }
+                continue;
+            }
+
+            // All neighbours explored: report back to the parent
+            stack.pop_back();
+            int up = parent[tile];
+            if (up == -1)
+                continue;
+
+            low[up] = std::min(low[up], low[tile]);
+
+            if (low[tile] > discovery[up])
+            {
+                int first = std::min(up, tile);
+                int second = std::max(up, tile);
+                flags[first] |= (second == first + width) ? BRIDGE_DOWN : BRIDGE_RIGHT;
+            }
+
+            if (up != root && low[tile] >= discovery[up])
+                markChokepoint(up);
+        }
+
+        if (rootChildren >= 2)
+            markChokepoint(root);
+    }
+}
+
+bool ChokepointMap::inBounds(int x, int y) const
+{
+    return x >= 0 && x < width && y >= 0 && y < height;
+}
@@ -0,0 +1,91 @@
+#ifndef CHOKEPOINT_MAP_H
+#define CHOKEPOINT_MAP_H
+
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+
+/**
+ * @brief Articulation points and bridges of the tunnel network
+ *
+ * Tunnel tiles are the vertices and 4-neighbour adjacencies the edges. A
+ * chokepoint (articulation point) is a tile whose loss splits its tunnel
+ * network; a bridge is a single passage whose loss does the same. The whole
+ * analysis is one linear-time depth-first pass, redone only when the grid
+ * version changes, so every per-tile query is a flag lookup.
+ */
+class ChokepointMap
+{
+public:
+    /**
+     * @brief Constructor for ChokepointMap
+     */
+    ChokepointMap();
+
+    /**
+     * @brief Bring the analysis up to date with the grid
+     *
+     * Does nothing when the grid version has not changed since the last
+     * refresh.
+     * @param grid Reference to the game grid
+     */
+    void refresh(const Grid &grid);
+
+    /**
+     * @brief Check if a tile is a chokepoint of its tunnel network
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return true if removing the tile would disconnect the tunnels around it
+     */
+    bool isChokepoint(int x, int y) const;
+
+    /**
+     * @brief Check if the passage from a tile in a direction is a bridge
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @param direction Side of the tile the passage leaves through
+     * @return true if the passage is the only connection between its two sides
+     */
+    bool isBridge(int x, int y, Direction direction) const;
+
+    /**
+     * @brief Get the number of chokepoint tiles
+     * @return Chokepoint count as of the last refresh
+     */
+    int getChokepointCount() const;
+
+    /**
+     * @brief Get the grid version the analysis describes
+     * @return Version stamp as of the last refresh (0 before the first)
+     */
+    unsigned int getGridVersion() const;
+
+private:
+    static const unsigned char CHOKEPOINT = 1;   ///< Tile is an articulation point
+    static const unsigned char BRIDGE_RIGHT = 2; ///< Passage to the right neighbour is a bridge
+    static const unsigned char BRIDGE_DOWN = 4;  ///< Passage to the lower neighbour is a bridge
+
+    int width;                           ///< Grid width the flags were built for
+    int height;                          ///< Grid height the flags were built for
+    unsigned int gridVersion;            ///< Grid version the flags describe
+    int chokepointCount;                 ///< Number of tiles flagged CHOKEPOINT
+    std::vector<unsigned char> flags;    ///< Per tile: CHOKEPOINT / BRIDGE_* bits
+    std::vector<int> discovery;          ///< DFS discovery order, 0 if unvisited
+    std::vector<int> low;                ///< Lowest discovery order reachable via one back edge
+    std::vector<int> parent;             ///< DFS parent tile, or -1 for a root
+    std::vector<unsigned char> nextEdge; ///< Next neighbour to explore (0-4)
+    std::vector<int> stack;              ///< Explicit DFS stack of tile indices
+
+    /**
+     * @brief Recompute every flag from scratch
+     * @param grid Reference to the game grid
+     */
+    void rebuild(const Grid &grid);
+
+    /**
+     * @brief Check if grid coordinates are inside the analysed area
+     */
+    bool inBounds(int x, int y) const;
+};
+
+#endif // CHOKEPOINT_MAP_H
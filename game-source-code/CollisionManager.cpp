@@ -6,21 +6,7 @@
 
 bool CollisionManager::checkPlayerMonsterCollision(Player &player, MonsterManager &monsterManager)
 {
-    Rectangle playerBounds = player.getBounds();
-    auto &monsters = monsterManager.getMonsters();
-
-    for (const auto &monster : monsters)
-    {
-        if (monster && monster->isActive() && !monster->isDead())
-        {
-            Rectangle monsterBounds = monster->getBounds();
-            if (CheckCollisionRecs(playerBounds, monsterBounds))
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return monsterManager.findOverlapping(player.getBounds()) != -1;
 }
 
 void CollisionManager::checkHarpoonMonsterCollisions(Player &player, MonsterManager &monsterManager,
@@ -30,47 +16,24 @@ void CollisionManager::checkHarpoonMonsterCollisions(Player &player, MonsterMana
     if (!harpoon.isHarpoonActive())
         return;
 
-    Rectangle harpoonBounds = harpoon.getBounds();
-    auto &monsters = monsterManager.getMonsters();
-
-    for (auto &monster : monsters)
+    int hit = monsterManager.findOverlapping(harpoon.getBounds());
+    if (hit != -1)
     {
-        if (monster && monster->isActive() && !monster->isDead())
-        {
-            Rectangle monsterBounds = monster->getBounds();
-            if (CheckCollisionRecs(harpoonBounds, monsterBounds))
-            {
-                monster->setState(MonsterState::DEAD);
-                harpoon.deactivate();
-                return;
-            }
-        }
+        monsterManager.killMonster(hit);
+        harpoon.deactivate();
     }
 }
 
 bool CollisionManager::checkFirePlayerCollision(Player &player, MonsterManager &monsterManager)
 {
     Rectangle playerBounds = player.getBounds();
-    auto &monsters = monsterManager.getMonsters();
 
-    for (auto &monster : monsters)
+    for (Fire *fire : monsterManager.getActiveFires())
     {
-        if (monster && monster->isActive() && !monster->isDead())
+        if (CheckCollisionRecs(playerBounds, fire->getBounds()))
         {
-            GreenDragon *dragon = dynamic_cast<GreenDragon *>(monster.get());
-            if (dragon)
-            {
-                Fire &fire = dragon->getFire();
-                if (fire.isFireActive())
-                {
-                    Rectangle fireBounds = fire.getBounds();
-                    if (CheckCollisionRecs(playerBounds, fireBounds))
-                    {
-                        fire.deactivate();
-                        return true;
-                    }
-                }
-            }
+            fire->deactivate();
+            return true;
         }
     }
     return false;
@@ -97,25 +60,17 @@ bool CollisionManager::checkRockPlayerCollision(Player &player, const std::vecto
 void CollisionManager::checkRockMonsterCollisions(const std::vector<std::unique_ptr<Rock>> &rocks,
                                                   MonsterManager &monsterManager)
 {
-    auto &monsters = monsterManager.getMonsters();
-
     for (const auto &rock : rocks)
     {
         if (rock && rock->isActive() && rock->isFalling())
         {
             Rectangle rockBounds = rock->getBounds();
 
-            for (auto &monster : monsters)
+            // Rock continues falling after crushing monsters
+            for (int hit = monsterManager.findOverlapping(rockBounds); hit != -1;
+                 hit = monsterManager.findOverlapping(rockBounds, hit + 1))
             {
-                if (monster && monster->isActive() && !monster->isDead())
-                {
-                    Rectangle monsterBounds = monster->getBounds();
-                    if (CheckCollisionRecs(rockBounds, monsterBounds))
-                    {
-                        monster->setState(MonsterState::DEAD);
-                        // Rock continues falling after crushing monster
-                    }
-                }
+                monsterManager.killMonster(hit);
             }
         }
     }
@@ -14,6 +14,9 @@ class GreenDragon;
 
 /**
  * @brief Unified collision detection for all game objects
+ *
+ * Monster checks go through MonsterManager::findOverlapping(), whose tile-cell
+ * broadphase leaves only the monsters near the probe to CheckCollisionRecs.
  */
 class CollisionManager
 {
@@ -0,0 +1,302 @@
+#include "DStarLite.h"
+#include "PathFinding.h"
+#include "DecisionTrace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1};
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+    const Direction STEP_DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+}
+
+bool DStarLite::Key::operator<(const Key &other) const
+{
+    return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+}
+
+bool DStarLite::Key::operator==(const Key &other) const
+{
+    return primary == other.primary && secondary == other.secondary;
+}
+
+bool DStarLite::QueueEntry::operator>(const QueueEntry &other) const
+{
+    return other.key < key;
+}
+
+DStarLite::DStarLite()
+    : width(0), height(0), goalTile(-1), startTile(-1), lastStartTile(-1), keyModifier(0),
+      sourceGrid(nullptr), gridVersion(0), movementClass(MonsterState::IN_TUNNEL), initialized(false),
+      lastExpansions(0), lastIncremental(false)
+{
+}
+
+Direction DStarLite::nextStep(Vector2 startPos, Vector2 goalPos, const Grid &grid, MonsterState moveClass)
+{
+    Vector2 startGridPos = grid.worldToGrid(startPos);
+    Vector2 goalGridPos = grid.worldToGrid(goalPos);
+    int sx = static_cast<int>(startGridPos.x);
+    int sy = static_cast<int>(startGridPos.y);
+    int gx = static_cast<int>(goalGridPos.x);
+    int gy = static_cast<int>(goalGridPos.y);
+
+    if (!grid.isValidPosition(sx, sy) || !grid.isValidPosition(gx, gy))
+        return Direction::NONE;
+
+    int start = sy * grid.getWidth() + sx;
+    int goal = gy * grid.getWidth() + gx;
+    lastExpansions = 0;
+
+    // Version stamps are shared by all grids, so only the grid the tree was built on can patch it
+    bool sameProblem = initialized && moveClass == movementClass && sourceGrid == &grid &&
+                       width == grid.getWidth() && height == grid.getHeight();
+    changedTiles.clear();
+    if (sameProblem && grid.getVersion() != gridVersion &&
+        !grid.getChangesSince(gridVersion, changedTiles))
+    {
+        sameProblem = false;
+    }
+
+    if (!sameProblem)
+    {
+        movementClass = moveClass;
+        initialize(start, goal, grid);
+        lastIncremental = false;
+    }
+    else
+    {
+        // The monster moved: shift the key bias instead of re-sorting the open list
+        startTile = start;
+        keyModifier += heuristic(lastStartTile, startTile);
+        lastStartTile = startTile;
+        if (goal != goalTile)
+            moveGoal(goal);
+        applyChanges(grid);
+        lastIncremental = true;
+    }
+
+    computeShortestPath();
+
+    if (start == goal || costToGoal[start] >= INFINITE_COST)
+        return Direction::NONE;
+
+    // Step to the neighbour that lies on a shortest route
+    Direction best = Direction::NONE;
+    int bestCost = INFINITE_COST;
+    DecisionScores::begin(DecisionRecord::SCORED_BY_REPLANNER);
+    for (int d = 0; d < 4; d++)
+    {
+        int nx = sx + STEP_X[d];
+        int ny = sy + STEP_Y[d];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+            continue;
+
+        int neighbour = ny * width + nx;
+        if (passable[neighbour])
+            DecisionScores::note(STEP_DIRECTIONS[d], costToGoal[neighbour] >= INFINITE_COST ? DecisionRecord::UNREACHABLE
+                                                                                            : costToGoal[neighbour]);
+        if (passable[neighbour] && costToGoal[neighbour] < bestCost)
+        {
+            bestCost = costToGoal[neighbour];
+            best = STEP_DIRECTIONS[d];
+        }
+    }
+
+    return best;
+}
+
+void DStarLite::reset()
+{
+    initialized = false;
+}
+
+int DStarLite::getLastExpansions() const
+{
+    return lastExpansions;
+}
+
+bool DStarLite::wasLastQueryIncremental() const
+{
+    return lastIncremental;
+}
+
+void DStarLite::initialize(int start, int goal, const Grid &grid)
+{
+    width = grid.getWidth();
+    height = grid.getHeight();
+    goalTile = goal;
+    startTile = start;
+    lastStartTile = start;
+    keyModifier = 0;
+    sourceGrid = &grid;
+    gridVersion = grid.getVersion();
+
+    int tileCount = width * height;
+    costToGoal.assign(tileCount, INFINITE_COST);
+    lookahead.assign(tileCount, INFINITE_COST);
+    queued.assign(tileCount, 0);
+    queuedKey.assign(tileCount, Key{0, 0});
+    passable.assign(tileCount, 0);
+    openList = decltype(openList)();
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            passable[y * width + x] = PathFinding::canEnterTile(x, y, grid, movementClass);
+        }
+    }
+
+    lookahead[goalTile] = 0;
+    push(goalTile);
+    initialized = true;
+}
+
+void DStarLite::applyChanges(const Grid &grid)
+{
+    for (const auto &tile : changedTiles)
+    {
+        int x = tile.first;
+        int y = tile.second;
+        int index = y * width + x;
+        unsigned char nowPassable = PathFinding::canEnterTile(x, y, grid, movementClass);
+        if (passable[index] == nowPassable)
+            continue;
+
+        // Edge costs into and out of this tile changed
+        passable[index] = nowPassable;
+        updateVertex(index);
+        for (int d = 0; d < 4; d++)
+        {
+            int nx = x + STEP_X[d];
+            int ny = y + STEP_Y[d];
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height)
+                updateVertex(ny * width + nx);
+        }
+    }
+
+    gridVersion = grid.getVersion();
+}
+
+void DStarLite::moveGoal(int goal)
+{
+    // The goal is the one tile with a free way out; moving it changes two tiles' costs
+    int oldGoal = goalTile;
+    goalTile = goal;
+    updateVertex(oldGoal);
+    lookahead[goalTile] = 0;
+    updateVertex(goalTile);
+}
+
+void DStarLite::updateVertex(int tile)
+{
+    if (tile != goalTile)
+        lookahead[tile] = bestNeighbourCost(tile);
+
+    queued[tile] = 0;
+    if (costToGoal[tile] != lookahead[tile])
+        push(tile);
+}
+
+void DStarLite::computeShortestPath()
+{
+    Key topKey;
+    while (peekTopKey(topKey) &&
+           (topKey < calculateKey(startTile) || lookahead[startTile] != costToGoal[startTile]))
+    {
+        int tile = openList.top().tile;
+        openList.pop();
+        queued[tile] = 0;
+        lastExpansions++;
+
+        Key newKey = calculateKey(tile);
+        if (topKey < newKey)
+        {
+            push(tile);
+            continue;
+        }
+
+        int x = tile % width;
+        int y = tile / width;
+
+        if (costToGoal[tile] > lookahead[tile])
+        {
+            costToGoal[tile] = lookahead[tile];
+        }
+        else
+        {
+            costToGoal[tile] = INFINITE_COST;
+            updateVertex(tile);
+        }
+
+        for (int d = 0; d < 4; d++)
+        {
+            int nx = x + STEP_X[d];
+            int ny = y + STEP_Y[d];
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height)
+                updateVertex(ny * width + nx);
+        }
+    }
+}
+
+DStarLite::Key DStarLite::calculateKey(int tile) const
+{
+    int best = std::min(costToGoal[tile], lookahead[tile]);
+    if (best >= INFINITE_COST)
+        return Key{INFINITE_COST, INFINITE_COST};
+    return Key{best + heuristic(startTile, tile) + keyModifier, best};
+}
+
+int DStarLite::heuristic(int from, int to) const
+{
+    return std::abs(from % width - to % width) + std::abs(from / width - to / width);
+}
+
+int DStarLite::bestNeighbourCost(int tile) const
+{
+    // Unit-cost moves between passable tiles; a blocked tile has no way out
+    if (!passable[tile])
+        return INFINITE_COST;
+
+    int x = tile % width;
+    int y = tile / width;
+    int best = INFINITE_COST;
+    for (int d = 0; d < 4; d++)
+    {
+        int nx = x + STEP_X[d];
+        int ny = y + STEP_Y[d];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+            continue;
+
+        int neighbour = ny * width + nx;
+        if (passable[neighbour] && costToGoal[neighbour] < INFINITE_COST)
+            best = std::min(best, costToGoal[neighbour] + 1);
+    }
+    return best;
+}
+
+void DStarLite::push(int tile)
+{
+    Key key = calculateKey(tile);
+    queuedKey[tile] = key;
+    queued[tile] = 1;
+    openList.push({key, tile});
+}
+
+bool DStarLite::peekTopKey(Key &key)
+{
+    // Discard entries superseded by a later push or removal
+    while (!openList.empty())
+    {
+        const QueueEntry &top = openList.top();
+        if (queued[top.tile] && queuedKey[top.tile] == top.key)
+        {
+            key = top.key;
+            return true;
+        }
+        openList.pop();
+    }
+    return false;
+}
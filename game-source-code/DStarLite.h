@@ -0,0 +1,118 @@
+#ifndef DSTAR_LITE_H
+#define DSTAR_LITE_H
+
+#include <raylib-cpp.hpp>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+
+/**
+ * @brief Incremental shortest-route planner (D* Lite) for one pursuing monster
+ *
+ * Distances are kept from the goal tile back toward the monster. When the
+ * player digs, only the tiles changed since the last query are re-examined,
+ * so repairing the route costs roughly the size of the change rather than
+ * the size of the map. Moving the monster costs nothing extra. A goal that
+ * moves is handled like an edge change: the old goal tile loses its zero
+ * distance, the new one gains it, and the repair spreads from there. Only
+ * switching movement class or grid, or losing the grid's change history,
+ * re-roots the search.
+ */
+class DStarLite
+{
+public:
+    /**
+     * @brief Constructor for DStarLite (no memory is used until the first query)
+     */
+    DStarLite();
+
+    /**
+     * @brief Get the first step of a shortest route, repairing the plan as needed
+     * @param startPos Monster world position
+     * @param goalPos Goal world position
+     * @param grid Reference to the game grid
+     * @param movementClass Movement rules of the monster
+     * @return Direction of the first step, or NONE if unreachable or already there
+     */
+    Direction nextStep(Vector2 startPos, Vector2 goalPos, const Grid &grid, MonsterState movementClass);
+
+    /**
+     * @brief Forget the current plan
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of tiles expanded by the last query
+     * @return Expansion count
+     */
+    int getLastExpansions() const;
+
+    /**
+     * @brief Check if the last query reused the previous plan
+     * @return true if the last query repaired rather than rebuilt the plan
+     */
+    bool wasLastQueryIncremental() const;
+
+private:
+    /**
+     * @brief Priority of a tile in the open list
+     */
+    struct Key
+    {
+        int primary;
+        int secondary;
+
+        bool operator<(const Key &other) const;
+        bool operator==(const Key &other) const;
+    };
+
+    /**
+     * @brief Open list entry; stale entries are skipped when popped
+     */
+    struct QueueEntry
+    {
+        Key key;
+        int tile;
+
+        bool operator>(const QueueEntry &other) const;
+    };
+
+    static constexpr int INFINITE_COST = 1 << 28;
+
+    int width;
+    int height;
+    int goalTile;
+    int startTile;
+    int lastStartTile;
+    int keyModifier;
+    const Grid *sourceGrid;             // Grid the search tree was built on
+    unsigned int gridVersion;
+    MonsterState movementClass;
+    bool initialized;
+    int lastExpansions;
+    bool lastIncremental;
+
+    std::vector<int> costToGoal;        // g values
+    std::vector<int> lookahead;         // rhs values
+    std::vector<unsigned char> passable; // Snapshot of which tiles can be entered
+    std::vector<Key> queuedKey;         // Key of the live open-list entry per tile
+    std::vector<unsigned char> queued;  // Whether the tile has a live open-list entry
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openList;
+    std::vector<std::pair<int, int>> changedTiles; // Scratch buffer for grid changes
+
+    void initialize(int start, int goal, const Grid &grid);
+    void applyChanges(const Grid &grid);
+    // Hand the zero distance from the current goal tile to another
+    void moveGoal(int goal);
+    void updateVertex(int tile);
+    void computeShortestPath();
+    Key calculateKey(int tile) const;
+    int heuristic(int from, int to) const;
+    int bestNeighbourCost(int tile) const;
+    void push(int tile);
+    bool peekTopKey(Key &key);
+};
+
+#endif // DSTAR_LITE_H
@@ -0,0 +1,119 @@
+#include "DecisionPipeline.h"
+#include <algorithm>
+
+DecisionPipeline::DecisionPipeline(int threads)
+    : threadCount(1), batch(0), stopping(false), busyWorkers(0), current(nullptr), itemCount(0), nextItem(0)
+{
+    setThreadCount(threads);
+}
+
+DecisionPipeline::~DecisionPipeline()
+{
+    stopWorkers();
+}
+
+void DecisionPipeline::setThreadCount(int threads)
+{
+    if (threads <= 0)
+    {
+        // Decisions are short, so a few cores is where the gains stop
+        threads = std::min(4, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    threads = std::clamp(threads, 1, MAX_THREADS);
+    if (threads == threadCount && static_cast<int>(workers.size()) == threadCount - 1)
+        return;
+
+    stopWorkers();
+    threadCount = threads;
+    startWorkers();
+}
+
+int DecisionPipeline::getThreadCount() const
+{
+    return threadCount;
+}
+
+void DecisionPipeline::run(int count, const std::function<void(int)> &work)
+{
+    if (count <= 0)
+        return;
+
+    if (workers.empty() || count < MIN_PARALLEL_BATCH)
+    {
+        for (int i = 0; i < count; i++)
+            work(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &work;
+        itemCount = count;
+        nextItem.store(0);
+        busyWorkers = static_cast<int>(workers.size());
+        batch++;
+    }
+    batchReady.notify_all();
+
+    drain();
+
+    // The batch's work object lives on the caller's stack, so wait for every worker to let go of it
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this]
+                   { return busyWorkers == 0; });
+    current = nullptr;
+}
+
+void DecisionPipeline::startWorkers()
+{
+    stopping = false;
+    // Workers start out having seen the current batch, however late their thread gets going
+    for (int i = 1; i < threadCount; i++)
+        workers.emplace_back(&DecisionPipeline::workerLoop, this, batch);
+}
+
+void DecisionPipeline::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batchReady.notify_all();
+
+    for (std::thread &worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+}
+
+void DecisionPipeline::workerLoop(unsigned int seen)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchReady.wait(lock, [this, seen]
+                            { return stopping || batch != seen; });
+            if (stopping)
+                return;
+            seen = batch;
+        }
+
+        drain();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        batchDone.notify_one();
+    }
+}
+
+void DecisionPipeline::drain()
+{
+    const std::function<void(int)> &work = *current;
+    for (int i = nextItem.fetch_add(1); i < itemCount; i = nextItem.fetch_add(1))
+        work(i);
+}
@@ -0,0 +1,74 @@
+#ifndef DECISION_PIPELINE_H
+#define DECISION_PIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs a batch of independent monster decisions across worker threads
+ *
+ * The workers are started once and sleep between batches. The calling
+ * thread works on the batch too and returns once every item is done. Items
+ * are handed out one at a time from a shared counter, so which thread runs
+ * which item varies from run to run; callers must keep items independent
+ * (each writes only its own output) for the results not to depend on it.
+ */
+class DecisionPipeline
+{
+public:
+    static const int MAX_THREADS = 8;        ///< Most threads a batch is spread across
+    static const int MIN_PARALLEL_BATCH = 8; ///< Smaller batches run on the calling thread alone
+
+    /**
+     * @brief Constructor for DecisionPipeline
+     * @param threads Threads per batch, the calling thread included (0 picks one per core)
+     */
+    DecisionPipeline(int threads = 0);
+
+    /**
+     * @brief Destructor, stops the workers
+     */
+    ~DecisionPipeline();
+
+    DecisionPipeline(const DecisionPipeline &) = delete;
+    DecisionPipeline &operator=(const DecisionPipeline &) = delete;
+
+    /**
+     * @brief Change the number of threads, restarting the workers
+     * @param threads Threads per batch, the calling thread included (0 picks one per core)
+     */
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+
+    /**
+     * @brief Run work(0) to work(count - 1), spread across the threads
+     * @param count Number of items
+     * @param work Called once per item, possibly from several threads at once
+     */
+    void run(int count, const std::function<void(int)> &work);
+
+private:
+    int threadCount;                         ///< Threads per batch, the caller included
+    std::vector<std::thread> workers;        ///< threadCount - 1 helpers
+    std::mutex mutex;                        ///< Guards everything below
+    std::condition_variable batchReady;      ///< Wakes the workers for a new batch
+    std::condition_variable batchDone;       ///< Wakes the caller when the workers are done
+    unsigned int batch;                      ///< Batch number, bumped for every batch
+    bool stopping;                           ///< Workers should exit
+    int busyWorkers;                         ///< Workers still on the current batch
+    const std::function<void(int)> *current; ///< Work of the current batch
+    int itemCount;                           ///< Items in the current batch
+    std::atomic<int> nextItem;               ///< Next item to hand out
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(unsigned int seen);
+    // Take and run items until the batch is used up
+    void drain();
+};
+
+#endif // DECISION_PIPELINE_H
@@ -0,0 +1,48 @@
+#include "DecisionTrace.h"
+#include <algorithm>
+
+DecisionTrace::DecisionTrace()
+    : records{}, written(0)
+{
+}
+
+void DecisionTrace::clear()
+{
+    written = 0;
+}
+
+DecisionRecord *DecisionTrace::getLatest()
+{
+    if (written == 0)
+        return nullptr;
+
+    return &records[(written - 1) & (CAPACITY - 1)];
+}
+
+int DecisionTrace::getCount() const
+{
+    return static_cast<int>(std::min<std::uint32_t>(written, CAPACITY));
+}
+
+const DecisionRecord &DecisionTrace::getRecord(int index) const
+{
+    std::uint32_t oldest = written - static_cast<std::uint32_t>(getCount());
+    return records[(oldest + static_cast<std::uint32_t>(index)) & (CAPACITY - 1)];
+}
+
+std::uint32_t DecisionTrace::getTotalRecorded() const
+{
+    return written;
+}
+
+void DecisionTrace::write(std::ostream &out) const
+{
+    std::uint32_t count = static_cast<std::uint32_t>(getCount());
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+
+    // At most two runs: from the oldest to the end of the array, then from its start
+    std::uint32_t oldest = (written - count) & (CAPACITY - 1);
+    std::uint32_t firstRun = std::min<std::uint32_t>(count, CAPACITY - oldest);
+    out.write(reinterpret_cast<const char *>(&records[oldest]), firstRun * sizeof(DecisionRecord));
+    out.write(reinterpret_cast<const char *>(&records[0]), (count - firstRun) * sizeof(DecisionRecord));
+}
@@ -0,0 +1,195 @@
+#ifndef DECISION_TRACE_H
+#define DECISION_TRACE_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include "GameEnums.h"
+
+// Build with -DMONSTER_DECISION_TRACE=1 to have every monster record its thinks.
+// Off, monsters hold no trace and record nothing: the hooks are compiled out.
+#ifndef MONSTER_DECISION_TRACE
+#define MONSTER_DECISION_TRACE 0
+#endif
+
+/**
+ * @brief One think of one monster, as stored in a DecisionTrace (16 bytes)
+ */
+struct DecisionRecord
+{
+    static constexpr std::int16_t NOT_A_CANDIDATE = INT16_MIN; ///< Score of a direction the monster cannot take
+    static constexpr std::int16_t UNREACHABLE = INT16_MAX;     ///< Score of a step with no way on to the target
+
+    static constexpr std::uint8_t BREATHES_FIRE = 1 << 0;  ///< Green dragon breathed fire
+    static constexpr std::uint8_t SEARCHES_AHEAD = 1 << 1; ///< Green dragon handed the move to the lookahead search
+    static constexpr std::uint8_t CHANGES_STATE = 1 << 2;  ///< Went disembodied or resurfaced
+    static constexpr std::uint8_t AWAITS_ROUTE = 1 << 3;   ///< Holding for an asynchronous route
+    static constexpr std::uint8_t RAN_SCRIPT = 1 << 4;     ///< A behavior script decided, not the tree
+
+    static constexpr std::uint8_t SCORED_BY_NONE = 0;        ///< Nothing scored: a random step or a wait
+    static constexpr std::uint8_t SCORED_BY_ROUTE_TABLE = 1; ///< Tunnel steps on to the target; the first one closer wins
+    static constexpr std::uint8_t SCORED_BY_GREEDY = 2;      ///< Greedy closing score x100; highest wins
+    static constexpr std::uint8_t SCORED_BY_CACHE = 3;       ///< Greedy answer reused from the direction cache, so nothing scored
+    static constexpr std::uint8_t SCORED_BY_REPLANNER = 4;   ///< D* Lite route cost on to the target; lowest wins
+    static constexpr std::uint8_t SCORED_BY_LOOKAHEAD = 5;   ///< Rollouts that began with the step; most wins
+
+    std::uint32_t tick;        ///< Clock tick of the think (TimerWheel ticks)
+    std::uint8_t state;        ///< MonsterState after the think
+    std::uint8_t chosen;       ///< Direction of the step taken (NONE for none)
+    std::uint8_t flags;        ///< What else the think did
+    std::uint8_t scorer;       ///< SCORED_BY_ value: the last scorer the think ran
+    std::int16_t scores[4];    ///< Per candidate UP, DOWN, LEFT, RIGHT: what that scorer gave it
+};
+
+static_assert(sizeof(DecisionRecord) == 16, "decision records are dumped as raw 16-byte blocks");
+
+/**
+ * @brief Where the direction scorers leave their scores for the think in progress
+ *
+ * A monster opens a Scope on its record for the length of a think; the
+ * scorers it runs (route table, greedy, replanner, lookahead) write the
+ * values they compute anyway, as they compute them. The record is per
+ * thread, so thinks decided in parallel do not mix. Outside a think, and
+ * with tracing compiled out, every call is a no-op.
+ */
+class DecisionScores
+{
+public:
+    /**
+     * @brief Points this thread's scorers at a record for as long as it lives
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(DecisionRecord *record)
+        {
+#if MONSTER_DECISION_TRACE
+            previous = current;
+            current = record;
+#else
+            (void)record;
+#endif
+        }
+
+        ~Scope()
+        {
+#if MONSTER_DECISION_TRACE
+            current = previous;
+#endif
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+#if MONSTER_DECISION_TRACE
+        DecisionRecord *previous;
+#endif
+    };
+
+    /**
+     * @brief A scorer starts; its scores replace those of any earlier one
+     * @param scorer SCORED_BY_ value
+     */
+    static void begin(std::uint8_t scorer)
+    {
+#if MONSTER_DECISION_TRACE
+        if (!current)
+            return;
+        current->scorer = scorer;
+        for (std::int16_t &score : current->scores)
+            score = DecisionRecord::NOT_A_CANDIDATE;
+#else
+        (void)scorer;
+#endif
+    }
+
+    /**
+     * @brief Give a candidate its score
+     * @param direction Candidate step
+     * @param score Its value, clamped to fit; UNREACHABLE and NOT_A_CANDIDATE pass through
+     */
+    static void note(Direction direction, int score)
+    {
+#if MONSTER_DECISION_TRACE
+        if (!current || direction == Direction::NONE)
+            return;
+        if (score != DecisionRecord::UNREACHABLE && score != DecisionRecord::NOT_A_CANDIDATE)
+            score = score < INT16_MIN + 1 ? INT16_MIN + 1 : (score > INT16_MAX - 1 ? INT16_MAX - 1 : score);
+        current->scores[static_cast<int>(direction)] = static_cast<std::int16_t>(score);
+#else
+        (void)direction;
+        (void)score;
+#endif
+    }
+
+private:
+#if MONSTER_DECISION_TRACE
+    static inline thread_local DecisionRecord *current = nullptr; ///< Record of this thread's think, or nullptr
+#endif
+};
+
+/**
+ * @brief Fixed-size ring of a monster's most recent decisions
+ *
+ * Recording is a copy into the next slot and never allocates; once full, the
+ * oldest record is overwritten. Traces are dumped as raw records, see
+ * MonsterManager::dumpDecisionTraces() for the file layout.
+ */
+class DecisionTrace
+{
+public:
+    static const int CAPACITY = 64; ///< Records kept; a power of two
+
+    /**
+     * @brief Constructor for DecisionTrace
+     */
+    DecisionTrace();
+
+    void record(const DecisionRecord &decision)
+    {
+        records[written & (CAPACITY - 1)] = decision;
+        written++;
+    }
+
+    void clear();
+
+    /**
+     * @brief Get the record written last, for a decision carried out after it was recorded
+     * @return The record, or nullptr if none is held
+     */
+    DecisionRecord *getLatest();
+
+    /**
+     * @brief Get the number of records held
+     * @return Records, at most CAPACITY
+     */
+    int getCount() const;
+
+    /**
+     * @brief Get a record
+     * @param index 0 for the oldest held, getCount() - 1 for the latest
+     * @return The record
+     */
+    const DecisionRecord &getRecord(int index) const;
+
+    /**
+     * @brief Get the number of decisions recorded since the last clear
+     * @return Decisions, including those overwritten
+     */
+    std::uint32_t getTotalRecorded() const;
+
+    /**
+     * @brief Write the held records, oldest first, preceded by their count (uint32)
+     * @param out Binary stream
+     */
+    void write(std::ostream &out) const;
+
+private:
+    std::array<DecisionRecord, CAPACITY> records; ///< Ring storage
+    std::uint32_t written;                        ///< Records ever written; the next slot is written % CAPACITY
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the ring is indexed by masking");
+};
+
+#endif // DECISION_TRACE_H
@@ -0,0 +1,174 @@
+#include "DisembodimentScheduler.h"
+#include <algorithm>
+
+DisembodimentScheduler::DisembodimentScheduler()
+    : slots(DEFAULT_SLOTS), cooldownTime(DEFAULT_COOLDOWN), cooldown(0.0f)
+{
+}
+
+void DisembodimentScheduler::setSlots(int count)
+{
+    // Fewer slots than leases held just means nobody new goes until enough return
+    slots = std::max(count, 1);
+}
+
+int DisembodimentScheduler::getSlots() const
+{
+    return slots;
+}
+
+void DisembodimentScheduler::setCooldown(float seconds)
+{
+    cooldownTime = std::max(seconds, 0.0f);
+}
+
+float DisembodimentScheduler::getCooldown() const
+{
+    return cooldownTime;
+}
+
+void DisembodimentScheduler::clear()
+{
+    cooldown = 0.0f;
+    holders.clear();
+    reserved.clear();
+    queue.clear();
+    queued.clear();
+}
+
+void DisembodimentScheduler::advance(float seconds, const MonsterStore &monsters)
+{
+    // Reservations only count down once nothing else holds the queued monster back
+    bool reservationsTicking = cooldown <= 0.0f;
+    if (cooldown > 0.0f)
+    {
+        cooldown -= seconds;
+        if (cooldown < 0.0f)
+            cooldown = 0.0f;
+    }
+
+    holders.erase(std::remove_if(holders.begin(), holders.end(),
+                                 [&monsters](int index)
+                                 {
+                                     return index >= monsters.size() || !monsters.isAlive(index) ||
+                                            monsters.getState(index) != MonsterState::DISEMBODIED;
+                                 }),
+                  holders.end());
+
+    // A reservation lapses if its monster leaves the tunnels or lets the slot go unused
+    reserved.erase(std::remove_if(reserved.begin(), reserved.end(),
+                                  [&monsters, seconds, reservationsTicking](Reservation &reservation)
+                                  {
+                                      int index = reservation.index;
+                                      if (index >= monsters.size() || !monsters.isAlive(index) ||
+                                          monsters.getState(index) != MonsterState::IN_TUNNEL)
+                                          return true;
+                                      if (reservationsTicking)
+                                          reservation.timeLeft -= seconds;
+                                      return reservation.timeLeft <= 0.0f;
+                                  }),
+                   reserved.end());
+
+    grantQueued();
+}
+
+bool DisembodimentScheduler::askForSlot(int index)
+{
+    if (isReservedFor(index) || freeSlots() > 0)
+        return cooldown <= 0.0f;
+
+    if (index >= 0 && !isHolding(index))
+    {
+        if (index >= static_cast<int>(queued.size()))
+            queued.resize(index + 1, 0);
+        if (!queued[index])
+        {
+            queued[index] = 1;
+            queue.push_back(index);
+        }
+    }
+    return false;
+}
+
+bool DisembodimentScheduler::wouldGrant(int index) const
+{
+    return cooldown <= 0.0f && (isReservedFor(index) || freeSlots() > 0);
+}
+
+bool DisembodimentScheduler::acquire(int index)
+{
+    if (isHolding(index))
+        return true;
+    if (cooldown > 0.0f)
+        return false;
+
+    if (isReservedFor(index))
+        removeReservation(index);
+    else if (freeSlots() <= 0)
+        return false;
+
+    holders.push_back(index);
+    cooldown = cooldownTime;
+    return true;
+}
+
+void DisembodimentScheduler::release(int index)
+{
+    auto holder = std::find(holders.begin(), holders.end(), index);
+    if (holder == holders.end())
+        return;
+
+    holders.erase(holder);
+    grantQueued();
+}
+
+bool DisembodimentScheduler::isHolding(int index) const
+{
+    return std::find(holders.begin(), holders.end(), index) != holders.end();
+}
+
+bool DisembodimentScheduler::isReservedFor(int index) const
+{
+    for (const Reservation &reservation : reserved)
+    {
+        if (reservation.index == index)
+            return true;
+    }
+    return false;
+}
+
+int DisembodimentScheduler::getActiveCount() const
+{
+    return static_cast<int>(holders.size());
+}
+
+int DisembodimentScheduler::getQueuedCount() const
+{
+    return static_cast<int>(queue.size());
+}
+
+int DisembodimentScheduler::freeSlots() const
+{
+    return slots - static_cast<int>(holders.size()) - static_cast<int>(reserved.size());
+}
+
+void DisembodimentScheduler::grantQueued()
+{
+    while (freeSlots() > 0 && !queue.empty())
+    {
+        int index = queue.front();
+        queue.pop_front();
+        queued[index] = 0;
+
+        if (!isHolding(index) && !isReservedFor(index))
+            reserved.push_back(Reservation{index, RESERVATION_TIME});
+    }
+}
+
+void DisembodimentScheduler::removeReservation(int index)
+{
+    reserved.erase(std::remove_if(reserved.begin(), reserved.end(),
+                                  [index](const Reservation &reservation)
+                                  { return reservation.index == index; }),
+                   reserved.end());
+}
@@ -0,0 +1,129 @@
+#ifndef DISEMBODIMENT_SCHEDULER_H
+#define DISEMBODIMENT_SCHEDULER_H
+
+#include <deque>
+#include <vector>
+#include "MonsterStore.h"
+
+/**
+ * @brief Hands out the right to go disembodied as a fixed number of leases
+ *
+ * A monster going disembodied takes one of the slots and holds it until it
+ * resurfaces or dies. While every slot is taken, monsters that ask are
+ * queued; when a slot comes free it is reserved for the first of them
+ * still in the tunnels, who has a short while to take it before it passes
+ * down the queue. A cooldown after every lease keeps ghosts from appearing
+ * in bursts.
+ *
+ * Every query is O(slots), independent of the number of monsters. Monsters
+ * are identified by their store index.
+ */
+class DisembodimentScheduler
+{
+public:
+    static constexpr int DEFAULT_SLOTS = 1;         ///< Ghosts allowed at once
+    static constexpr float DEFAULT_COOLDOWN = 3.0f; ///< Seconds after one monster goes before the next may
+    static constexpr float RESERVATION_TIME = 1.0f; ///< Seconds a queued monster has to take a reserved slot
+
+    /**
+     * @brief Constructor for DisembodimentScheduler
+     */
+    DisembodimentScheduler();
+
+    /**
+     * @brief Set how many monsters may be disembodied at once
+     * @param count Slot count (at least one)
+     */
+    void setSlots(int count);
+    int getSlots() const;
+
+    /**
+     * @brief Set the pause between one monster going disembodied and the next
+     * @param seconds Cooldown duration
+     */
+    void setCooldown(float seconds);
+    float getCooldown() const;
+
+    /**
+     * @brief Drop every lease, reservation and queued monster
+     */
+    void clear();
+
+    /**
+     * @brief Run the cooldown and reservation timers, once per tick
+     *
+     * Leases of monsters that are no longer disembodied (killed, or turned
+     * back some other way) and reservations of monsters that left the
+     * tunnels are given up.
+     * @param seconds Time since the last call
+     * @param monsters Packed monster fields
+     */
+    void advance(float seconds, const MonsterStore &monsters);
+
+    /**
+     * @brief Ask whether a monster may go disembodied now
+     *
+     * A monster turned away because every slot is taken joins the queue.
+     * @param index Store index of the monster
+     * @return true if acquire() would succeed
+     */
+    bool askForSlot(int index);
+
+    /**
+     * @brief Answer askForSlot() without joining the queue
+     * @param index Store index of the monster
+     * @return true if acquire() would succeed
+     */
+    bool wouldGrant(int index) const;
+
+    /**
+     * @brief Take a slot
+     * @param index Store index of the monster
+     * @return true if the monster now holds a lease
+     */
+    bool acquire(int index);
+
+    /**
+     * @brief Give a slot back and reserve it for the next queued monster
+     * @param index Store index of the monster
+     */
+    void release(int index);
+
+    bool isHolding(int index) const;
+    bool isReservedFor(int index) const;
+
+    /**
+     * @brief Get the number of leases held
+     * @return Monsters holding a slot
+     */
+    int getActiveCount() const;
+
+    /**
+     * @brief Get the number of monsters waiting for a slot
+     * @return Queue length
+     */
+    int getQueuedCount() const;
+
+private:
+    struct Reservation
+    {
+        int index;      ///< Monster the slot is kept for
+        float timeLeft; ///< Seconds of cooldown-free time it has left to take it
+    };
+
+    int slots;                         ///< Ghosts allowed at once
+    float cooldownTime;                ///< Pause after each lease
+    float cooldown;                    ///< Seconds until the next lease may be taken
+    std::vector<int> holders;          ///< Store indices holding a lease
+    std::vector<Reservation> reserved; ///< Slots kept for queued monsters
+    std::deque<int> queue;             ///< Monsters waiting for a slot, first come first served
+    std::vector<unsigned char> queued; ///< Per store index: whether it is in the queue
+
+    // Slots neither held nor reserved
+    int freeSlots() const;
+    // Reserve free slots for the monsters at the head of the queue
+    void grantQueued();
+    void removeReservation(int index);
+};
+
+#endif // DISEMBODIMENT_SCHEDULER_H
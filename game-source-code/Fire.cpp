@@ -180,6 +180,11 @@ float Fire::getBurnTime() const
     return burnTime;
 }
 
+float Fire::getRemainingRange() const
+{
+    return maxRange > travelDistance ? maxRange - travelDistance : 0.0f;
+}
+
 void Fire::updateMovement()
 {
     Vector2 oldPosition = position;
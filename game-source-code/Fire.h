@@ -83,6 +83,12 @@ public:
      */
     float getBurnTime() const;
 
+    /**
+     * @brief Get how much further the fire can travel
+     * @return Remaining distance in pixels
+     */
+    float getRemainingRange() const;
+
 private:
     Direction direction;  // Direction the fire is traveling
     float speed;          // Movement speed
@@ -45,6 +45,16 @@ enum class MonsterState
     DEAD
 };
 
+/**
+ * @brief Enumeration for monster types
+ */
+enum class MonsterKind
+{
+    BASIC,
+    RED,
+    GREEN_DRAGON
+};
+
 /**
  * @brief Enumeration for menu states
  */
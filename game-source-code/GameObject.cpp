@@ -38,13 +38,29 @@ Vector2 GameObject::getSize() const
     return size;
 }
 
+Vector2 GameObject::getTargetPosition() const
+{
+    return targetPosition;
+}
+
 // Movable interface implementation
 bool GameObject::move(Direction direction, Grid &grid)
 {
     if (direction == Direction::NONE || isMoving)
         return false;
 
-    Vector2 newPos = position;
+    Vector2 newPos;
+    if (!stepPosition(direction, grid, newPos) || !canMoveTo(newPos, grid))
+        return false;
+
+    targetPosition = newPos;
+    isMoving = true;
+    return true;
+}
+
+bool GameObject::stepPosition(Direction direction, const Grid &grid, Vector2 &newPos) const
+{
+    newPos = position;
     float moveDistance = static_cast<float>(grid.getTileSize());
 
     switch (direction)
@@ -64,12 +80,6 @@ bool GameObject::move(Direction direction, Grid &grid)
     default:
         return false;
     }
-
-    if (!canMoveTo(newPos, grid))
-        return false;
-
-    targetPosition = newPos;
-    isMoving = true;
     return true;
 }
 
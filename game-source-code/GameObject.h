@@ -69,6 +69,12 @@ public:
      */
     Vector2 getSize() const;
 
+    /**
+     * @brief Get the position the object is moving to
+     * @return Target position (the current position when idle)
+     */
+    Vector2 getTargetPosition() const;
+
     // Movable interface implementation
     bool move(Direction direction, Grid &grid) override;
     bool canMoveTo(Vector2 newPos, const Grid &grid) const override;
@@ -87,6 +93,8 @@ protected:
     void updateMovement() override;
     bool isWithinBounds(int screenWidth, int screenHeight) const;
     bool isWithinGridBounds(Vector2 worldPos, const Grid &grid) const;
+    // Position one tile away in a direction; false for NONE
+    bool stepPosition(Direction direction, const Grid &grid, Vector2 &newPos) const;
 };
 
 #endif // GAME_OBJECT_H
\ No newline at end of file
@@ -1,9 +1,7 @@
 #include "GamePlay.h"
 
-const float GamePlay::DISEMBODIED_COOLDOWN_TIME = 3.0f; // 3 seconds between disembodied transitions
-
 GamePlay::GamePlay()
-    : gameOver(false), levelComplete(false), playerWon(false), disembodiedCooldown(0.0f)
+    : gameOver(false), levelComplete(false), playerWon(false)
 {
 }
 
@@ -26,11 +24,18 @@ void GamePlay::init()
     // Initialize monsters
     monsterManager.initialize(currentLevel, currentLevel.getPlayerStartPosition());
 
+    // Coarse simulation is for levels a tile or more larger than the window; the
+    // standard level fits, so for now this never turns it on
+    const Grid &grid = currentLevel.getGrid();
+    int tileSize = grid.getTileSize();
+    int hiddenWidth = grid.getWidth() * tileSize - GetScreenWidth();
+    int hiddenHeight = grid.getHeight() * tileSize - GetScreenHeight();
+    monsterManager.setCoarseSimulation(IsWindowReady() && (hiddenWidth >= tileSize || hiddenHeight >= tileSize));
+
     // Reset game state
     gameOver = false;
     levelComplete = false;
     playerWon = false;
-    disembodiedCooldown = 0.0f;
 }
 
 void GamePlay::handleInput()
@@ -51,23 +56,11 @@ void GamePlay::update()
 {
     if (!gameOver && !levelComplete)
     {
-        // Update disembodied cooldown timer
-        if (disembodiedCooldown > 0.0f)
-        {
-            disembodiedCooldown -= GetFrameTime();
-            if (disembodiedCooldown < 0.0f)
-            {
-                disembodiedCooldown = 0.0f;
-            }
-        }
-
         // Update player
         player.update();
 
         // Update monsters
-        monsterManager.update(player, currentLevel.getGrid(), canMonsterBecomeDisembodied(),
-                              [this]()
-                              { notifyMonsterBecameDisembodied(); });
+        monsterManager.update(player, currentLevel.getGrid());
 
         // Update game logic
         updateGameLogic();
@@ -127,6 +120,17 @@ void GamePlay::reset()
     init();
 }
 
+void GamePlay::setHardMode(bool enabled)
+{
+    monsterManager.setDragonLookahead(enabled);
+    monsterManager.getDisembodimentScheduler().setSlots(enabled ? HARD_MODE_GHOSTS : 1);
+}
+
+bool GamePlay::isHardMode() const
+{
+    return monsterManager.usesDragonLookahead();
+}
+
 Player &GamePlay::getPlayer()
 {
     return player;
@@ -215,13 +219,7 @@ void GamePlay::drawHUD()
     DrawText(posText, 10, 35, 15, WHITE);
 
     // Draw monster count
-    int aliveMonsters = 0;
-    auto &monsters = monsterManager.getMonsters();
-    for (const auto &monster : monsters)
-    {
-        if (monster->isActive() && !monster->isDead())
-            aliveMonsters++;
-    }
+    int aliveMonsters = monsterManager.getStore().countAlive();
 
     const char *monsterText = TextFormat("Monsters Remaining: %d", aliveMonsters);
     DrawText(monsterText, 10, 55, 15, WHITE);
@@ -238,6 +236,14 @@ void GamePlay::drawHUD()
         DrawCircleV({static_cast<float>(livesStartX + i * 25), static_cast<float>(livesY)}, 8, BLUE);
         DrawCircleV({static_cast<float>(livesStartX + i * 25), static_cast<float>(livesY)}, 3, WHITE); // Direction indicator
     }
+
+    // Hard mode: how fast the dragons' lookahead is simulating
+    if (isHardMode())
+    {
+        const char *searchText = TextFormat("Hard - lookahead %.0f rollouts/ms",
+                                            monsterManager.getLookaheadSearch().getRolloutsPerMs());
+        DrawText(searchText, 10, 95, 15, ORANGE);
+    }
 }
 
 void GamePlay::handlePlayerMovement()
@@ -256,31 +262,6 @@ void GamePlay::handlePlayerMovement()
     }
 }
 
-bool GamePlay::canMonsterBecomeDisembodied() const
-{
-    // Check if cooldown allows a new disembodied monster
-    if (disembodiedCooldown > 0.0f)
-        return false;
-
-    // Check if there's already a disembodied monster
-    auto &monsters = monsterManager.getMonsters();
-    for (const auto &monster : monsters)
-    {
-        if (monster->isActive() && monster->getState() == MonsterState::DISEMBODIED)
-        {
-            return false; // Only one disembodied monster at a time
-        }
-    }
-
-    return true;
-}
-
-void GamePlay::notifyMonsterBecameDisembodied()
-{
-    // Reset the cooldown timer when a monster becomes disembodied
-    disembodiedCooldown = DISEMBODIED_COOLDOWN_TIME;
-}
-
 void GamePlay::respawnPlayer()
 {
     // Reset player position to starting location
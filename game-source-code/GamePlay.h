@@ -68,6 +68,18 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Choose hard mode: green dragons plan by searching ahead, and two monsters may go disembodied at once
+     * @param enabled true for hard mode
+     */
+    void setHardMode(bool enabled);
+
+    /**
+     * @brief Check if the game is in hard mode
+     * @return true in hard mode
+     */
+    bool isHardMode() const;
+
     /**
      * @brief Get the player object for testing
      * @return Reference to the player
@@ -93,14 +105,11 @@ private:
     bool gameOver;                                // Game over flag
     bool levelComplete;                           // Level complete flag
     bool playerWon;                               // Player won flag
-    float disembodiedCooldown;                    // Timer to prevent multiple monsters becoming disembodied at once
-    static const float DISEMBODIED_COOLDOWN_TIME; // Cooldown duration between disembodied transitions
+    static const int HARD_MODE_GHOSTS = 2;        // Monsters that may be disembodied at once in hard mode
 
     void updateGameLogic();
     void drawHUD();
     void handlePlayerMovement();
-    bool canMonsterBecomeDisembodied() const;
-    void notifyMonsterBecameDisembodied();
     void respawnPlayer();
 };
 
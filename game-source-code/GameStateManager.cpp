@@ -151,10 +151,12 @@ void GameStateManager::switchState(GameState newState)
         if (!gamePlayState)
         {
             gamePlayState = std::make_unique<GamePlay>();
+            gamePlayState->setHardMode(menuState && menuState->isHardModeSelected());
             gamePlayState->init();
         }
         else
         {
+            gamePlayState->setHardMode(menuState && menuState->isHardModeSelected());
             gamePlayState->reset();
         }
         break;
@@ -13,15 +13,28 @@ GreenDragon::GreenDragon(Vector2 startPos)
     : Monster(startPos, MonsterState::IN_TUNNEL),
       fireProjectile(std::make_unique<Fire>()),
       fireBreathCooldown(0.0f),
-      fireBreathRange(FIRE_BREATH_RANGE)
+      fireBreathRange(FIRE_BREATH_RANGE),
+      lookahead(nullptr)
 {
+    kind = MonsterKind::GREEN_DRAGON;
     setSpeed(1.3f);
+    aiUpdateInterval = 0.2f; // Dragons re-plan more often than base monsters
+
+    // Dragons pursue from range, so keep a route that survives the player's digging
+    setIncrementalReplanning(true);
+}
+
+GreenDragon::~GreenDragon()
+{
+    if (timers)
+        timers->cancel(cooldownDeadline);
 }
 
 void GreenDragon::update()
 {
     Monster::update();
-    updateFireBreathCooldown();
+    if (!timers)
+        updateFireBreathCooldown();
 
     if (fireProjectile)
     {
@@ -77,172 +90,166 @@ void GreenDragon::draw()
     }
 }
 
-void GreenDragon::updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                           std::function<void()> notifyDisembodied)
+void GreenDragon::updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied)
 {
     if (currentState == MonsterState::DEAD)
         return;
 
-    if (aiUpdateTimer < 0.2f)
+    if (getThinkTimer() < aiUpdateInterval)
         return;
 
-    aiUpdateTimer = 0.0f;
+    setThinkTimer(0.0f);
 
-    if (currentState == MonsterState::IN_TUNNEL)
-    {
-        handleInTunnelAI(player, grid, canBecomeDisembodied, notifyDisembodied);
-    }
-    else if (currentState == MonsterState::DISEMBODIED)
-    {
-        handleDisembodiedAI(player, grid);
-    }
+    runBehavior(player, grid, canBecomeDisembodied);
 
-    stateTimer += GetFrameTime();
+    setStateTimer(getStateTimer() + GetFrameTime());
 }
 
-void GreenDragon::handleInTunnelAI(const Player &player, Grid &grid,
-                                   bool canBecomeDisembodied, std::function<void()> notifyDisembodied)
+void GreenDragon::applyIntent(const MonsterIntent &decision, const Player &player, Grid &grid)
 {
-    Vector2 playerPos = player.getPosition();
-    float distanceToPlayer = calculateDistanceToPlayer(player);
+    Monster::applyIntent(decision, player, grid);
+
+    if (decision.breathesFire)
+        breatheFire(player.getPosition());
 
-    // Priority 1: Fire if possible
-    if (canBreatheFire() && TacticalAI::isInRange(position, playerPos, fireBreathRange) &&
-        hasDirectTunnelPathToPlayer(player, grid))
+    // The search shares its buffers between the dragons, so it only runs here
+    if (decision.searchesAhead && lookahead)
     {
-        if (breatheFire(playerPos))
+#if MONSTER_DECISION_TRACE
+        // The think was recorded while deciding; the search finishes it here
+        DecisionRecord *traced = decisionTrace.getLatest();
+        DecisionScores::Scope scores(traced);
+#endif
+        LookaheadChoice choice = lookahead->search(position, speed, getFireBreathCooldown(), fireBreathRange, player, grid);
+#if MONSTER_DECISION_TRACE
+        if (traced)
         {
-            return;
+            traced->chosen = static_cast<std::uint8_t>(choice.breatheFire ? Direction::NONE : choice.direction);
+            if (choice.breatheFire)
+                traced->flags |= DecisionRecord::BREATHES_FIRE;
         }
+#endif
+        if (choice.breatheFire)
+            breatheFire(player.getPosition());
+        else
+            move(choice.direction, grid);
     }
+}
 
-    // Priority 2: Chase if close
-    if (distanceToPlayer < 96.0f)
+bool GreenDragon::checkBehaviorCondition(BehaviorCondition condition, float value, const BehaviorContext &context)
+{
+    switch (condition)
     {
-        if (!isMoving)
-        {
-            auto canMoveFunc = [this, &grid](Vector2 pos)
-            { return canMoveTo(pos, grid); };
-            Direction chaseDirection = PathFinding::findBestDirectionToTarget(
-                position, playerPos, grid, canMoveFunc);
-
-            if (chaseDirection != Direction::NONE)
-            {
-                move(chaseDirection, grid);
-                return;
-            }
-        }
+    case BehaviorCondition::CAN_BREATHE_FIRE:
+        return canBreatheFire();
+    case BehaviorCondition::PLAYER_IN_FIRE_RANGE:
+        return TacticalAI::isInRange(position, context.player.getPosition(), fireBreathRange);
+    case BehaviorCondition::FIRE_LINE_TO_PLAYER:
+        return hasDirectTunnelPathToPlayer(context.player, context.grid);
+    default:
+        return Monster::checkBehaviorCondition(condition, value, context);
     }
-    // Priority 3: Tactical positioning
-    else if (distanceToPlayer <= 192.0f)
+}
+
+BehaviorStatus GreenDragon::runBehaviorAction(BehaviorAction action, const BehaviorContext &context)
+{
+    Grid &grid = context.grid;
+    Vector2 playerPos = context.player.getPosition();
+
+    switch (action)
     {
-        if (!isMoving)
-        {
-            if (rand() % 5 != 0)
-            {
-                auto canMoveFunc = [this, &grid](Vector2 pos)
-                { return canMoveTo(pos, grid); };
-                Direction chaseDirection = PathFinding::findBestDirectionToTarget(
-                    position, playerPos, grid, canMoveFunc);
-
-                if (chaseDirection != Direction::NONE)
-                {
-                    move(chaseDirection, grid);
-                    return;
-                }
-            }
-            else
-            {
-                auto canMoveFunc = [this, &grid](Vector2 pos)
-                { return canMoveTo(pos, grid); };
-                auto hasFireLineFunc = [this, &player, &grid](Vector2 pos)
-                {
-                    Vector2 oldPos = position;
-                    position = pos;
-                    bool hasLine = hasDirectTunnelPathToPlayer(player, grid);
-                    position = oldPos;
-                    return hasLine;
-                };
-
-                Direction tacticalDirection = TacticalAI::findTacticalFirePosition(
-                    position, playerPos, grid, canMoveFunc, hasFireLineFunc, fireBreathRange);
-
-                if (tacticalDirection != Direction::NONE)
-                {
-                    move(tacticalDirection, grid);
-                    return;
-                }
-            }
-        }
-    }
-    // Priority 4: Become disembodied if far
-    else if (distanceToPlayer > 192.0f)
+    case BehaviorAction::BREATHE_FIRE:
+        return breatheFire(playerPos) ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
+
+    case BehaviorAction::TAKE_FIRING_POSITION:
     {
-        if (canBecomeDisembodied && stateTimer > 2.0f)
+        auto canMoveFunc = [this, &grid](Vector2 pos)
+        { return canMoveTo(pos, grid); };
+        Direction tacticalDirection = Direction::NONE;
+        const InfluenceMap &influence = TacticalAI::getInfluenceMap();
+        bool influenceCurrent = influence.describes(grid, playerPos, fireBreathRange);
+
+        // Head for the nearest tile with a shot, and hold it while the breath cools down
+        auto planFireLineFunc = [&grid, &influence, influenceCurrent, playerPos](Vector2 pos)
         {
-            setState(MonsterState::DISEMBODIED);
-            stateTimer = 0.0f;
-            if (notifyDisembodied)
-            {
-                notifyDisembodied();
-            }
-            return;
+            if (!influenceCurrent)
+                return PathFinding::hasDirectTunnelPath(pos, playerPos, grid);
+            Vector2 tile = grid.worldToGrid(pos);
+            return influence.hasFireLine(static_cast<int>(tile.x), static_cast<int>(tile.y));
+        };
+        FirePositionPlan plan = TacticalAI::planFirePosition(position, playerPos, grid, canMoveFunc,
+                                                             planFireLineFunc, fireBreathRange);
+        if (plan.steps == 0)
+            return BehaviorStatus::SUCCESS;
+        if (plan.steps > 0)
+        {
+            move(plan.firstStep, grid);
+            return BehaviorStatus::SUCCESS;
         }
 
-        if (!isMoving && (rand() % 5 < 3))
+        // No shot within reach: edge toward the best-scoring neighbour instead
+        if (influenceCurrent)
+        {
+            tacticalDirection = TacticalAI::findTacticalFirePosition(position, grid, canMoveFunc, influence);
+        }
+        else
         {
-            auto canMoveFunc = [this, &grid](Vector2 pos)
-            { return canMoveTo(pos, grid); };
-            Direction chaseDirection = PathFinding::findBestDirectionToTarget(
-                position, playerPos, grid, canMoveFunc);
-
-            if (chaseDirection != Direction::NONE)
-            {
-                move(chaseDirection, grid);
-                return;
-            }
+            auto hasFireLineFunc = [&grid, playerPos](Vector2 pos)
+            { return PathFinding::hasDirectTunnelPath(pos, playerPos, grid); };
+
+            tacticalDirection = TacticalAI::findTacticalFirePosition(
+                position, playerPos, grid, canMoveFunc, hasFireLineFunc, fireBreathRange);
         }
+
+        if (tacticalDirection == Direction::NONE)
+            return BehaviorStatus::FAILURE;
+        move(tacticalDirection, grid);
+        return BehaviorStatus::SUCCESS;
     }
 
-    // Fallback
-    if (!isMoving && (rand() % 10 == 0))
+    case BehaviorAction::SEARCH_AHEAD:
     {
-        auto canMoveFunc = [this, &grid](Vector2 pos)
-        { return canMoveTo(pos, grid); };
-        Direction fallbackDirection = PathFinding::findRandomValidDirection(
-            position, grid, canMoveFunc);
-
-        if (fallbackDirection != Direction::NONE)
+        if (!lookahead)
+            return BehaviorStatus::FAILURE;
+        if (intent)
         {
-            move(fallbackDirection, grid);
+            intent->searchesAhead = true;
+            return BehaviorStatus::SUCCESS;
         }
+
+        LookaheadChoice choice = lookahead->search(position, speed, getFireBreathCooldown(), fireBreathRange,
+                                                   context.player, grid);
+        if (choice.breatheFire)
+            return breatheFire(playerPos) ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
+
+        // Holding still is a decision too
+        move(choice.direction, grid);
+        return BehaviorStatus::SUCCESS;
+    }
+
+    default:
+        return Monster::runBehaviorAction(action, context);
     }
 }
 
-void GreenDragon::handleDisembodiedAI(const Player &player, Grid &grid)
+void GreenDragon::setLookaheadSearch(LookaheadSearch *search)
 {
-    if (stateTimer > 4.0f)
-    {
-        Vector2 gridPos = grid.worldToGrid(position);
-        if (grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y)))
-        {
-            setState(MonsterState::IN_TUNNEL);
-            stateTimer = 0.0f;
-        }
-    }
+    lookahead = search;
+}
 
-    if (!isMoving)
-    {
-        auto canMoveFunc = [this, &grid](Vector2 pos)
-        { return canMoveTo(pos, grid); };
-        Direction chaseDirection = PathFinding::findBestDirectionToTarget(
-            position, player.getPosition(), grid, canMoveFunc);
+void GreenDragon::setTimerWheel(TimerWheel *wheel)
+{
+    if (wheel == timers)
+        return;
 
-        if (chaseDirection != Direction::NONE)
-        {
-            move(chaseDirection, grid);
-        }
-    }
+    float cooldown = getFireBreathCooldown();
+    if (timers)
+        timers->cancel(cooldownDeadline);
+
+    Monster::setTimerWheel(wheel);
+    fireBreathCooldown = 0.0f;
+    if (cooldown > 0.0f)
+        startFireBreathCooldown(cooldown);
 }
 
 Fire &GreenDragon::getFire()
@@ -269,6 +276,13 @@ bool GreenDragon::breatheFire(Vector2 playerPos)
     if (fireDirection == Direction::NONE)
         return false;
 
+    // While deciding, only say the fire would go; applyIntent() breathes it
+    if (intent)
+    {
+        intent->breathesFire = true;
+        return true;
+    }
+
     Vector2 fireStartPos = {
         position.x + size.x / 2 - 4,
         position.y + size.y / 2 - 4};
@@ -293,21 +307,14 @@ bool GreenDragon::breatheFire(Vector2 playerPos)
     }
 
     fireProjectile->breathe(fireStartPos, fireDirection);
-    fireBreathCooldown = FIRE_BREATH_COOLDOWN_TIME;
+    startFireBreathCooldown(FIRE_BREATH_COOLDOWN_TIME);
 
     return true;
 }
 
 bool GreenDragon::hasDirectTunnelPathToPlayer(const Player &player, const Grid &grid) const
 {
-    Vector2 playerPos = player.getPosition();
-
-    auto checkFunc = [&grid](int x, int y) -> bool
-    {
-        return grid.isTunnel(x, y);
-    };
-
-    return PathFinding::hasDirectPath(position, playerPos, grid, checkFunc);
+    return PathFinding::hasDirectTunnelPath(position, player.getPosition(), grid);
 }
 
 void GreenDragon::updateFireBreathCooldown()
@@ -320,4 +327,20 @@ void GreenDragon::updateFireBreathCooldown()
             fireBreathCooldown = 0.0f;
         }
     }
+}
+
+float GreenDragon::getFireBreathCooldown() const
+{
+    return timers ? timers->getRemaining(cooldownDeadline) : fireBreathCooldown;
+}
+
+void GreenDragon::startFireBreathCooldown(float seconds)
+{
+    fireBreathCooldown = seconds;
+    if (!timers)
+        return;
+
+    timers->cancel(cooldownDeadline);
+    cooldownDeadline = timers->schedule(seconds, [this]
+                                        { fireBreathCooldown = 0.0f; });
 }
\ No newline at end of file
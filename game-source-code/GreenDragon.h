@@ -4,6 +4,8 @@
 #include "Monster.h"
 #include "PathFinding.h"
 #include "TacticalAI.h"
+#include "LookaheadSearch.h"
+#include "TimerWheel.h"
 #include <memory>
 #include <random>
 
@@ -16,12 +18,19 @@ class Fire;
 class GreenDragon : public Monster
 {
 public:
+    static const float FIRE_BREATH_RANGE; // Maximum range to breathe fire
+
     /**
      * @brief Constructor for GreenDragon
      * @param startPos Starting position in world coordinates
      */
     GreenDragon(Vector2 startPos = {0, 0});
 
+    /**
+     * @brief Destructor; cancels a cooldown still waiting on the wheel
+     */
+    ~GreenDragon() override;
+
     /**
      * @brief Update the green dragon
      */
@@ -36,11 +45,17 @@ public:
      * @brief Update monster AI to chase the player (GreenDragon specific)
      * @param player Reference to the player
      * @param grid Reference to the game grid
-     * @param canBecomeDisembodied Whether the monster is allowed to become disembodied
-     * @param notifyDisembodied Callback function to notify when monster becomes disembodied
+     * @param canBecomeDisembodied Whether the monster may become disembodied (without a disembodiment scheduler)
+     */
+    void updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied = false) override;
+
+    /**
+     * @brief Carry out a decision, breathing fire and running the lookahead search it asked for
+     * @param decision What the last decide() recorded
+     * @param player Reference to the player
+     * @param grid Reference to the game grid
      */
-    void updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                  std::function<void()> notifyDisembodied = nullptr);
+    void applyIntent(const MonsterIntent &decision, const Player &player, Grid &grid) override;
 
     /**
      * @brief Get the dragon's fire projectile
@@ -67,29 +82,36 @@ public:
      */
     bool breatheFire(Vector2 playerPos);
 
-private:
-    std::unique_ptr<Fire> fireProjectile;         // Dragon's fire projectile
-    float fireBreathCooldown;                     // Cooldown timer for breathing fire
-    float fireBreathRange;                        // Maximum range for breathing fire
-    static const float FIRE_BREATH_COOLDOWN_TIME; // Cooldown duration between fire breaths
-    static const float FIRE_BREATH_RANGE;         // Maximum range to breathe fire
+    /**
+     * @brief Plan moves with a lookahead search (hard mode)
+     * @param search Shared search, not owned; nullptr to follow the behavior tree's rules
+     */
+    void setLookaheadSearch(LookaheadSearch *search);
 
     /**
-     * @brief Handle in-tunnel AI behavior
-     * @param player Reference to the player
-     * @param grid Reference to the game grid
-     * @param canBecomeDisembodied Whether can become disembodied
-     * @param notifyDisembodied Callback for disembodied notification
+     * @brief Move the timers onto a wheel, the fire cooldown becoming a deadline on it
+     * @param wheel Shared wheel, not owned and outliving the dragon; nullptr to count the cooldown down in update()
      */
-    void handleInTunnelAI(const Player &player, Grid &grid,
-                          bool canBecomeDisembodied, std::function<void()> notifyDisembodied);
+    void setTimerWheel(TimerWheel *wheel) override;
 
+protected:
     /**
-     * @brief Handle disembodied AI behavior
-     * @param player Reference to the player
-     * @param grid Reference to the game grid
+     * @brief Answer the fire-breathing conditions, passing the rest to Monster
+     */
+    bool checkBehaviorCondition(BehaviorCondition condition, float value, const BehaviorContext &context) override;
+
+    /**
+     * @brief Breathe fire or take a firing position, passing other actions to Monster
      */
-    void handleDisembodiedAI(const Player &player, Grid &grid);
+    BehaviorStatus runBehaviorAction(BehaviorAction action, const BehaviorContext &context) override;
+
+private:
+    std::unique_ptr<Fire> fireProjectile;         // Dragon's fire projectile
+    float fireBreathCooldown;                     // Cooldown timer for breathing fire; on a wheel, held until the deadline clears it
+    TimerHandle cooldownDeadline;                 // Wheel timer that ends the cooldown
+    float fireBreathRange;                        // Maximum range for breathing fire
+    static const float FIRE_BREATH_COOLDOWN_TIME; // Cooldown duration between fire breaths
+    LookaheadSearch *lookahead;                   // Hard-mode move planner, not owned
 
     /**
      * @brief Check if there's a direct tunnel path to the player for fire breathing
@@ -103,6 +125,18 @@ private:
      * @brief Update fire breath cooldown
      */
     void updateFireBreathCooldown();
+
+    /**
+     * @brief Get how long until the dragon may breathe again
+     * @return Seconds of cooldown left
+     */
+    float getFireBreathCooldown() const;
+
+    /**
+     * @brief Start the cooldown, as a deadline when on a wheel
+     * @param seconds Length of the cooldown
+     */
+    void startFireBreathCooldown(float seconds);
 };
 
 #endif // GREEN_DRAGON_H
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include <raylib-cpp.hpp>
 #include "Level.h"
 
+std::atomic<unsigned int> Grid::nextVersion{0};
+
 Grid::Grid(int gridWidth, int gridHeight, int tileSize)
-    : width(gridWidth), height(gridHeight), tileSize(tileSize)
+    : width(gridWidth), height(gridHeight), tileSize(tileSize), version(++nextVersion),
+      historyStart(version)
 {
     initializeGrid();
 }
@@ -20,9 +23,24 @@ TileType Grid::getTile(int x, int y) const
 
 void Grid::setTile(int x, int y, TileType type)
 {
-    if (isValidPosition(x, y))
+    if (isValidPosition(x, y) && tiles[y][x] != type)
     {
+        bool wasTunnel = tiles[y][x] == TileType::TUNNEL;
         tiles[y][x] = type;
+        version = ++nextVersion;
+
+        changeLog.push_back({version, x, y});
+        if (changeLog.size() > CHANGE_LOG_SIZE)
+        {
+            historyStart = changeLog.front().version;
+            changeLog.pop_front();
+        }
+
+        if (wasTunnel != (type == TileType::TUNNEL))
+        {
+            rebuildRowRuns(y);
+            rebuildColumnRuns(x);
+        }
     }
 }
 
@@ -31,6 +49,24 @@ bool Grid::isTunnel(int x, int y) const
     return getTile(x, y) == TileType::TUNNEL;
 }
 
+bool Grid::isClearRow(int y, int x1, int x2) const
+{
+    if (!isValidPosition(x1, y) || !isValidPosition(x2, y))
+        return false;
+
+    int runStart = rowRunStart[y * width + x1];
+    return runStart != -1 && runStart == rowRunStart[y * width + x2];
+}
+
+bool Grid::isClearColumn(int x, int y1, int y2) const
+{
+    if (!isValidPosition(x, y1) || !isValidPosition(x, y2))
+        return false;
+
+    int runStart = columnRunStart[y1 * width + x];
+    return runStart != -1 && runStart == columnRunStart[y2 * width + x];
+}
+
 void Grid::digTunnel(int x, int y)
 {
     if (isValidPosition(x, y) && getTile(x, y) == TileType::EARTH)
@@ -73,6 +109,26 @@ int Grid::getTileSize() const
     return tileSize;
 }
 
+unsigned int Grid::getVersion() const
+{
+    return version;
+}
+
+bool Grid::getChangesSince(unsigned int sinceVersion, std::vector<std::pair<int, int>> &changedTiles) const
+{
+    if (sinceVersion < historyStart || sinceVersion > version)
+        return false;
+
+    for (const TileChange &change : changeLog)
+    {
+        if (change.version > sinceVersion)
+        {
+            changedTiles.push_back({change.x, change.y});
+        }
+    }
+    return true;
+}
+
 void Grid::drawGrid() const
 {
     // Draw grid lines for debugging
@@ -123,4 +179,46 @@ void Grid::initializeGrid()
     {
         tiles[y].resize(width, TileType::EARTH);
     }
+
+    // No tunnels yet, so no tile belongs to a run
+    rowRunStart.assign(width * height, -1);
+    columnRunStart.assign(width * height, -1);
+}
+
+void Grid::rebuildRowRuns(int y)
+{
+    int runStart = -1;
+    for (int x = 0; x < width; x++)
+    {
+        if (tiles[y][x] == TileType::TUNNEL)
+        {
+            if (runStart == -1)
+                runStart = x;
+            rowRunStart[y * width + x] = runStart;
+        }
+        else
+        {
+            runStart = -1;
+            rowRunStart[y * width + x] = -1;
+        }
+    }
+}
+
+void Grid::rebuildColumnRuns(int x)
+{
+    int runStart = -1;
+    for (int y = 0; y < height; y++)
+    {
+        if (tiles[y][x] == TileType::TUNNEL)
+        {
+            if (runStart == -1)
+                runStart = y;
+            columnRunStart[y * width + x] = runStart;
+        }
+        else
+        {
+            runStart = -1;
+            columnRunStart[y * width + x] = -1;
+        }
+    }
 }
\ No newline at end of file
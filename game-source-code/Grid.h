@@ -2,6 +2,9 @@
 #define GRID_H
 
 #include <vector>
+#include <deque>
+#include <utility>
+#include <atomic>
 #include <raylib-cpp.hpp>
 #include "GameEnums.h"
 
@@ -43,6 +46,28 @@ public:
      */
     bool isTunnel(int x, int y) const;
 
+    /**
+     * @brief Check if a horizontal span is one unbroken tunnel
+     *
+     * Answered from the row run index in constant time.
+     * @param y Grid row
+     * @param x1 One end of the span (inclusive)
+     * @param x2 Other end of the span (inclusive)
+     * @return true if every tile in the span is a tunnel
+     */
+    bool isClearRow(int y, int x1, int x2) const;
+
+    /**
+     * @brief Check if a vertical span is one unbroken tunnel
+     *
+     * Answered from the column run index in constant time.
+     * @param x Grid column
+     * @param y1 One end of the span (inclusive)
+     * @param y2 Other end of the span (inclusive)
+     * @return true if every tile in the span is a tunnel
+     */
+    bool isClearColumn(int x, int y1, int y2) const;
+
     /**
      * @brief Dig a tunnel at the specified position
      * @param x Grid x coordinate
@@ -91,6 +116,27 @@ public:
      */
     int getTileSize() const;
 
+    /**
+     * @brief Get the version stamp of the grid contents
+     *
+     * The stamp changes every time a tile changes type and is unique across
+     * all grids, so it can key caches derived from the tile layout.
+     * @return Current version stamp
+     */
+    unsigned int getVersion() const;
+
+    /**
+     * @brief List the tiles changed after a given version
+     *
+     * Only the most recent changes are remembered; when the requested
+     * version is older than that history the caller must rebuild from
+     * scratch.
+     * @param sinceVersion Version the caller last saw
+     * @param changedTiles Receives the (x, y) of every changed tile, oldest first
+     * @return false if the history does not reach back to sinceVersion
+     */
+    bool getChangesSince(unsigned int sinceVersion, std::vector<std::pair<int, int>> &changedTiles) const;
+
     /**
      * @brief Draw the grid (for debugging)
      */
@@ -106,11 +152,42 @@ private:
     int height;                               ///< Grid height in tiles
     int tileSize;                             ///< Size of each tile in pixels
     std::vector<std::vector<TileType>> tiles; ///< 2D grid of tiles
+    unsigned int version;                     ///< Version stamp of the tile layout
+    std::vector<int> rowRunStart;             ///< Per tile: first x of its horizontal tunnel run, or -1
+    std::vector<int> columnRunStart;          ///< Per tile: first y of its vertical tunnel run, or -1
+
+    /**
+     * @brief One entry of the tile change history
+     */
+    struct TileChange
+    {
+        unsigned int version; ///< Grid version after the change
+        int x;                ///< Grid x coordinate
+        int y;                ///< Grid y coordinate
+    };
+
+    std::deque<TileChange> changeLog; ///< Most recent tile changes, oldest first
+    unsigned int historyStart;        ///< Oldest version the change log fully covers
+
+    static const size_t CHANGE_LOG_SIZE = 64;     ///< Number of changes remembered
+    static std::atomic<unsigned int> nextVersion; ///< Source of unique version stamps
 
     /**
      * @brief Initialize the grid with default earth
      */
     void initializeGrid();
+
+    /**
+     * @brief Recompute the tunnel runs of one row
+     * @param y Grid row
+     */
+    void rebuildRowRuns(int y);
+
+    /**
+     * @brief Recompute the tunnel runs of one column
+     * @param x Grid column
+     */
+    void rebuildColumnRuns(int x);
 };
 
 #endif // GRID_H
\ No newline at end of file
@@ -101,6 +101,11 @@ float Harpoon::getSpeed() const
     return speed;
 }
 
+float Harpoon::getMaxRange() const
+{
+    return maxRange;
+}
+
 void Harpoon::setSpeed(float newSpeed)
 {
     speed = newSpeed;
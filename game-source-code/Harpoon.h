@@ -77,6 +77,12 @@ public:
      */
     void setSpeed(float newSpeed);
 
+    /**
+     * @brief Get the harpoon's maximum travel distance
+     * @return Range in pixels
+     */
+    float getMaxRange() const;
+
 private:
     Direction direction;  // Direction the harpoon is traveling
     float speed;          // Movement speed
@@ -0,0 +1,277 @@
+#include "InfluenceMap.h"
+#include "PathFinding.h"
+#include "TacticalAI.h"
+#include "UtilityAI.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1}; // Indexed by Direction (UP, DOWN, LEFT, RIGHT)
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+
+    // Tile holding the centre of a rectangle
+    void centreTile(Rectangle bounds, const Grid &grid, int &x, int &y)
+    {
+        Vector2 tile = grid.worldToGrid({bounds.x + bounds.width / 2, bounds.y + bounds.height / 2});
+        x = static_cast<int>(tile.x);
+        y = static_cast<int>(tile.y);
+    }
+
+    unsigned char saturate(int value)
+    {
+        return static_cast<unsigned char>(std::min(value, 255));
+    }
+}
+
+InfluenceMap::InfluenceMap()
+    : width(0), height(0), gridVersion(0), playerPosition{0, 0}, scoredFireRange(0.0f)
+{
+}
+
+void InfluenceMap::build(const Grid &grid, const Player &player, const MonsterStore &monsters,
+                         const std::vector<Fire *> &fires, float fireRange)
+{
+    width = grid.getWidth();
+    height = grid.getHeight();
+    gridVersion = grid.getVersion();
+    playerPosition = player.getPosition();
+    scoredFireRange = fireRange;
+
+    const int tileCount = width * height;
+    playerThreat.assign(tileCount, 0);
+    fireCoverage.assign(tileCount, 0);
+    monsterDensity.assign(tileCount, 0);
+    rockDanger.assign(tileCount, 0);
+    fireLine.assign(tileCount, 0);
+    firePositionScores.assign(tileCount, 0.0f);
+    rowSums.assign(tileCount, 0);
+
+    buildPlayerThreat(grid, player);
+    buildFireCoverage(grid, fires);
+    buildMonsterDensity(grid, monsters);
+    buildRockDanger(grid);
+    buildFirePositionScores(grid, fireRange);
+}
+
+bool InfluenceMap::describes(const Grid &grid, Vector2 playerPos, float fireRange) const
+{
+    return gridVersion != 0 && gridVersion == grid.getVersion() &&
+           width == grid.getWidth() && height == grid.getHeight() &&
+           playerPosition.x == playerPos.x && playerPosition.y == playerPos.y &&
+           scoredFireRange == fireRange;
+}
+
+unsigned char InfluenceMap::getPlayerThreat(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index == -1 ? 0 : playerThreat[index];
+}
+
+unsigned char InfluenceMap::getFireCoverage(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index == -1 ? 0 : fireCoverage[index];
+}
+
+unsigned char InfluenceMap::getMonsterDensity(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index == -1 ? 0 : monsterDensity[index];
+}
+
+unsigned char InfluenceMap::getRockDanger(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index == -1 ? 0 : rockDanger[index];
+}
+
+float InfluenceMap::getFirePositionScore(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index == -1 ? 0.0f : firePositionScores[index];
+}
+
+bool InfluenceMap::hasFireLine(int x, int y) const
+{
+    int index = indexOf(x, y);
+    return index != -1 && fireLine[index];
+}
+
+unsigned int InfluenceMap::getGridVersion() const
+{
+    return gridVersion;
+}
+
+void InfluenceMap::buildPlayerThreat(const Grid &grid, const Player &player)
+{
+    int px, py;
+    centreTile(player.getBounds(), grid, px, py);
+
+    int reach = static_cast<int>(std::ceil(player.getHarpoon().getMaxRange() / grid.getTileSize()));
+    Direction facing = player.getFacingDirection();
+
+    for (int d = 0; d < 4; d++)
+    {
+        Direction direction = static_cast<Direction>(d);
+        markLine(playerThreat, grid, px, py, direction, reach,
+                 direction == facing ? THREAT_FACING : THREAT_TURNING);
+    }
+}
+
+void InfluenceMap::buildFireCoverage(const Grid &grid, const std::vector<Fire *> &fires)
+{
+    for (const Fire *fire : fires)
+    {
+        if (!fire->isFireActive() || fire->getDirection() == Direction::NONE)
+            continue;
+
+        int fx, fy;
+        centreTile(fire->getBounds(), grid, fx, fy);
+        int reach = static_cast<int>(std::ceil(fire->getRemainingRange() / grid.getTileSize()));
+        markLine(fireCoverage, grid, fx, fy, fire->getDirection(), reach, DANGER);
+    }
+}
+
+void InfluenceMap::buildMonsterDensity(const Grid &grid, const MonsterStore &monsters)
+{
+    // Occupancy counts first, written straight into the output layer
+    for (int i = 0; i < monsters.size(); i++)
+    {
+        if (!monsters.isAlive(i))
+            continue;
+
+        int mx, my;
+        centreTile(monsters.getBounds(i), grid, mx, my);
+        int index = indexOf(mx, my);
+        if (index != -1)
+            monsterDensity[index] = saturate(monsterDensity[index] + 1);
+    }
+
+    // 3x3 box sum as a horizontal pass then a vertical pass
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *counts = &monsterDensity[y * width];
+        unsigned char *sums = &rowSums[y * width];
+        for (int x = 0; x < width; x++)
+        {
+            int left = x > 0 ? counts[x - 1] : 0;
+            int right = x + 1 < width ? counts[x + 1] : 0;
+            sums[x] = saturate(left + counts[x] + right);
+        }
+    }
+
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *above = y > 0 ? &rowSums[(y - 1) * width] : nullptr;
+        const unsigned char *row = &rowSums[y * width];
+        const unsigned char *below = y + 1 < height ? &rowSums[(y + 1) * width] : nullptr;
+        unsigned char *out = &monsterDensity[y * width];
+        for (int x = 0; x < width; x++)
+        {
+            int sum = row[x];
+            if (above)
+                sum += above[x];
+            if (below)
+                sum += below[x];
+            out[x] = saturate(sum);
+        }
+    }
+}
+
+void InfluenceMap::buildRockDanger(const Grid &grid)
+{
+    // A rock with tunnel below falls until it meets earth or another rock,
+    // so danger runs down from it through the tunnel tiles, one row at a time
+    for (int y = 1; y < height; y++)
+    {
+        const unsigned char *above = &rockDanger[(y - 1) * width];
+        unsigned char *row = &rockDanger[y * width];
+        for (int x = 0; x < width; x++)
+        {
+            bool looseAbove = grid.getTile(x, y - 1) == TileType::ROCK || above[x] != 0;
+            row[x] = (looseAbove && grid.isTunnel(x, y)) ? DANGER : 0;
+        }
+    }
+}
+
+void InfluenceMap::buildFirePositionScores(const Grid &grid, float fireRange)
+{
+    const int tileSize = grid.getTileSize();
+    const ChokepointMap &chokepoints = TacticalAI::getChokepoints(grid);
+    const UtilityWeights &weights = UtilityAI::getWeights();
+    const float fireLineInRange = weights.get(PositionConsideration::FIRE_LINE_IN_RANGE);
+    const float fireLineOutOfRange = weights.get(PositionConsideration::FIRE_LINE_OUT_OF_RANGE);
+    const float aligned = weights.get(PositionConsideration::ALIGNED);
+    const float tooFar = weights.get(PositionConsideration::TOO_FAR);
+    const float chokepoint = weights.get(PositionConsideration::CHOKEPOINT);
+    Vector2 playerGridPos = grid.worldToGrid(playerPosition);
+    const int playerX = static_cast<int>(playerGridPos.x);
+    const int playerY = static_cast<int>(playerGridPos.y);
+
+    // A straight fire line needs the player's row or column; test only those tiles
+    for (int x = 0; x < width; x++)
+    {
+        if (grid.isValidPosition(x, playerY))
+            fireLine[playerY * width + x] = PathFinding::hasDirectTunnelPath(grid.gridToWorld(x, playerY), playerPosition, grid);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        if (grid.isValidPosition(playerX, y))
+            fireLine[y * width + playerX] = PathFinding::hasDirectTunnelPath(grid.gridToWorld(playerX, y), playerPosition, grid);
+    }
+
+    // The same terms as TacticalAI::scorePosition(), evaluated for every tile
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *lineRow = &fireLine[y * width];
+        float *scoreRow = &firePositionScores[y * width];
+        float dy = playerPosition.y - static_cast<float>(y * tileSize);
+        int rowDistance = std::abs(y - playerY);
+
+        for (int x = 0; x < width; x++)
+        {
+            float dx = playerPosition.x - static_cast<float>(x * tileSize);
+            float distance = static_cast<float>(std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy));
+            bool inRange = distance <= fireRange;
+
+            float score = 0;
+            if (lineRow[x])
+                score += inRange ? fireLineInRange : fireLineOutOfRange;
+            if (x == playerX || y == playerY)
+                score += aligned;
+
+            if (std::abs(x - playerX) + rowDistance > 6)
+                score += tooFar;
+            else if (chokepoints.isChokepoint(x, y))
+                score += chokepoint;
+
+            scoreRow[x] = score;
+        }
+    }
+}
+
+void InfluenceMap::markLine(std::vector<unsigned char> &layer, const Grid &grid,
+                            int x, int y, Direction direction, int tiles, unsigned char value)
+{
+    int d = static_cast<int>(direction);
+
+    for (int step = 0; step <= tiles; step++)
+    {
+        int tx = x + STEP_X[d] * step;
+        int ty = y + STEP_Y[d] * step;
+        if (!grid.isValidPosition(tx, ty) || !grid.isTunnel(tx, ty))
+            break;
+
+        unsigned char &cell = layer[ty * width + tx];
+        cell = std::max(cell, value);
+    }
+}
+
+int InfluenceMap::indexOf(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return -1;
+
+    return y * width + x;
+}
@@ -0,0 +1,116 @@
+#ifndef INFLUENCE_MAP_H
+#define INFLUENCE_MAP_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+#include "Player.h"
+#include "MonsterStore.h"
+#include "Fire.h"
+
+/**
+ * @brief Dense per-tile tactical layers, rebuilt once per tick
+ *
+ * Each layer is one value per tile in row-major order, filled by a few
+ * straight passes over the grid, so AI scoring samples an array entry
+ * instead of re-running line, range and alignment checks per candidate:
+ *
+ * - player threat: tunnel tiles the harpoon can reach, strongest along the
+ *   way the player faces
+ * - fire coverage: tunnel tiles ahead of fire that is in flight
+ * - monster density: living monsters in each tile's 3x3 neighbourhood
+ * - rock danger: tunnel tiles below a rock with nothing holding it up
+ * - fire position score: TacticalAI::scorePosition() of every tile for the
+ *   dragons' fire range, with the fire line of
+ *   PathFinding::hasDirectTunnelPath() (tile-aligned positions)
+ */
+class InfluenceMap
+{
+public:
+    static constexpr unsigned char THREAT_FACING = 255;  ///< Threat on the line the player faces
+    static constexpr unsigned char THREAT_TURNING = 128; ///< Threat on lines the player must turn to fire along
+    static constexpr unsigned char DANGER = 255;         ///< Value of a tile under fire or a loose rock
+
+    /**
+     * @brief Constructor for InfluenceMap
+     */
+    InfluenceMap();
+
+    /**
+     * @brief Rebuild every layer
+     * @param grid Reference to the game grid
+     * @param player The player
+     * @param monsters Packed monster fields
+     * @param fires Fire currently in flight
+     * @param fireRange Range the fire position scores are computed for
+     */
+    void build(const Grid &grid, const Player &player, const MonsterStore &monsters,
+               const std::vector<Fire *> &fires, float fireRange);
+
+    /**
+     * @brief Check if the fire position scores answer a query
+     * @param grid Reference to the game grid
+     * @param playerPos Player's world position
+     * @param fireRange Maximum firing range
+     * @return true if the scores were built for this grid version, player position and range
+     */
+    bool describes(const Grid &grid, Vector2 playerPos, float fireRange) const;
+
+    unsigned char getPlayerThreat(int x, int y) const;
+    unsigned char getFireCoverage(int x, int y) const;
+    unsigned char getMonsterDensity(int x, int y) const;
+    unsigned char getRockDanger(int x, int y) const;
+    float getFirePositionScore(int x, int y) const;
+    // Clear straight tunnel from the tile to the player, whatever the range
+    bool hasFireLine(int x, int y) const;
+
+    /**
+     * @brief Get the grid version the layers describe
+     * @return Version stamp as of the last build (0 before the first)
+     */
+    unsigned int getGridVersion() const;
+
+private:
+    int width;                                 ///< Grid width the layers were built for
+    int height;                                ///< Grid height the layers were built for
+    unsigned int gridVersion;                  ///< Grid version the layers describe
+    Vector2 playerPosition;                    ///< Player position the layers describe
+    float scoredFireRange;                     ///< Range the fire position scores assume
+    std::vector<unsigned char> playerThreat;   ///< Per tile: harpoon threat
+    std::vector<unsigned char> fireCoverage;   ///< Per tile: fire in flight will pass here
+    std::vector<unsigned char> monsterDensity; ///< Per tile: monsters in the 3x3 neighbourhood
+    std::vector<unsigned char> rockDanger;     ///< Per tile: under a loose rock
+    std::vector<unsigned char> fireLine;       ///< Per tile: clear straight tunnel to the player
+    std::vector<float> firePositionScores;     ///< Per tile: tactical score of a firing position
+    std::vector<unsigned char> rowSums;        ///< Scratch: horizontal pass of the density box filter
+
+    void buildPlayerThreat(const Grid &grid, const Player &player);
+    void buildFireCoverage(const Grid &grid, const std::vector<Fire *> &fires);
+    void buildMonsterDensity(const Grid &grid, const MonsterStore &monsters);
+    void buildRockDanger(const Grid &grid);
+    void buildFirePositionScores(const Grid &grid, float fireRange);
+
+    /**
+     * @brief Mark tunnel tiles along a straight line
+     * @param layer Layer to write
+     * @param grid Reference to the game grid
+     * @param x Start tile x coordinate
+     * @param y Start tile y coordinate
+     * @param direction Direction of the line
+     * @param tiles Number of tiles past the start to mark
+     * @param value Value to write (a tile keeps the larger of its old and new value)
+     */
+    void markLine(std::vector<unsigned char> &layer, const Grid &grid,
+                  int x, int y, Direction direction, int tiles, unsigned char value);
+
+    /**
+     * @brief Get the row-major index of a tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return Tile index, or -1 off the grid the layers were built for
+     */
+    int indexOf(int x, int y) const;
+};
+
+#endif // INFLUENCE_MAP_H
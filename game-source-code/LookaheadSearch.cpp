@@ -0,0 +1,588 @@
+#include "LookaheadSearch.h"
+#include "DecisionTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1}; // Indexed by Direction (UP, DOWN, LEFT, RIGHT)
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+
+    const unsigned char TUNNEL = static_cast<unsigned char>(TileType::TUNNEL);
+    const unsigned char ROCK = static_cast<unsigned char>(TileType::ROCK);
+
+    const float FRAMES_PER_SECOND = 60.0f; // Speeds are pixels per frame at the target frame rate
+    const float FIRE_HIT = 0.8f;           // Outcome of breathing along a clear line (the player may still dodge)
+    const float EXPLORATION = 0.5f;        // UCB1 exploration constant
+    const int TIME_CHECK_INTERVAL = 16;    // Rollouts between clock reads
+
+    int manhattan(int x1, int y1, int x2, int y2)
+    {
+        return std::abs(x1 - x2) + std::abs(y1 - y2);
+    }
+
+    int countBits(int mask)
+    {
+        int count = 0;
+        for (; mask; mask &= mask - 1)
+            count++;
+        return count;
+    }
+
+    // Index of the n-th set bit of a mask
+    int nthBit(int mask, int n)
+    {
+        for (int bit = 0; mask; bit++, mask >>= 1)
+        {
+            if ((mask & 1) && n-- == 0)
+                return bit;
+        }
+        return -1;
+    }
+}
+
+LookaheadSearch::LookaheadSearch(unsigned int seed)
+    : width(0), height(0), stride(0), tilesVersion(0), root{}, observed{},
+      nodes(MAX_NODES), nodeCount(0), harpoonTiles(0), fireTiles(0), playerPace(1.0f),
+      rng(seed ? seed : 1u), timeBudgetUs(DEFAULT_TIME_BUDGET_US), frameElapsedUs(0.0), rolloutLimit(0),
+      lastRollouts(0), lastElapsedMs(0.0f), totalRollouts(0), totalElapsedMs(0.0)
+{
+}
+
+void LookaheadSearch::setTimeBudget(int microseconds)
+{
+    timeBudgetUs = std::max(0, microseconds);
+}
+
+int LookaheadSearch::getTimeBudget() const
+{
+    return timeBudgetUs;
+}
+
+void LookaheadSearch::beginFrame()
+{
+    frameElapsedUs = 0.0;
+}
+
+double LookaheadSearch::getFrameElapsedUs() const
+{
+    return frameElapsedUs;
+}
+
+void LookaheadSearch::setRolloutLimit(int rollouts)
+{
+    rolloutLimit = std::max(0, rollouts);
+}
+
+void LookaheadSearch::observeMonsters(const MonsterStore &monsters)
+{
+    // Tile coordinates need the grid, so keep world positions here as whole pixels
+    observed.monsterCount = 0;
+    for (int i = 0; i < monsters.size() && observed.monsterCount < MAX_MONSTERS; i++)
+    {
+        if (!monsters.isAlive(i))
+            continue;
+
+        Vector2 pos = monsters.getPosition(i);
+        int slot = observed.monsterCount++;
+        observed.monsterX[slot] = static_cast<int>(pos.x);
+        observed.monsterY[slot] = static_cast<int>(pos.y);
+        observed.monsterGhost[slot] = monsters.getState(i) == MonsterState::DISEMBODIED;
+        observed.monsterAlive[slot] = true;
+    }
+}
+
+LookaheadChoice LookaheadSearch::search(Vector2 dragonPos, float dragonSpeed, float fireCooldown, float fireRange,
+                                        const Player &player, const Grid &grid)
+{
+    auto started = std::chrono::steady_clock::now();
+    const int tileSize = grid.getTileSize();
+
+    // Fork the real world: tiles only when the grid changed, everything else every search
+    if (width != grid.getWidth() || height != grid.getHeight() || tilesVersion != grid.getVersion())
+    {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        tilesVersion = grid.getVersion();
+        stride = width + 2;
+        baseTiles.assign(stride * (height + 2), ROCK);
+        tiles.resize(baseTiles.size());
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+                baseTiles[tileIndex(x, y)] = static_cast<unsigned char>(grid.getTile(x, y));
+        }
+    }
+
+    Vector2 dragonTile = grid.worldToGrid(dragonPos);
+    Vector2 playerTile = grid.worldToGrid(player.getPosition());
+    int facing = static_cast<int>(player.getFacingDirection());
+
+    root.playerX = static_cast<int>(playerTile.x);
+    root.playerY = static_cast<int>(playerTile.y);
+    root.playerFacing = facing < 4 ? facing : static_cast<int>(Direction::DOWN);
+    root.playerCredit = 0.0f;
+    root.dragonX = static_cast<int>(dragonTile.x);
+    root.dragonY = static_cast<int>(dragonTile.y);
+
+    float stepSeconds = tileSize / (std::max(dragonSpeed, 0.1f) * FRAMES_PER_SECOND);
+    root.fireWait = fireCooldown > 0.0f ? static_cast<int>(std::ceil(fireCooldown / stepSeconds)) : 0;
+
+    // The observed monsters, less the searching dragon itself
+    bool skippedSelf = false;
+    root.monsterCount = 0;
+    for (int i = 0; i < observed.monsterCount; i++)
+    {
+        Vector2 tile = grid.worldToGrid({static_cast<float>(observed.monsterX[i]), static_cast<float>(observed.monsterY[i])});
+        int x = static_cast<int>(tile.x);
+        int y = static_cast<int>(tile.y);
+        if (!skippedSelf && x == root.dragonX && y == root.dragonY)
+        {
+            skippedSelf = true;
+            continue;
+        }
+
+        int slot = root.monsterCount++;
+        root.monsterX[slot] = x;
+        root.monsterY[slot] = y;
+        root.monsterGhost[slot] = observed.monsterGhost[i];
+        root.monsterAlive[slot] = true;
+    }
+
+    harpoonTiles = static_cast<int>(std::ceil(player.getHarpoon().getMaxRange() / tileSize));
+    fireTiles = static_cast<int>(fireRange / tileSize);
+    playerPace = player.getSpeed() / std::max(dragonSpeed, 0.1f);
+
+    nodeCount = 0;
+    newNode();
+
+    // What the searches before this one in the frame left over; may be nothing
+    double allowedUs = timeBudgetUs - frameElapsedUs;
+    int rollouts = 0;
+    for (;;)
+    {
+        runIteration();
+        rollouts++;
+
+        if (rolloutLimit > 0 && rollouts >= rolloutLimit)
+            break;
+        if (timeBudgetUs > 0 && rollouts % TIME_CHECK_INTERVAL == 0)
+        {
+            auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started);
+            if (elapsed.count() >= allowedUs)
+                break;
+        }
+    }
+
+    // The most visited first action is the most trusted one
+    LookaheadChoice choice{Direction::NONE, false};
+    int bestVisits = 0;
+    DecisionScores::begin(DecisionRecord::SCORED_BY_LOOKAHEAD);
+    for (int action = 0; action < ACTION_COUNT; action++)
+    {
+        int child = nodes[0].children[action];
+        if (child != -1 && action < WAIT)
+            DecisionScores::note(static_cast<Direction>(action), nodes[child].visits);
+        if (child == -1 || nodes[child].visits <= bestVisits)
+            continue;
+
+        bestVisits = nodes[child].visits;
+        choice.direction = action < WAIT ? static_cast<Direction>(action) : Direction::NONE;
+        choice.breatheFire = action == FIRE;
+    }
+
+    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - started).count();
+    lastRollouts = rollouts;
+    lastElapsedMs = elapsedMs;
+    frameElapsedUs += elapsedMs * 1000.0;
+    totalRollouts += rollouts;
+    totalElapsedMs += elapsedMs;
+    return choice;
+}
+
+int LookaheadSearch::getLastRollouts() const
+{
+    return lastRollouts;
+}
+
+float LookaheadSearch::getLastElapsedMs() const
+{
+    return lastElapsedMs;
+}
+
+float LookaheadSearch::getRolloutsPerMs() const
+{
+    if (totalElapsedMs <= 0.0)
+        return 0.0f;
+
+    return static_cast<float>(totalRollouts / totalElapsedMs);
+}
+
+void LookaheadSearch::runIteration()
+{
+    SimState sim = root;
+    std::copy(baseTiles.begin(), baseTiles.end(), tiles.begin());
+
+    int path[HORIZON + 1];
+    int depth = 0;
+    int node = 0;
+    path[0] = 0;
+
+    float outcome = -1.0f;
+    int steps = 0;
+
+    // Selection: follow UCB1 down the tree until an untried action turns up
+    while (steps < HORIZON && outcome < 0.0f)
+    {
+        int legal = legalActions(sim);
+        int untried = 0;
+        for (int action = 0; action < ACTION_COUNT; action++)
+        {
+            if ((legal & (1 << action)) && nodes[node].children[action] == -1)
+                untried |= 1 << action;
+        }
+
+        int chosen = -1;
+        bool expanded = false;
+        if (untried && nodeCount < MAX_NODES)
+        {
+            chosen = randomBit(untried);
+            int child = newNode();
+            nodes[node].children[chosen] = child;
+            expanded = true;
+        }
+        else
+        {
+            float logVisits = std::log(static_cast<float>(std::max(nodes[node].visits, 1)));
+            float bestScore = -1.0f;
+            for (int action = 0; action < ACTION_COUNT; action++)
+            {
+                int child = nodes[node].children[action];
+                if (!(legal & (1 << action)) || child == -1)
+                    continue;
+
+                const SearchNode &candidate = nodes[child];
+                float score = candidate.totalValue / candidate.visits +
+                              EXPLORATION * std::sqrt(logVisits / candidate.visits);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    chosen = action;
+                }
+            }
+        }
+
+        if (chosen == -1)
+            break;
+
+        outcome = step(sim, chosen);
+        steps++;
+        node = nodes[node].children[chosen];
+        path[++depth] = node;
+
+        if (expanded)
+            break;
+    }
+
+    // Rollout: a quick policy plays on to the horizon
+    while (steps < HORIZON && outcome < 0.0f)
+    {
+        outcome = step(sim, rolloutAction(sim, legalActions(sim)));
+        steps++;
+    }
+
+    if (outcome < 0.0f)
+        outcome = evaluate(sim);
+
+    for (int i = 0; i <= depth; i++)
+    {
+        nodes[path[i]].visits++;
+        nodes[path[i]].totalValue += outcome;
+    }
+}
+
+float LookaheadSearch::step(SimState &sim, int action)
+{
+    if (action == FIRE)
+        return FIRE_HIT;
+
+    if (action < WAIT)
+    {
+        sim.dragonX += STEP_X[action];
+        sim.dragonY += STEP_Y[action];
+    }
+    if (sim.fireWait > 0)
+        sim.fireWait--;
+    if (isCaught(sim))
+        return 1.0f;
+
+    moveMonsters(sim);
+    if (isCaught(sim))
+        return 1.0f;
+
+    sim.playerCredit += playerPace;
+    while (sim.playerCredit >= 1.0f)
+    {
+        sim.playerCredit -= 1.0f;
+        float outcome = playerTurn(sim);
+        if (outcome >= 0.0f)
+            return outcome;
+        if (isCaught(sim))
+            return 1.0f;
+    }
+
+    return -1.0f;
+}
+
+float LookaheadSearch::playerTurn(SimState &sim)
+{
+    // Half the time, harpoon the first monster lined up in front
+    const int facing = sim.playerFacing;
+    for (int reach = 1; reach <= harpoonTiles; reach++)
+    {
+        int x = sim.playerX + STEP_X[facing] * reach;
+        int y = sim.playerY + STEP_Y[facing] * reach;
+        if (!isTunnelTile(x, y))
+            break;
+
+        if (x == sim.dragonX && y == sim.dragonY)
+        {
+            if (nextRandom() % 2 == 0)
+                return 0.0f;
+            break;
+        }
+
+        int target = -1;
+        for (int i = 0; i < sim.monsterCount && target == -1; i++)
+        {
+            if (sim.monsterAlive[i] && sim.monsterX[i] == x && sim.monsterY[i] == y)
+                target = i;
+        }
+        if (target != -1)
+        {
+            if (nextRandom() % 2 == 0)
+            {
+                sim.monsterAlive[target] = false;
+                return -1.0f;
+            }
+            break;
+        }
+    }
+
+    // Otherwise dig on, half the time away from the nearest monster
+    int open = 0;
+    for (int d = 0; d < 4; d++)
+    {
+        if (isOpen(sim.playerX + STEP_X[d], sim.playerY + STEP_Y[d]))
+            open |= 1 << d;
+    }
+    if (!open)
+        return -1.0f;
+
+    int chosen = -1;
+    if (nextRandom() % 2 == 0)
+    {
+        int bestDistance = -1;
+        for (int d = 0; d < 4; d++)
+        {
+            if (!(open & (1 << d)))
+                continue;
+
+            int x = sim.playerX + STEP_X[d];
+            int y = sim.playerY + STEP_Y[d];
+            int nearest = manhattan(x, y, sim.dragonX, sim.dragonY);
+            for (int i = 0; i < sim.monsterCount; i++)
+            {
+                if (sim.monsterAlive[i])
+                    nearest = std::min(nearest, manhattan(x, y, sim.monsterX[i], sim.monsterY[i]));
+            }
+            if (nearest > bestDistance)
+            {
+                bestDistance = nearest;
+                chosen = d;
+            }
+        }
+    }
+    else
+    {
+        chosen = randomBit(open);
+    }
+
+    sim.playerX += STEP_X[chosen];
+    sim.playerY += STEP_Y[chosen];
+    sim.playerFacing = chosen;
+    tiles[tileIndex(sim.playerX, sim.playerY)] = TUNNEL;
+    return -1.0f;
+}
+
+void LookaheadSearch::moveMonsters(SimState &sim)
+{
+    for (int i = 0; i < sim.monsterCount; i++)
+    {
+        if (!sim.monsterAlive[i])
+            continue;
+
+        int open = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            int x = sim.monsterX[i] + STEP_X[d];
+            int y = sim.monsterY[i] + STEP_Y[d];
+            if (sim.monsterGhost[i] ? isOpen(x, y) : isTunnelTile(x, y))
+                open |= 1 << d;
+        }
+        if (!open)
+            continue;
+
+        // Mostly close in greedily, sometimes wander
+        int chosen = -1;
+        if (nextRandom() % 4 != 0)
+        {
+            int bestDistance = 0;
+            for (int d = 0; d < 4; d++)
+            {
+                if (!(open & (1 << d)))
+                    continue;
+
+                int distance = manhattan(sim.monsterX[i] + STEP_X[d], sim.monsterY[i] + STEP_Y[d], sim.playerX, sim.playerY);
+                if (chosen == -1 || distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    chosen = d;
+                }
+            }
+        }
+        else
+        {
+            chosen = randomBit(open);
+        }
+
+        sim.monsterX[i] += STEP_X[chosen];
+        sim.monsterY[i] += STEP_Y[chosen];
+    }
+}
+
+float LookaheadSearch::evaluate(const SimState &sim) const
+{
+    // Survived to the horizon: better the closer the dragon ended up
+    int distance = manhattan(sim.dragonX, sim.dragonY, sim.playerX, sim.playerY);
+    return 0.5f * (1.0f - static_cast<float>(distance) / (width + height));
+}
+
+int LookaheadSearch::legalActions(const SimState &sim) const
+{
+    int legal = 1 << WAIT;
+    for (int d = 0; d < 4; d++)
+    {
+        if (isTunnelTile(sim.dragonX + STEP_X[d], sim.dragonY + STEP_Y[d]))
+            legal |= 1 << d;
+    }
+    if (sim.fireWait == 0 && hasFireLine(sim))
+        legal |= 1 << FIRE;
+
+    return legal;
+}
+
+int LookaheadSearch::rolloutAction(const SimState &sim, int legal)
+{
+    if (legal & (1 << FIRE))
+        return FIRE;
+
+    int moves = legal & 0xF;
+    if (!moves)
+        return WAIT;
+
+    if (nextRandom() % 2 == 0)
+        return randomBit(moves);
+
+    int chosen = -1;
+    int bestDistance = 0;
+    for (int d = 0; d < 4; d++)
+    {
+        if (!(moves & (1 << d)))
+            continue;
+
+        int distance = manhattan(sim.dragonX + STEP_X[d], sim.dragonY + STEP_Y[d], sim.playerX, sim.playerY);
+        if (chosen == -1 || distance < bestDistance)
+        {
+            bestDistance = distance;
+            chosen = d;
+        }
+    }
+    return chosen;
+}
+
+bool LookaheadSearch::hasFireLine(const SimState &sim) const
+{
+    int dx = sim.playerX - sim.dragonX;
+    int dy = sim.playerY - sim.dragonY;
+    if ((dx != 0 && dy != 0) || (dx == 0 && dy == 0))
+        return false;
+
+    int length = std::abs(dx) + std::abs(dy);
+    if (length > fireTiles)
+        return false;
+
+    int stepX = (dx > 0) - (dx < 0);
+    int stepY = (dy > 0) - (dy < 0);
+    for (int i = 1; i <= length; i++)
+    {
+        if (!isTunnelTile(sim.dragonX + stepX * i, sim.dragonY + stepY * i))
+            return false;
+    }
+    return true;
+}
+
+int LookaheadSearch::newNode()
+{
+    SearchNode &node = nodes[nodeCount];
+    std::fill(node.children, node.children + ACTION_COUNT, -1);
+    node.visits = 0;
+    node.totalValue = 0.0f;
+    return nodeCount++;
+}
+
+int LookaheadSearch::tileIndex(int x, int y) const
+{
+    return (y + 1) * stride + (x + 1);
+}
+
+bool LookaheadSearch::isOpen(int x, int y) const
+{
+    return tiles[tileIndex(x, y)] != ROCK;
+}
+
+bool LookaheadSearch::isTunnelTile(int x, int y) const
+{
+    return tiles[tileIndex(x, y)] == TUNNEL;
+}
+
+bool LookaheadSearch::isCaught(const SimState &sim) const
+{
+    if (sim.dragonX == sim.playerX && sim.dragonY == sim.playerY)
+        return true;
+
+    for (int i = 0; i < sim.monsterCount; i++)
+    {
+        if (sim.monsterAlive[i] && sim.monsterX[i] == sim.playerX && sim.monsterY[i] == sim.playerY)
+            return true;
+    }
+    return false;
+}
+
+int LookaheadSearch::randomBit(int mask)
+{
+    // Scale the random word to the bit count with a multiply rather than a division
+    unsigned long long scaled = static_cast<unsigned long long>(nextRandom()) * countBits(mask);
+    return nthBit(mask, static_cast<int>(scaled >> 32));
+}
+
+unsigned int LookaheadSearch::nextRandom()
+{
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
@@ -0,0 +1,187 @@
+#ifndef LOOKAHEAD_SEARCH_H
+#define LOOKAHEAD_SEARCH_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+#include "Player.h"
+#include "MonsterStore.h"
+
+/**
+ * @brief What a lookahead search recommends
+ */
+struct LookaheadChoice
+{
+    Direction direction; ///< Step to take (NONE to hold still)
+    bool breatheFire;    ///< Breathe fire instead of moving
+};
+
+/**
+ * @brief Monte Carlo tree search over a dragon's next few moves
+ *
+ * Each rollout forks a tile-level copy of the world (tiles, player, every
+ * monster) and plays it a few seconds ahead with a stripped-down step:
+ * one dragon step per turn, the other monsters closing in, and a player
+ * who flees, digs and harpoons whatever lines up in front of them. The
+ * search tree is open-loop: it records the dragon's action sequences, and
+ * each node holds the average outcome of every rollout that passed through
+ * it. UCB1 picks which sequences to try next.
+ *
+ * The world is copied into buffers the search owns, and search nodes come
+ * from a pool sized once, so searching allocates nothing after the first
+ * call on a grid. A search stops at its rollout limit or once the frame's
+ * time budget is spent, whichever comes first. The budget is shared by all
+ * the searches between two beginFrame() calls, so several dragons thinking
+ * on one tick split it rather than each taking it whole.
+ */
+class LookaheadSearch
+{
+public:
+    static const int MAX_MONSTERS = 16;            ///< Other monsters modelled in rollouts
+    static const int HORIZON = 12;                 ///< Dragon steps simulated per rollout (about five seconds)
+    static const int MAX_NODES = 4096;             ///< Search tree nodes per search
+    static const int DEFAULT_TIME_BUDGET_US = 800; ///< Microseconds the searches of one frame may take together
+
+    /**
+     * @brief Constructor for LookaheadSearch
+     * @param seed Seed of the rollout random numbers (the game's rand() is left alone)
+     */
+    LookaheadSearch(unsigned int seed = 0x2545F491u);
+
+    /**
+     * @brief Set how long the searches of one frame may take together
+     * @param microseconds Time budget per frame, or 0 for no deadline
+     */
+    void setTimeBudget(int microseconds);
+    int getTimeBudget() const;
+
+    /**
+     * @brief Start a new frame: the next searches share a fresh time budget
+     */
+    void beginFrame();
+
+    /**
+     * @brief Get the search time spent since the last beginFrame()
+     * @return Microseconds
+     */
+    double getFrameElapsedUs() const;
+
+    /**
+     * @brief Cap the rollouts of one search, for repeatable results
+     * @param rollouts Rollouts per search, or 0 for no cap
+     */
+    void setRolloutLimit(int rollouts);
+
+    /**
+     * @brief Take the monsters the rollouts simulate, once per tick
+     * @param monsters Packed monster fields
+     */
+    void observeMonsters(const MonsterStore &monsters);
+
+    /**
+     * @brief Search for a dragon's best next action
+     *
+     * The search gets what is left of the frame's budget; once that is spent,
+     * it still runs a few rollouts so that late thinkers get a move.
+     * @param dragonPos Searching dragon's world position (it is left out of the observed monsters)
+     * @param dragonSpeed Dragon speed in pixels per frame
+     * @param fireCooldown Seconds until the dragon can breathe fire again
+     * @param fireRange Maximum fire range in pixels
+     * @param player The player
+     * @param grid Reference to the game grid
+     * @return Recommended action
+     */
+    LookaheadChoice search(Vector2 dragonPos, float dragonSpeed, float fireCooldown, float fireRange,
+                           const Player &player, const Grid &grid);
+
+    int getLastRollouts() const;
+    float getLastElapsedMs() const;
+
+    /**
+     * @brief Get the average throughput of every search so far
+     * @return Rollouts per millisecond of search time
+     */
+    float getRolloutsPerMs() const;
+
+private:
+    // Dragon actions, indexed like Direction for the four steps
+    static const int WAIT = 4;
+    static const int FIRE = 5;
+    static const int ACTION_COUNT = 6;
+
+    /**
+     * @brief Everything a rollout changes, apart from the tiles
+     */
+    struct SimState
+    {
+        int playerX, playerY;            ///< Player tile
+        int playerFacing;                ///< Direction index the player faces
+        float playerCredit;              ///< Player steps owed, gained at playerPace per dragon step
+        int dragonX, dragonY;            ///< Searching dragon's tile
+        int fireWait;                    ///< Dragon steps until fire is ready
+        int monsterCount;                ///< Other monsters in use
+        int monsterX[MAX_MONSTERS];      ///< Monster tile columns (world pixels in observed)
+        int monsterY[MAX_MONSTERS];      ///< Monster tile rows (world pixels in observed)
+        bool monsterGhost[MAX_MONSTERS]; ///< Disembodied: passes through earth
+        bool monsterAlive[MAX_MONSTERS]; ///< Not yet harpooned
+    };
+
+    /**
+     * @brief Statistics of one dragon action sequence
+     */
+    struct SearchNode
+    {
+        int children[ACTION_COUNT]; ///< Node index per action, or -1 while untried
+        int visits;                 ///< Rollouts through this node
+        float totalValue;           ///< Sum of their outcomes
+    };
+
+    int width;                            ///< Grid width the tiles were copied from
+    int height;                           ///< Grid height the tiles were copied from
+    int stride;                           ///< Row length of the tile copies (grid width plus a rock border)
+    unsigned int tilesVersion;            ///< Grid version the tiles were copied from
+    std::vector<unsigned char> baseTiles; ///< Tiles of the real grid, ringed by rock so steps need no bounds checks
+    std::vector<unsigned char> tiles;     ///< Tiles of the rollout in progress
+    SimState root;                        ///< World the search starts from
+    SimState observed;                    ///< Monsters taken by observeMonsters()
+    std::vector<SearchNode> nodes;        ///< Search tree pool
+    int nodeCount;                        ///< Nodes in use
+    int harpoonTiles;                     ///< Harpoon reach in tiles
+    int fireTiles;                        ///< Fire reach in tiles
+    float playerPace;                     ///< Player steps per dragon step
+    unsigned int rng;                     ///< Rollout random state
+    int timeBudgetUs;                     ///< Microseconds per frame, 0 for no deadline
+    double frameElapsedUs;                ///< Search time since the last beginFrame()
+    int rolloutLimit;                     ///< Rollouts per search, 0 for no cap
+    int lastRollouts;                     ///< Rollouts of the last search
+    float lastElapsedMs;                  ///< Duration of the last search
+    long long totalRollouts;              ///< Rollouts of every search
+    double totalElapsedMs;                ///< Duration of every search
+
+    // Select down the tree, expand one node, roll out to the horizon and back the outcome up
+    void runIteration();
+    // Advance the world one dragon step; returns the outcome if the rollout ended, or -1
+    // Outcomes run from 0 (dragon harpooned) to 1 (player caught)
+    float step(SimState &sim, int action);
+    float playerTurn(SimState &sim);
+    void moveMonsters(SimState &sim);
+    float evaluate(const SimState &sim) const;
+
+    // Bit per legal dragon action
+    int legalActions(const SimState &sim) const;
+    int rolloutAction(const SimState &sim, int legal);
+    bool hasFireLine(const SimState &sim) const;
+
+    int newNode();
+    // Index into the bordered tile copies; x and y may be one tile off the grid
+    int tileIndex(int x, int y) const;
+    bool isOpen(int x, int y) const;
+    bool isTunnelTile(int x, int y) const;
+    bool isCaught(const SimState &sim) const;
+    // Index of a random set bit of a non-zero mask
+    int randomBit(int mask);
+    unsigned int nextRandom();
+};
+
+#endif // LOOKAHEAD_SEARCH_H
@@ -1,14 +1,41 @@
 #include "Monster.h"
 #include "PathFinding.h"
+#include "PathRequestQueue.h"
+#include "TacticalAI.h"
+#include "BehaviorLibrary.h"
+#include "PerceptionBlackboard.h"
+#include "DisembodimentScheduler.h"
+#include "ScriptScheduler.h"
+#include "TimerWheel.h"
 #include <cmath>
 #include <algorithm>
 
 Monster::Monster(Vector2 startPos, MonsterState state)
     : GameObject(startPos, {28, 28}),
+      kind(MonsterKind::BASIC),
       currentState(state),
-      stateTimer(0.0f),
-      aiUpdateTimer(0.0f),
-      lastDirection(Direction::NONE)
+      timers(nullptr),
+      ownClock(0.0),
+      stateSince(0.0),
+      thinkSince(0.0),
+      aiUpdateInterval(0.3f),
+      lastDirection(Direction::NONE),
+      pathQueue(nullptr),
+      routeTicket(-1),
+      routedStep(Direction::NONE),
+      routeAnswered(false),
+      routeStart(startPos),
+      routeTarget(startPos),
+      replanIncrementally(false),
+      ambushesChokepoints(false),
+      behaviorState(BehaviorTree::initialState()),
+      blackboard(nullptr),
+      ghostSlots(nullptr),
+      storeSlot(-1),
+      intent(nullptr),
+      scriptStart(nullptr),
+      scriptClock(nullptr),
+      scriptContext(nullptr)
 {
     speed = 1.5f; // Monster default speed
 }
@@ -16,8 +43,10 @@ Monster::Monster(Vector2 startPos, MonsterState state)
 void Monster::update()
 {
     updateMovement(); // Inherited from GameObject
-    updateStateTimer();
-    aiUpdateTimer += GetFrameTime();
+
+    // On a wheel, the timers are read off its clock and cost nothing here
+    if (!timers)
+        ownClock += GetFrameTime();
 }
 
 void Monster::draw()
@@ -48,71 +77,52 @@ void Monster::draw()
     }
 }
 
-void Monster::updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                       std::function<void()> notifyDisembodied)
+void Monster::updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied)
 {
     if (currentState == MonsterState::DEAD)
         return;
 
-    if (aiUpdateTimer < 0.3f)
+    if (getThinkTimer() < aiUpdateInterval)
         return;
 
-    aiUpdateTimer = 0.0f;
+    setThinkTimer(0.0f);
 
-    float distanceToPlayer = calculateDistanceToPlayer(player);
-    bool playerInSameTunnel = isPlayerInSameTunnel(player, grid);
+    runBehavior(player, grid, canBecomeDisembodied);
+}
 
-    if (currentState == MonsterState::IN_TUNNEL)
-    {
-        if (stateTimer < 2.0f && !playerInSameTunnel)
-            return;
+void Monster::decide(const Player &player, Grid &grid, MonsterIntent &decision)
+{
+    intent = &decision;
+    updateAI(player, grid);
+    intent = nullptr;
+}
 
-        if (distanceToPlayer < 96.0f)
-        {
-            if (!isMoving)
-            {
-                Direction moveDirection = findBestDirectionToPlayer(player, grid);
-                if (moveDirection != Direction::NONE)
-                {
-                    move(moveDirection, grid);
-                }
-            }
-        }
-        else if (canBecomeDisembodied && shouldBecomeDisembodied(player, grid))
-        {
-            setState(MonsterState::DISEMBODIED);
-            stateTimer = 0.0f;
-            if (notifyDisembodied)
-                notifyDisembodied();
-        }
-        else if (!isMoving && (rand() % 3 == 0))
-        {
-            Direction moveDirection = findBestDirectionToPlayer(player, grid);
-            if (moveDirection == Direction::NONE)
-                moveDirection = findRandomValidDirection(grid);
-            if (moveDirection != Direction::NONE)
-                move(moveDirection, grid);
-        }
-    }
-    else if (currentState == MonsterState::DISEMBODIED)
-    {
-        if (stateTimer > 4.0f)
-        {
-            Vector2 gridPos = grid.worldToGrid(position);
-            if (grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y)))
-            {
-                setState(MonsterState::IN_TUNNEL);
-                stateTimer = 0.0f;
-            }
-        }
+void Monster::applyIntent(const MonsterIntent &decision, const Player &, Grid &grid)
+{
+    if (decision.resumedScript)
+        parkScript();
+
+    if (decision.asksForGhostSlot && ghostSlots)
+        ghostSlots->askForSlot(storeSlot);
 
-        if (!isMoving)
+    // Only in-tunnel chases ask for routes
+    if (decision.postsRoute && pathQueue && routeTicket == -1)
+        routeTicket = pathQueue->postRequest(routeStart, routeTarget, MonsterState::IN_TUNNEL, grid);
+
+    if (decision.changesState && ghostSlots)
+    {
+        if (currentState == MonsterState::DISEMBODIED && !ghostSlots->acquire(storeSlot))
         {
-            Direction moveDirection = findBestDirectionToPlayer(player, grid);
-            if (moveDirection != Direction::NONE)
-                move(moveDirection, grid);
+            // A monster earlier in the order took the lease: the change, and the ghost step after it, never happened
+            setState(decision.previousState);
+            setStateTimer(getStateTimer() + decision.previousStateTimer);
+            return;
         }
+        if (currentState == MonsterState::IN_TUNNEL)
+            ghostSlots->release(storeSlot);
     }
+
+    move(decision.move, grid);
 }
 
 bool Monster::canMoveTo(Vector2 newPos, const Grid &grid) const
@@ -142,11 +152,42 @@ bool Monster::canMoveTo(Vector2 newPos, const Grid &grid) const
     }
 }
 
+bool Monster::move(Direction direction, Grid &grid)
+{
+    if (intent)
+    {
+        // Only the first step of a think counts, as once the monster is moving
+        Vector2 newPos;
+        if (direction == Direction::NONE || isMoving || intent->move != Direction::NONE ||
+            !stepPosition(direction, grid, newPos) || !canMoveTo(newPos, grid))
+            return false;
+
+        intent->move = direction;
+        return true;
+    }
+
+    if (!GameObject::move(direction, grid))
+        return false;
+
+    lastDirection = direction;
+    return true;
+}
+
+MonsterKind Monster::getKind() const
+{
+    return kind;
+}
+
 MonsterState Monster::getState() const
 {
     return currentState;
 }
 
+float Monster::getStateTimer() const
+{
+    return static_cast<float>(clockTime() - stateSince);
+}
+
 void Monster::setState(MonsterState newState)
 {
     currentState = newState;
@@ -158,10 +199,20 @@ void Monster::reset(Vector2 startPos, MonsterState state)
     targetPosition = startPos;
     currentState = state;
     isMoving = false;
-    stateTimer = 0.0f;
-    aiUpdateTimer = 0.0f;
+    setStateTimer(0.0f);
+    setThinkTimer(0.0f);
     lastDirection = Direction::NONE;
     active = true;
+    cancelRoute();
+    replanner.reset();
+    behaviorState = BehaviorTree::initialState();
+
+    if (scriptStart)
+    {
+        if (scriptClock)
+            scriptClock->wake(storeSlot);
+        script = scriptStart(ScriptAgent(this));
+    }
 }
 
 bool Monster::isDead() const
@@ -169,9 +220,503 @@ bool Monster::isDead() const
     return currentState == MonsterState::DEAD;
 }
 
-void Monster::updateStateTimer()
+bool Monster::isThinkDue() const
+{
+    return active && !isDead() && !isMoving && getThinkTimer() >= aiUpdateInterval && !isScriptWaiting();
+}
+
+bool Monster::isDecisionDue(float intervalStretch) const
+{
+    return active && !isDead() && getThinkTimer() >= aiUpdateInterval * intervalStretch && !isScriptWaiting();
+}
+
+void Monster::setPathRequestQueue(PathRequestQueue *queue)
+{
+    cancelRoute();
+    pathQueue = queue;
+}
+
+void Monster::setIncrementalReplanning(bool enabled)
+{
+    replanIncrementally = enabled;
+    replanner.reset();
+}
+
+bool Monster::plansRoutes() const
+{
+    return currentState == MonsterState::IN_TUNNEL && (replanIncrementally || pathQueue != nullptr);
+}
+
+bool Monster::isAwaitingRoute() const
+{
+    return routeTicket != -1 || routeAnswered || (intent && intent->postsRoute);
+}
+
+void Monster::resumeRoute(Grid &grid)
+{
+    if (routeTicket == -1 && !routeAnswered)
+        return;
+
+    if (isDead())
+    {
+        cancelRoute();
+        return;
+    }
+
+    if (routeTicket != -1)
+    {
+        if (!pathQueue->pollResult(routeTicket, routedStep))
+        {
+            // Dropped because the grid changed; the next think asks again
+            if (!pathQueue->isPending(routeTicket))
+                routeTicket = -1;
+            return;
+        }
+        routeTicket = -1;
+        routeAnswered = true;
+    }
+
+    // Kept until the monster finishes the step onto the tile it asked from
+    if (isMoving && currentState == MonsterState::IN_TUNNEL &&
+        targetPosition.x == routeStart.x && targetPosition.y == routeStart.y)
+        return;
+    routeAnswered = false;
+
+    // Anywhere else the answer is for the wrong tile; the next think asks again from there
+    if (isMoving || currentState != MonsterState::IN_TUNNEL ||
+        position.x != routeStart.x || position.y != routeStart.y)
+        return;
+
+    Direction routed = routedStep;
+    if (routed == Direction::NONE)
+    {
+        auto canMoveFunc = [this, &grid](Vector2 pos)
+        { return canMoveTo(pos, grid); };
+        routed = PathFinding::findBestDirectionCached(position, routeTarget, grid, currentState, canMoveFunc);
+    }
+
+    move(routed, grid);
+}
+
+bool Monster::isCommittedToCorridor(Vector2 targetPos, const Grid &grid) const
+{
+    return corridorContinuation(targetPos, grid) != Direction::NONE;
+}
+
+void Monster::setChokepointAmbush(bool enabled)
 {
-    stateTimer += GetFrameTime();
+    ambushesChokepoints = enabled;
+}
+
+void Monster::setBlackboard(const PerceptionBlackboard *board, int slot)
+{
+    blackboard = board;
+    storeSlot = slot;
+}
+
+void Monster::setDisembodimentScheduler(DisembodimentScheduler *scheduler)
+{
+    ghostSlots = scheduler;
+}
+
+void Monster::setBehaviorScript(BehaviorScript start, ScriptScheduler *scheduler)
+{
+    if (scriptClock)
+        scriptClock->wake(storeSlot);
+
+    scriptStart = start;
+    scriptClock = scheduler;
+    script = start ? start(ScriptAgent(this)) : BehaviorTask();
+}
+
+bool Monster::runsScript() const
+{
+    return !script.isDone();
+}
+
+bool Monster::canStepCoarsely() const
+{
+    return active && !isDead() && !isMoving;
+}
+
+bool Monster::stepCoarse(Vector2 targetPos, const Grid &grid)
+{
+    // A route asked for from the per-pixel simulation would be stale by the time it came back
+    cancelRoute();
+
+    Direction hop = Direction::NONE;
+    if (currentState == MonsterState::IN_TUNNEL)
+    {
+        Vector2 from = grid.worldToGrid(position);
+        Vector2 to = grid.worldToGrid(targetPos);
+        hop = PathFinding::getTunnelDistances(grid).getNextHop(
+            static_cast<int>(from.x), static_cast<int>(from.y),
+            static_cast<int>(to.x), static_cast<int>(to.y));
+    }
+    else if (currentState == MonsterState::DISEMBODIED)
+    {
+        hop = TacticalAI::calculateFacingDirection(position, targetPos);
+    }
+
+    Vector2 next;
+    if (!stepPosition(hop, grid, next) || !canMoveTo(next, grid))
+        return false;
+
+    position = next;
+    targetPosition = next;
+    lastDirection = hop;
+    return true;
+}
+
+void Monster::setTimerWheel(TimerWheel *wheel)
+{
+    if (wheel == timers)
+        return;
+
+    // Carry the timers over to the new clock
+    float inState = getStateTimer();
+    float sinceThink = getThinkTimer();
+    timers = wheel;
+    setStateTimer(inState);
+    setThinkTimer(sinceThink);
+}
+
+Direction Monster::chooseChaseDirection(Vector2 targetPos, const Grid &grid)
+{
+    auto canMoveFunc = [this, &grid](Vector2 pos)
+    { return canMoveTo(pos, grid); };
+
+    // Targets on the tunnel network are answered from the all-pairs table
+    if (currentState == MonsterState::IN_TUNNEL)
+    {
+        Direction step = PathFinding::findTunnelRouteDirection(position, targetPos, grid);
+        if (step != Direction::NONE)
+            return step;
+    }
+
+    if (currentState == MonsterState::IN_TUNNEL && replanIncrementally)
+    {
+        Direction step = replanner.nextStep(position, targetPos, grid, currentState);
+        if (step != Direction::NONE)
+            return step;
+
+        // No route: fall back to closing the distance greedily
+        return PathFinding::findBestDirectionCached(position, targetPos, grid, currentState, canMoveFunc);
+    }
+
+    if (currentState == MonsterState::IN_TUNNEL && pathQueue)
+    {
+        // Keep the current heading until the worker answers; resumeRoute() takes the routed step
+        Vector2 ahead;
+        Direction heading = lastDirection;
+        if (heading == Direction::NONE || !stepPosition(heading, grid, ahead) || !canMoveTo(ahead, grid))
+            heading = PathFinding::findBestDirectionCached(position, targetPos, grid, currentState, canMoveFunc);
+
+        if (!isAwaitingRoute())
+        {
+            // Asked from the tile this step ends on, where the answer gets used
+            routeStart = position;
+            if (isMoving)
+                routeStart = targetPosition;
+            else if (heading != Direction::NONE)
+                stepPosition(heading, grid, routeStart);
+            routeTarget = targetPos;
+            if (intent)
+                intent->postsRoute = true; // Posted by applyIntent()
+            else
+                routeTicket = pathQueue->postRequest(routeStart, targetPos, currentState, grid);
+        }
+        return heading;
+    }
+
+    return PathFinding::findBestDirectionCached(position, targetPos, grid, currentState, canMoveFunc);
+}
+
+void Monster::cancelRoute()
+{
+    if (pathQueue && routeTicket != -1)
+        pathQueue->cancel(routeTicket);
+    routeTicket = -1;
+    routeAnswered = false;
+}
+
+Direction Monster::corridorContinuation(Vector2 targetPos, const Grid &grid) const
+{
+    if (currentState != MonsterState::IN_TUNNEL || isMoving || lastDirection == Direction::NONE)
+        return Direction::NONE;
+
+    Vector2 gridPos = grid.worldToGrid(position);
+    int x = static_cast<int>(gridPos.x);
+    int y = static_cast<int>(gridPos.y);
+
+    const TunnelGraph &graph = PathFinding::getTunnelGraph(grid);
+    int corridor = graph.getCorridorId(x, y);
+    if (corridor == -1)
+        return Direction::NONE;
+
+    // A target on this corridor or at either end of it may lie behind us
+    Vector2 targetGridPos = grid.worldToGrid(targetPos);
+    int targetX = static_cast<int>(targetGridPos.x);
+    int targetY = static_cast<int>(targetGridPos.y);
+    int nodeA, nodeB;
+    graph.getCorridorEnds(corridor, nodeA, nodeB);
+    int targetNode = graph.getNodeId(targetX, targetY);
+    if (graph.getCorridorId(targetX, targetY) == corridor ||
+        (targetNode != -1 && (targetNode == nodeA || targetNode == nodeB)))
+        return Direction::NONE;
+
+    return graph.continueCorridor(x, y, lastDirection);
+}
+
+bool Monster::takeAmbushPosition(const Player &player, Grid &grid)
+{
+    if (currentState != MonsterState::IN_TUNNEL)
+        return false;
+
+    Vector2 playerPos = player.getPosition();
+    if (TacticalAI::isAmbushPosition(position, playerPos, grid, AMBUSH_RANGE))
+        return true;
+
+    auto canMoveFunc = [this, &grid](Vector2 pos)
+    { return canMoveTo(pos, grid); };
+    Direction ambushDirection = TacticalAI::findAmbushDirection(position, playerPos, grid, canMoveFunc, AMBUSH_RANGE);
+    if (ambushDirection == Direction::NONE)
+        return false;
+
+    move(ambushDirection, grid);
+    return true;
+}
+
+void Monster::runBehavior(const Player &player, Grid &grid, bool canBecomeDisembodied)
+{
+    struct Agent
+    {
+        Monster &monster;
+        const BehaviorContext &context;
+
+        bool checkCondition(BehaviorCondition condition, float value)
+        {
+            return monster.checkBehaviorCondition(condition, value, context);
+        }
+
+        BehaviorStatus runAction(BehaviorAction action)
+        {
+            return monster.runBehaviorAction(action, context);
+        }
+
+        int random()
+        {
+            return monster.random();
+        }
+    };
+
+#if MONSTER_DECISION_TRACE
+    bool wasMoving = isMoving;
+    DecisionRecord decision{};
+    DecisionScores::Scope scores(&decision);
+    DecisionScores::begin(DecisionRecord::SCORED_BY_NONE);
+#endif
+
+    BehaviorContext context{player, grid, canBecomeDisembodied};
+    if (runsScript())
+    {
+        resumeScript(context);
+    }
+    else
+    {
+        Agent agent{*this, context};
+        BehaviorLibrary::getShared().getTree(kind).tick(behaviorState, agent);
+    }
+
+#if MONSTER_DECISION_TRACE
+    traceDecision(decision, wasMoving);
+#endif
+}
+
+void Monster::resumeScript(const BehaviorContext &context)
+{
+    if (isScriptWaiting())
+        return;
+
+    scriptContext = &context;
+    script.resume();
+    scriptContext = nullptr;
+
+    // Sleeping changes the shared scheduler, so while deciding that waits for applyIntent()
+    if (intent)
+        intent->resumedScript = true;
+    else
+        parkScript();
+}
+
+void Monster::parkScript()
+{
+    if (scriptClock && runsScript() && script.getWait() == ScriptWait::TIME)
+        scriptClock->sleep(storeSlot, script.getSleepSeconds());
+}
+
+bool Monster::isScriptWaiting() const
+{
+    if (!runsScript())
+        return false;
+
+    return (script.getWait() == ScriptWait::TILE && isMoving) ||
+           (scriptClock && scriptClock->isAsleep(storeSlot));
+}
+
+bool Monster::checkBehaviorCondition(BehaviorCondition condition, float value, const BehaviorContext &context)
+{
+    switch (condition)
+    {
+    case BehaviorCondition::IN_TUNNEL:
+        return currentState == MonsterState::IN_TUNNEL;
+    case BehaviorCondition::DISEMBODIED:
+        return currentState == MonsterState::DISEMBODIED;
+    case BehaviorCondition::IDLE:
+        return !isMoving && !(intent && intent->move != Direction::NONE);
+    case BehaviorCondition::AWAITING_ROUTE:
+        return isAwaitingRoute();
+    case BehaviorCondition::PLAYER_CLOSER_THAN:
+        return calculateDistanceToPlayer(context.player) < value;
+    case BehaviorCondition::PLAYER_WITHIN:
+        return calculateDistanceToPlayer(context.player) <= value;
+    case BehaviorCondition::PLAYER_BEYOND:
+        return calculateDistanceToPlayer(context.player) > value;
+    case BehaviorCondition::PLAYER_IN_SAME_TUNNEL:
+        return isPlayerInSameTunnel(context.player, context.grid);
+    case BehaviorCondition::STATE_TIME_ABOVE:
+        return getStateTimer() > value;
+    case BehaviorCondition::STATE_TIME_BELOW:
+        return getStateTimer() < value;
+    case BehaviorCondition::OVER_TUNNEL:
+    {
+        Vector2 gridPos = context.grid.worldToGrid(position);
+        return context.grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    }
+    case BehaviorCondition::MAY_DISEMBODY:
+        if (!ghostSlots)
+            return context.canBecomeDisembodied;
+        if (!intent)
+            return ghostSlots->askForSlot(storeSlot);
+        // Joining the queue changes it, so that waits for applyIntent()
+        if (ghostSlots->wouldGrant(storeSlot))
+            return true;
+        intent->asksForGhostSlot = true;
+        return false;
+    case BehaviorCondition::WANTS_TO_DISEMBODY:
+        return shouldBecomeDisembodied(context.player, context.grid);
+    case BehaviorCondition::AMBUSHES_CHOKEPOINTS:
+        return ambushesChokepoints;
+    case BehaviorCondition::PLAYER_FACING_ME:
+        return hasFreshPerception(context.player) && blackboard->isFacedByPlayer(storeSlot);
+    case BehaviorCondition::PLAYER_APPROACHING:
+        return hasFreshPerception(context.player) && blackboard->isPlayerApproaching(storeSlot);
+    case BehaviorCondition::HARPOON_OUT:
+        return hasFreshPerception(context.player) ? blackboard->isHarpoonOut()
+                                                  : context.player.getHarpoon().isHarpoonActive();
+    default:
+        return false; // Not something a plain monster can do
+    }
+}
+
+BehaviorStatus Monster::runBehaviorAction(BehaviorAction action, const BehaviorContext &context)
+{
+    Grid &grid = context.grid;
+    Vector2 playerPos = context.player.getPosition();
+    Vector2 targetPos = chaseTarget(context.player);
+
+    switch (action)
+    {
+    case BehaviorAction::FOLLOW_CORRIDOR:
+    {
+        Direction onward = corridorContinuation(targetPos, grid);
+        if (onward == Direction::NONE)
+            return BehaviorStatus::FAILURE;
+        move(onward, grid);
+        return BehaviorStatus::SUCCESS;
+    }
+
+    case BehaviorAction::CHASE_PLAYER:
+        return stepOrWait(chooseChaseDirection(targetPos, grid), grid);
+
+    case BehaviorAction::WANDER:
+    {
+        Direction moveDirection = chooseChaseDirection(targetPos, grid);
+        if (moveDirection == Direction::NONE && !isAwaitingRoute())
+            moveDirection = findRandomValidDirection(grid);
+        return stepOrWait(moveDirection, grid);
+    }
+
+    case BehaviorAction::RANDOM_STEP:
+    {
+        Direction moveDirection = findRandomValidDirection(grid);
+        if (moveDirection == Direction::NONE)
+            return BehaviorStatus::FAILURE;
+        move(moveDirection, grid);
+        return BehaviorStatus::SUCCESS;
+    }
+
+    case BehaviorAction::HOME_IN_ON_PLAYER:
+    {
+        auto canMoveFunc = [this, &grid](Vector2 pos)
+        { return canMoveTo(pos, grid); };
+        Direction moveDirection = PathFinding::findBestDirectionCached(position, playerPos, grid, currentState, canMoveFunc);
+        if (moveDirection == Direction::NONE)
+            return BehaviorStatus::FAILURE;
+        move(moveDirection, grid);
+        return BehaviorStatus::SUCCESS;
+    }
+
+    case BehaviorAction::TAKE_AMBUSH_POSITION:
+        return takeAmbushPosition(context.player, grid) ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
+
+    case BehaviorAction::BECOME_DISEMBODIED:
+        // While deciding the lease is taken by applyIntent(), which undoes the change if it is gone
+        if (!intent && ghostSlots && !ghostSlots->acquire(storeSlot))
+            return BehaviorStatus::FAILURE;
+        enterState(MonsterState::DISEMBODIED);
+        return BehaviorStatus::SUCCESS;
+
+    case BehaviorAction::RESURFACE:
+        if (!intent && ghostSlots)
+            ghostSlots->release(storeSlot);
+        enterState(MonsterState::IN_TUNNEL);
+        return BehaviorStatus::SUCCESS;
+
+    default:
+        return BehaviorStatus::FAILURE; // Not something a plain monster can do
+    }
+}
+
+BehaviorStatus Monster::stepOrWait(Direction direction, Grid &grid)
+{
+    if (direction != Direction::NONE)
+    {
+        move(direction, grid);
+        return BehaviorStatus::SUCCESS;
+    }
+
+    return isAwaitingRoute() ? BehaviorStatus::RUNNING : BehaviorStatus::FAILURE;
+}
+
+double Monster::clockTime() const
+{
+    return timers ? timers->getTime() : ownClock;
+}
+
+float Monster::getThinkTimer() const
+{
+    return static_cast<float>(clockTime() - thinkSince);
+}
+
+void Monster::setStateTimer(float seconds)
+{
+    stateSince = clockTime() - seconds;
+}
+
+void Monster::setThinkTimer(float seconds)
+{
+    thinkSince = clockTime() - seconds;
 }
 
 bool Monster::shouldBecomeDisembodied(const Player &player, const Grid &grid)
@@ -179,7 +724,7 @@ bool Monster::shouldBecomeDisembodied(const Player &player, const Grid &grid)
     if (currentState != MonsterState::IN_TUNNEL)
         return false;
 
-    if (stateTimer < 3.0f)
+    if (getStateTimer() < 3.0f)
         return false;
 
     float distance = calculateDistanceToPlayer(player);
@@ -188,13 +733,34 @@ bool Monster::shouldBecomeDisembodied(const Player &player, const Grid &grid)
         return false;
 
     if (!isPlayerInSameTunnel(player, grid) && distance > 128.0f)
-        return (rand() % 4 == 0);
+        return (random() % 4 == 0);
 
     return false;
 }
 
+int Monster::random()
+{
+    return intent ? intent->nextRandom() : rand();
+}
+
+void Monster::enterState(MonsterState newState)
+{
+    if (intent && !intent->changesState)
+    {
+        intent->changesState = true;
+        intent->previousState = currentState;
+        intent->previousStateTimer = getStateTimer();
+    }
+
+    setState(newState);
+    setStateTimer(0.0f);
+}
+
 float Monster::calculateDistanceToPlayer(const Player &player) const
 {
+    if (hasFreshPerception(player))
+        return blackboard->getDistanceToPlayer(storeSlot);
+
     Vector2 playerPos = player.getPosition();
     float dx = playerPos.x - position.x;
     float dy = playerPos.y - position.y;
@@ -203,6 +769,9 @@ float Monster::calculateDistanceToPlayer(const Player &player) const
 
 bool Monster::isPlayerInSameTunnel(const Player &player, const Grid &grid) const
 {
+    if (hasFreshPerception(player))
+        return blackboard->isInPlayerLine(storeSlot);
+
     Vector2 playerGridPos = grid.worldToGrid(player.getPosition());
     Vector2 monsterGridPos = grid.worldToGrid(position);
 
@@ -210,13 +779,17 @@ bool Monster::isPlayerInSameTunnel(const Player &player, const Grid &grid) const
            (static_cast<int>(playerGridPos.y) == static_cast<int>(monsterGridPos.y));
 }
 
-Direction Monster::findBestDirectionToPlayer(const Player &player, const Grid &grid)
+bool Monster::hasFreshPerception(const Player &player) const
 {
-    auto canMoveFunc = [this, &grid](Vector2 pos)
-    { return canMoveTo(pos, grid); };
+    return blackboard && blackboard->describes(storeSlot, position, player.getPosition());
+}
+
+Vector2 Monster::chaseTarget(const Player &player) const
+{
+    if (hasFreshPerception(player) && blackboard->hasSquadTarget(storeSlot))
+        return blackboard->getSquadTarget(storeSlot);
 
-    return PathFinding::findBestDirectionToTarget(
-        position, player.getPosition(), grid, canMoveFunc);
+    return player.getPosition();
 }
 
 Direction Monster::findRandomValidDirection(const Grid &grid)
@@ -224,5 +797,54 @@ Direction Monster::findRandomValidDirection(const Grid &grid)
     auto canMoveFunc = [this, &grid](Vector2 pos)
     { return canMoveTo(pos, grid); };
 
-    return PathFinding::findRandomValidDirection(position, grid, canMoveFunc);
-}
\ No newline at end of file
+    if (!intent)
+        return PathFinding::findRandomValidDirection(position, grid, canMoveFunc);
+
+    // PathFinding's generator is shared, so a decision draws from its own stream
+    return PathFinding::findRandomValidDirection(position, grid, canMoveFunc,
+                                                 [this](int count)
+                                                 { return random() % count; });
+}
+
+int MonsterIntent::nextRandom()
+{
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return static_cast<int>(randomState >> 1);
+}
+
+#if MONSTER_DECISION_TRACE
+const DecisionTrace &Monster::getDecisionTrace() const
+{
+    return decisionTrace;
+}
+
+void Monster::traceDecision(DecisionRecord &decision, bool wasMoving)
+{
+    // The scores are already in: the scorers of the think wrote them as they ran
+    decision.tick = static_cast<std::uint32_t>(clockTime() / TimerWheel::TICK_SECONDS);
+    decision.state = static_cast<std::uint8_t>(currentState);
+
+    Direction chosen = Direction::NONE;
+    if (intent)
+        chosen = intent->move;
+    else if (isMoving && !wasMoving)
+        chosen = lastDirection;
+    decision.chosen = static_cast<std::uint8_t>(chosen);
+
+    if (intent && intent->breathesFire)
+        decision.flags |= DecisionRecord::BREATHES_FIRE;
+    if (intent && intent->searchesAhead)
+        decision.flags |= DecisionRecord::SEARCHES_AHEAD;
+    if (intent && intent->changesState)
+        decision.flags |= DecisionRecord::CHANGES_STATE;
+    if (isAwaitingRoute())
+        decision.flags |= DecisionRecord::AWAITS_ROUTE;
+    if (runsScript())
+        decision.flags |= DecisionRecord::RAN_SCRIPT;
+
+    decisionTrace.record(decision);
+}
+#endif
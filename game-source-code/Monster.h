@@ -5,8 +5,36 @@
 #include "GameEnums.h"
 #include "Grid.h"
 #include "Player.h"
+#include "DStarLite.h"
+#include "BehaviorTree.h"
+#include "BehaviorScript.h"
+#include "DecisionTrace.h"
 #include <raylib-cpp.hpp>
-#include <functional>
+
+class PathRequestQueue;
+class PerceptionBlackboard;
+class DisembodimentScheduler;
+class ScriptScheduler;
+class TimerWheel;
+
+/**
+ * @brief What one monster decided on a think, applied after every monster has decided
+ */
+struct MonsterIntent
+{
+    Direction move = Direction::NONE;
+    bool changesState = false;
+    MonsterState previousState = MonsterState::IN_TUNNEL;
+    float previousStateTimer = 0.0f;
+    bool asksForGhostSlot = false;
+    bool postsRoute = false;
+    bool breathesFire = false;
+    bool searchesAhead = false;
+    bool resumedScript = false;
+    unsigned int randomState = 1; // Non-zero
+
+    int nextRandom();
+};
 
 /**
  * @brief Monster class for Dig Dug enemies
@@ -19,31 +47,119 @@ public:
     void update() override;
     void draw() override;
 
-    void updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                  std::function<void()> notifyDisembodied = nullptr);
+    virtual void updateAI(const Player &player, Grid &grid, bool canBecomeDisembodied = false);
+    // Decide without touching shared state; safe alongside other monsters
+    void decide(const Player &player, Grid &grid, MonsterIntent &decision);
+    virtual void applyIntent(const MonsterIntent &decision, const Player &player, Grid &grid);
 
     // Override canMoveTo for monster-specific movement rules
     bool canMoveTo(Vector2 newPos, const Grid &grid) const override;
+    bool move(Direction direction, Grid &grid) override;
 
+    MonsterKind getKind() const;
     MonsterState getState() const;
+    float getStateTimer() const;
     void setState(MonsterState newState);
     void reset(Vector2 startPos, MonsterState state = MonsterState::IN_TUNNEL);
     bool isDead() const;
+    bool isThinkDue() const;
+    bool isDecisionDue(float intervalStretch = 1.0f) const;
+
+    // Route planning
+    void setPathRequestQueue(PathRequestQueue *queue);
+    void setIncrementalReplanning(bool enabled);
+    bool plansRoutes() const;
+    bool isAwaitingRoute() const;
+    void resumeRoute(Grid &grid);
+    bool isCommittedToCorridor(Vector2 targetPos, const Grid &grid) const;
+    void setChokepointAmbush(bool enabled);
+
+    // Shared services, not owned
+    void setBlackboard(const PerceptionBlackboard *board, int slot);
+    void setDisembodimentScheduler(DisembodimentScheduler *scheduler);
+    void setBehaviorScript(BehaviorScript script, ScriptScheduler *scheduler);
+    virtual void setTimerWheel(TimerWheel *wheel);
+
+    Vector2 chaseTarget(const Player &player) const;
+    bool runsScript() const;
+    bool canStepCoarsely() const;
+    bool stepCoarse(Vector2 targetPos, const Grid &grid);
+#if MONSTER_DECISION_TRACE
+    const DecisionTrace &getDecisionTrace() const;
+#endif
 
 protected:
+    MonsterKind kind;
     MonsterState currentState;
-    float stateTimer;
-    float aiUpdateTimer;
+    TimerWheel *timers;
+    double ownClock;
+    double stateSince;
+    double thinkSince;
+    float aiUpdateInterval;
     Direction lastDirection;
+    PathRequestQueue *pathQueue;
+    int routeTicket; // -1 when none is out
+    Direction routedStep;
+    bool routeAnswered;
+    Vector2 routeStart;
+    Vector2 routeTarget;
+    DStarLite replanner;
+    bool replanIncrementally;
+    bool ambushesChokepoints;
+    BehaviorState behaviorState;
+    const PerceptionBlackboard *blackboard;
+    DisembodimentScheduler *ghostSlots;
+    int storeSlot;
+    MonsterIntent *intent; // nullptr outside decide()
+#if MONSTER_DECISION_TRACE
+    DecisionTrace decisionTrace;
+#endif
 
-    void updateStateTimer();
+    static const int AMBUSH_RANGE = 6; // Tiles
+
+    double clockTime() const;
+    float getThinkTimer() const;
+    void setStateTimer(float seconds);
+    void setThinkTimer(float seconds);
     bool shouldBecomeDisembodied(const Player &player, const Grid &grid);
+    int random();
+    void enterState(MonsterState newState);
     float calculateDistanceToPlayer(const Player &player) const;
     bool isPlayerInSameTunnel(const Player &player, const Grid &grid) const;
+    bool hasFreshPerception(const Player &player) const;
+    Direction chooseChaseDirection(Vector2 targetPos, const Grid &grid);
+    void cancelRoute();
+    Direction corridorContinuation(Vector2 targetPos, const Grid &grid) const;
+    bool takeAmbushPosition(const Player &player, Grid &grid);
+
+    struct BehaviorContext
+    {
+        const Player &player;
+        Grid &grid;
+        bool canBecomeDisembodied;
+    };
+
+    BehaviorScript scriptStart;
+    BehaviorTask script;
+    ScriptScheduler *scriptClock;
+    const BehaviorContext *scriptContext;
+
+    friend class ScriptAgent;
+
+    // Behavior tree and script hooks
+    void runBehavior(const Player &player, Grid &grid, bool canBecomeDisembodied);
+    void resumeScript(const BehaviorContext &context);
+    void parkScript();
+    bool isScriptWaiting() const;
+    virtual bool checkBehaviorCondition(BehaviorCondition condition, float value, const BehaviorContext &context);
+    virtual BehaviorStatus runBehaviorAction(BehaviorAction action, const BehaviorContext &context);
+    BehaviorStatus stepOrWait(Direction direction, Grid &grid);
 
 private:
-    Direction findBestDirectionToPlayer(const Player &player, const Grid &grid);
     Direction findRandomValidDirection(const Grid &grid);
+#if MONSTER_DECISION_TRACE
+    void traceDecision(DecisionRecord &decision, bool wasMoving);
+#endif
 };
 
 #endif // MONSTER_H
\ No newline at end of file
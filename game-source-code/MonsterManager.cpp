@@ -1,13 +1,52 @@
 #include "MonsterManager.h"
 #include "Fire.h"
+#include "PathFinding.h"
+#include "TacticalAI.h"
+#include "UtilityAI.h"
+#include "BehaviorLibrary.h"
+#include "MonsterScripts.h"
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
 
-MonsterManager::MonsterManager() {}
+namespace
+{
+    // Seed of one monster's decision stream, from the tick's seed and its store index
+    unsigned int decisionSeed(unsigned int tickSeed, int index)
+    {
+        unsigned int seed = tickSeed ^ (static_cast<unsigned int>(index) * 0x9E3779B9u);
+        seed ^= seed >> 16;
+        seed *= 0x85EBCA6Bu;
+        seed ^= seed >> 13;
+        return seed != 0 ? seed : 1u; // xorshift never leaves zero
+    }
+}
+
+MonsterManager::MonsterManager()
+    : dragonLookahead(false),
+      scriptedBehavior(false),
+      coarseSimulation(false),
+      activationRadius(ACTIVATION_RADIUS),
+      coarseTimer(0.0f),
+      storeDirty(true),
+      cellsDirty(true),
+      cellSize(32.0f)
+{
+}
 
 void MonsterManager::initialize(const Level &level, Vector2 playerStartPos)
 {
     monsters.clear();
+    timers.clear();
+    pathQueue.clear();
+    aiScheduler.clear();
+    blackboard.clear();
+    ghostSlots.clear();
+    scriptClock.clear();
+    coarse.clear();
+    coarseProgress.clear();
+    cellSize = static_cast<float>(level.getGrid().getTileSize());
 
     std::vector<Vector2> spawnPositions = level.getMonsterSpawnPositions();
     addMonstersToEmptyTunnels(spawnPositions, level.getGrid(), playerStartPos);
@@ -18,6 +57,20 @@ void MonsterManager::initialize(const Level &level, Vector2 playerStartPos)
     removeMonstersTooCloseToPlayer(playerStartPos);
     ensureMinimumGreenDragons(level.getGrid(), playerStartPos, 2);
     ensureMinimumMonsterCount(level.getGrid(), playerStartPos, 3);
+
+    for (auto &monster : monsters)
+    {
+        monster->setPathRequestQueue(&pathQueue);
+        monster->setDisembodimentScheduler(&ghostSlots);
+        monster->setTimerWheel(&timers);
+    }
+    applyDragonLookahead();
+    applyScriptedBehavior();
+
+    // Build the tunnel route table now rather than on the first chase
+    PathFinding::getTunnelDistances(level.getGrid());
+
+    rebuildStore();
 }
 
 void MonsterManager::ensureMinimumSpawns(std::vector<Vector2> &spawnPositions,
@@ -73,7 +126,7 @@ void MonsterManager::removeMonstersTooCloseToPlayer(Vector2 playerStartPos)
 
 void MonsterManager::ensureMinimumGreenDragons(const Grid &grid, Vector2 playerStartPos, int minCount)
 {
-    int current = countMonsterType<GreenDragon>();
+    int current = countMonsterKind(MonsterKind::GREEN_DRAGON);
 
     while (current < minCount)
     {
@@ -93,13 +146,12 @@ void MonsterManager::ensureMinimumMonsterCount(const Grid &grid, Vector2 playerS
         addMonstersToDistantTunnels(grid, playerStartPos);
 }
 
-template <typename T>
-int MonsterManager::countMonsterType() const
+int MonsterManager::countMonsterKind(MonsterKind kind) const
 {
     int count = 0;
     for (const auto &monster : monsters)
     {
-        if (dynamic_cast<T *>(monster.get()) != nullptr)
+        if (monster->getKind() == kind)
             count++;
     }
     return count;
@@ -128,30 +180,139 @@ std::vector<Vector2> MonsterManager::findDistantTunnels(const Grid &grid, Vector
     return tunnels;
 }
 
-void MonsterManager::update(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                            std::function<void()> notifyDisembodied)
+void MonsterManager::update(const Player &player, Grid &grid)
 {
-    for (auto &monster : monsters)
+    cellSize = static_cast<float>(grid.getTileSize());
+    // Monster timers move on with the clock; deadlines due by now fire
+    timers.advance(GetFrameTime());
+    // Routes finished since last tick become visible now
+    pathQueue.advanceTick(grid);
+    // Leases of ghosts killed or reset since last tick come free
+    ghostSlots.advance(GetFrameTime(), getStore());
+    // Scripts whose sleep is over think again from this tick
+    scriptClock.advance(GetFrameTime());
+    // Distant monsters go coarse, and those the player has come near are fully simulated again
+    if (coarseSimulation)
+        updateCoarseTier(player, grid);
+
+    // Movement first: a monster's update only touches its own state, so this
+    // is equivalent to interleaving it with the AI calls below
+    for (size_t i = 0; i < monsters.size(); i++)
     {
-        if (monster->isActive() && !monster->isDead())
+        if (monsters[i]->isActive() && !monsters[i]->isDead() && !isCoarse(static_cast<int>(i)))
         {
             // Update monster (this calls Monster::update() which updates movement)
-            monster->update();
+            monsters[i]->update();
+        }
+    }
 
-            // Check if this is a GreenDragon and update its AI specifically
-            GreenDragon *dragon = dynamic_cast<GreenDragon *>(monster.get());
-            if (dragon)
-            {
-                // Green dragons use their own AI
-                dragon->updateAI(player, grid, canBecomeDisembodied, notifyDisembodied);
-            }
-            else
-            {
-                // Regular monsters and red monsters use base Monster AI
-                monster->updateAI(player, grid, canBecomeDisembodied, notifyDisembodied);
-            }
+    // Perceptions and tactical layers for this tick's decisions, from the positions just reached
+    refreshStore();
+    blackboard.build(grid, player, store);
+    TacticalAI::getInfluenceMap().build(grid, player, store, getActiveFires(), GreenDragon::FIRE_BREATH_RANGE);
+    if (dragonLookahead)
+    {
+        // Every dragon searching this tick draws on the same time budget
+        lookahead.beginFrame();
+        lookahead.observeMonsters(store);
+    }
+
+    // Cached chase moves only track grid changes; danger-weighted moves go stale every tick
+    if (UtilityAI::getWeights().usesInfluence())
+        PathFinding::getDirectionCache().clear();
+
+    planChaseDirections(player, grid);
+
+    float intervalStretch = aiScheduler.getIntervalStretch();
+
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        Monster &monster = *monsters[i];
+        if (isCoarse(static_cast<int>(i)))
+            continue;
+        monster.resumeRoute(grid);
+
+        if (monster.isDecisionDue(intervalStretch))
+            aiScheduler.request(static_cast<int>(i), blackboard.getDistanceToPlayer(static_cast<int>(i)));
+    }
+
+    // Nearest monsters come first. Only picking them runs under the frame budget: splitting the
+    // batch on measured time would let the thread count change who decides this tick
+    auto think = [&](int index)
+    {
+        if (index < static_cast<int>(monsters.size()) && monsters[index]->isActive() && !monsters[index]->isDead())
+            deciding.push_back(index);
+    };
+
+    deciding.clear();
+    aiScheduler.runFrame(think);
+
+    decideAndApply(player, grid);
+
+    refreshStore();
+}
+
+void MonsterManager::decideAndApply(const Player &player, Grid &grid)
+{
+    const int count = static_cast<int>(deciding.size());
+    if (count == 0)
+        return;
+
+    // One draw from rand() per tick keeps the game's seed in charge, while each decision
+    // draws from its own stream and so the same numbers on any thread
+    unsigned int tickSeed = static_cast<unsigned int>(rand());
+    intents.assign(count, MonsterIntent{});
+    for (int i = 0; i < count; i++)
+        intents[i].randomState = decisionSeed(tickSeed, deciding[i]);
+
+    // Shared tables rebuild lazily on first use, so bring them up to date before the threads read them
+    PathFinding::getTunnelDistances(grid);
+    PathFinding::getTunnelGraph(grid);
+    TacticalAI::getChokepoints(grid);
+    BehaviorLibrary::getShared();
+
+    // The chase moves planned above are all in the cache already; deciding only reads it
+    PathCache &cache = PathFinding::getDirectionCache();
+    cache.setFrozen(true);
+    decisions.run(count, [&](int i)
+                  { monsters[deciding[i]]->decide(player, grid, intents[i]); });
+    cache.setFrozen(false);
+
+    // Whoever comes first in the scheduler's order wins a conflict, such as the last ghost lease
+    for (int i = 0; i < count; i++)
+        monsters[deciding[i]]->applyIntent(intents[i], player, grid);
+}
+
+void MonsterManager::planChaseDirections(const Player &player, const Grid &grid)
+{
+    directionSolver.clear();
+    float intervalStretch = aiScheduler.getIntervalStretch();
+
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        const Monster *monster = monsters[i].get();
+        if (!isCoarse(static_cast<int>(i)) && monster->isThinkDue() && monster->isDecisionDue(intervalStretch) &&
+            !monster->plansRoutes())
+        {
+            directionSolver.addQuery(monster->getPosition(), monster->chaseTarget(player),
+                                     monster->getState(), grid);
         }
     }
+
+    if (directionSolver.getQueryCount() == 0)
+        return;
+
+    const std::vector<Direction> &directions = directionSolver.solve(grid);
+    PathCache &cache = PathFinding::getDirectionCache();
+
+    for (int i = 0; i < directionSolver.getQueryCount(); i++)
+    {
+        Vector2 start = directionSolver.getStartTile(i);
+        Vector2 goal = directionSolver.getGoalTile(i);
+        cache.store(static_cast<int>(start.x), static_cast<int>(start.y),
+                    static_cast<int>(goal.x), static_cast<int>(goal.y),
+                    directionSolver.getMovementClass(i), grid.getVersion(), directions[i]);
+    }
 }
 
 void MonsterManager::draw()
@@ -164,10 +325,9 @@ void MonsterManager::draw()
 
             // Explicitly draw fire for green dragons
             // (The GreenDragon::draw() should handle this, but let's be certain)
-            GreenDragon *dragon = dynamic_cast<GreenDragon *>(monster.get());
-            if (dragon)
+            if (monster->getKind() == MonsterKind::GREEN_DRAGON)
             {
-                Fire &fire = dragon->getFire();
+                Fire &fire = static_cast<GreenDragon &>(*monster).getFire();
                 if (fire.isFireActive())
                 {
                     fire.draw();
@@ -179,6 +339,7 @@ void MonsterManager::draw()
 
 std::vector<std::unique_ptr<Monster>> &MonsterManager::getMonsters()
 {
+    storeDirty = true;
     return monsters;
 }
 
@@ -189,19 +350,347 @@ const std::vector<std::unique_ptr<Monster>> &MonsterManager::getMonsters() const
 
 bool MonsterManager::areAllMonstersDead() const
 {
-    for (const auto &monster : monsters)
+    return getStore().countAlive() == 0;
+}
+
+const MonsterStore &MonsterManager::getStore() const
+{
+    if (storeDirty || store.size() != static_cast<int>(monsters.size()))
+        rebuildStore();
+
+    return store;
+}
+
+Monster &MonsterManager::getMonster(int index)
+{
+    return *monsters[index];
+}
+
+int MonsterManager::findOverlapping(Rectangle bounds, int firstIndex) const
+{
+    const MonsterStore &current = getStore();
+
+    // Candidates come ascending, so the first hit is the one a full scan would find
+    getMonsterCells().query(bounds, cellCandidates);
+    for (int index : cellCandidates)
     {
-        if (monster->isActive() && !monster->isDead())
+        if (index >= firstIndex && current.isAlive(index) && CheckCollisionRecs(bounds, current.getBounds(index)))
+            return index;
+    }
+    return -1;
+}
+
+const SpatialHash &MonsterManager::getMonsterCells() const
+{
+    const MonsterStore &current = getStore();
+
+    if (cellsDirty)
+    {
+        // Kills leave their monster bucketed; the alive test after the query skips it
+        monsterCells.begin(cellSize);
+        for (int i = 0; i < current.size(); i++)
         {
-            return false;
+            if (current.isAlive(i))
+                monsterCells.insert(i, current.getBounds(i));
         }
+        monsterCells.finish();
+        cellsDirty = false;
     }
-    return true;
+    return monsterCells;
+}
+
+void MonsterManager::killMonster(int index)
+{
+    monsters[index]->setState(MonsterState::DEAD);
+    store.setState(index, MonsterState::DEAD);
+}
+
+const std::vector<Fire *> &MonsterManager::getActiveFires()
+{
+    const MonsterStore &current = getStore();
+
+    activeFires.clear();
+    for (int index : dragonIndices)
+    {
+        if (!current.isAlive(index))
+            continue;
+
+        Fire &fire = static_cast<GreenDragon &>(*monsters[index]).getFire();
+        if (fire.isFireActive())
+            activeFires.push_back(&fire);
+    }
+    return activeFires;
 }
 
 void MonsterManager::clear()
 {
     monsters.clear();
+    timers.clear();
+    pathQueue.clear();
+    aiScheduler.clear();
+    blackboard.clear();
+    ghostSlots.clear();
+    scriptClock.clear();
+    coarse.clear();
+    coarseProgress.clear();
+    store.clear();
+    dragonIndices.clear();
+    storeDirty = false;
+    cellsDirty = true;
+}
+
+void MonsterManager::rebuildStore() const
+{
+    store.resize(static_cast<int>(monsters.size()));
+    dragonIndices.clear();
+
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        if (!monsters[i])
+        {
+            store.writeVacant(static_cast<int>(i));
+            continue;
+        }
+
+        store.write(static_cast<int>(i), *monsters[i], monsters[i]->getKind());
+        monsters[i]->setBlackboard(&blackboard, static_cast<int>(i));
+        monsters[i]->setTimerWheel(&timers);
+        if (monsters[i]->getKind() == MonsterKind::GREEN_DRAGON)
+            dragonIndices.push_back(static_cast<int>(i));
+    }
+
+    storeDirty = false;
+    cellsDirty = true;
+}
+
+void MonsterManager::refreshStore()
+{
+    if (storeDirty || store.size() != static_cast<int>(monsters.size()))
+    {
+        // Sleepers are known by store index, which may now belong to another monster
+        if (scriptClock.getSleepingCount() > 0)
+            scriptClock.clear();
+        // So are the coarse monsters; they stand on whole tiles, so full simulation takes them back as they are
+        coarse.clear();
+        coarseProgress.clear();
+        rebuildStore();
+        return;
+    }
+
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        if (monsters[i])
+            store.writeDynamic(static_cast<int>(i), *monsters[i]);
+    }
+    cellsDirty = true;
+}
+
+PathRequestQueue &MonsterManager::getPathRequestQueue()
+{
+    return pathQueue;
+}
+
+AIScheduler &MonsterManager::getAIScheduler()
+{
+    return aiScheduler;
+}
+
+void MonsterManager::setDragonLookahead(bool enabled)
+{
+    dragonLookahead = enabled;
+    applyDragonLookahead();
+}
+
+bool MonsterManager::usesDragonLookahead() const
+{
+    return dragonLookahead;
+}
+
+LookaheadSearch &MonsterManager::getLookaheadSearch()
+{
+    return lookahead;
+}
+
+PerceptionBlackboard &MonsterManager::getBlackboard()
+{
+    return blackboard;
+}
+
+DisembodimentScheduler &MonsterManager::getDisembodimentScheduler()
+{
+    return ghostSlots;
+}
+
+DecisionPipeline &MonsterManager::getDecisionPipeline()
+{
+    return decisions;
+}
+
+void MonsterManager::setScriptedBehavior(bool enabled)
+{
+    scriptedBehavior = enabled;
+    applyScriptedBehavior();
+}
+
+bool MonsterManager::usesScriptedBehavior() const
+{
+    return scriptedBehavior;
+}
+
+ScriptScheduler &MonsterManager::getScriptScheduler()
+{
+    return scriptClock;
+}
+
+TimerWheel &MonsterManager::getTimerWheel()
+{
+    return timers;
+}
+
+void MonsterManager::setCoarseSimulation(bool enabled)
+{
+    coarseSimulation = enabled;
+    if (!enabled)
+    {
+        coarse.clear();
+        coarseProgress.clear();
+    }
+}
+
+bool MonsterManager::usesCoarseSimulation() const
+{
+    return coarseSimulation;
+}
+
+void MonsterManager::setActivationRadius(float tiles)
+{
+    activationRadius = std::max(tiles, 0.0f);
+}
+
+float MonsterManager::getActivationRadius() const
+{
+    return activationRadius;
+}
+
+bool MonsterManager::isCoarse(int index) const
+{
+    return index >= 0 && index < static_cast<int>(coarse.size()) && coarse[index];
+}
+
+int MonsterManager::getCoarseCount() const
+{
+    return static_cast<int>(std::count(coarse.begin(), coarse.end(), 1));
+}
+
+bool MonsterManager::dumpDecisionTraces(const std::string &path) const
+{
+#if MONSTER_DECISION_TRACE
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    // Little-endian on every platform we build for. Header: magic, format version, record
+    // size, monster count; then per monster: store index, kind, 3 bytes padding, its trace
+    const char magic[4] = {'D', 'T', 'R', 'C'};
+    const std::uint16_t version = 2; // 2: byte 7 of a record says which scorer wrote its scores
+    const std::uint16_t recordSize = sizeof(DecisionRecord);
+    const std::uint32_t count = static_cast<std::uint32_t>(monsters.size());
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char *>(&recordSize), sizeof(recordSize));
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        const std::uint8_t kind[4] = {static_cast<std::uint8_t>(monsters[i]->getKind()), 0, 0, 0};
+        file.write(reinterpret_cast<const char *>(&i), sizeof(i));
+        file.write(reinterpret_cast<const char *>(kind), sizeof(kind));
+        monsters[i]->getDecisionTrace().write(file);
+    }
+
+    return static_cast<bool>(file);
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void MonsterManager::updateCoarseTier(const Player &player, const Grid &grid)
+{
+    coarse.resize(monsters.size(), 0);
+    coarseProgress.resize(monsters.size(), 0.0f);
+
+    float tileSize = static_cast<float>(grid.getTileSize());
+    float wakeDistance = activationRadius * tileSize;
+    float sleepDistance = (activationRadius + ACTIVATION_MARGIN) * tileSize;
+    Vector2 playerPos = player.getPosition();
+
+    coarseTimer += GetFrameTime();
+    bool stepDue = coarseTimer >= COARSE_TICK;
+    if (stepDue)
+        coarseTimer -= COARSE_TICK;
+
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        Monster &monster = *monsters[i];
+        if (!monster.isActive() || monster.isDead())
+        {
+            coarse[i] = 0;
+            continue;
+        }
+
+        Vector2 pos = monster.getPosition();
+        float distance = std::sqrt((pos.x - playerPos.x) * (pos.x - playerPos.x) +
+                                   (pos.y - playerPos.y) * (pos.y - playerPos.y));
+
+        // Coarse steps end on whole tiles, so full simulation picks up from where the monster stands
+        if (coarse[i] && distance <= wakeDistance)
+        {
+            coarse[i] = 0;
+            continue;
+        }
+        // Only a monster at rest on a tile can go coarse, or it would jump off its step
+        if (!coarse[i] && distance > sleepDistance && monster.canStepCoarsely())
+        {
+            coarse[i] = 1;
+            coarseProgress[i] = 0.0f;
+        }
+        if (!coarse[i] || !stepDue)
+            continue;
+
+        // Speed is pixels per frame at 60 frames a second; the tiles it covers pile up between steps
+        coarseProgress[i] += monster.getSpeed() * 60.0f * COARSE_TICK / tileSize;
+        while (coarseProgress[i] >= 1.0f)
+        {
+            coarseProgress[i] -= 1.0f;
+            if (!monster.stepCoarse(monster.chaseTarget(player), grid))
+            {
+                coarseProgress[i] = 0.0f;
+                break;
+            }
+        }
+    }
+}
+
+void MonsterManager::applyScriptedBehavior()
+{
+    for (auto &monster : monsters)
+    {
+        // The dragon script plays as the built-in tree does, so a file that changes the tree puts the tree back
+        MonsterKind kind = monster->getKind();
+        bool scripted = scriptedBehavior ||
+                        (kind == MonsterKind::GREEN_DRAGON && BehaviorLibrary::getShared().isBuiltIn(kind));
+        monster->setBehaviorScript(scripted ? MonsterScripts::forKind(kind) : nullptr, &scriptClock);
+    }
+}
+
+void MonsterManager::applyDragonLookahead()
+{
+    for (auto &monster : monsters)
+    {
+        if (monster->getKind() == MonsterKind::GREEN_DRAGON)
+            static_cast<GreenDragon &>(*monster).setLookaheadSearch(dragonLookahead ? &lookahead : nullptr);
+    }
 }
 
 void MonsterManager::addMonstersToEmptyTunnels(std::vector<Vector2> &spawnPositions,
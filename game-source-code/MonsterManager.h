@@ -3,13 +3,24 @@
 
 #include <vector>
 #include <memory>
-#include <functional>
+#include <string>
 #include "Monster.h"
 #include "RedMonster.h"
 #include "GreenDragon.h"
 #include "Player.h"
 #include "Grid.h"
 #include "Level.h"
+#include "BatchDirectionSolver.h"
+#include "PathRequestQueue.h"
+#include "MonsterStore.h"
+#include "AIScheduler.h"
+#include "LookaheadSearch.h"
+#include "PerceptionBlackboard.h"
+#include "DisembodimentScheduler.h"
+#include "DecisionPipeline.h"
+#include "ScriptScheduler.h"
+#include "TimerWheel.h"
+#include "SpatialHash.h"
 
 class MonsterManager
 {
@@ -17,8 +28,7 @@ public:
     MonsterManager();
 
     void initialize(const Level &level, Vector2 playerStartPos);
-    void update(const Player &player, Grid &grid, bool canBecomeDisembodied,
-                std::function<void()> notifyDisembodied);
+    void update(const Player &player, Grid &grid);
     void draw();
 
     std::vector<std::unique_ptr<Monster>> &getMonsters();
@@ -26,8 +36,81 @@ public:
     bool areAllMonstersDead() const;
     void clear();
 
+    // Packed monster fields and collision queries
+    const MonsterStore &getStore() const;
+    Monster &getMonster(int index);
+    int findOverlapping(Rectangle bounds, int firstIndex = 0) const;
+    const SpatialHash &getMonsterCells() const;
+    void killMonster(int index);
+    const std::vector<Fire *> &getActiveFires();
+
+    // Shared AI services
+    PathRequestQueue &getPathRequestQueue();
+    AIScheduler &getAIScheduler();
+    LookaheadSearch &getLookaheadSearch();
+    PerceptionBlackboard &getBlackboard();
+    DisembodimentScheduler &getDisembodimentScheduler();
+    DecisionPipeline &getDecisionPipeline();
+    ScriptScheduler &getScriptScheduler();
+    TimerWheel &getTimerWheel();
+
+    // Hard mode: dragons plan with the lookahead search
+    void setDragonLookahead(bool enabled);
+    bool usesDragonLookahead() const;
+    // Scripts for every monster; dragons run theirs while their tree is the built-in one
+    void setScriptedBehavior(bool enabled);
+    bool usesScriptedBehavior() const;
+    // Coarse tier for distant monsters; groundwork, no shipped level turns it on
+    void setCoarseSimulation(bool enabled);
+    bool usesCoarseSimulation() const;
+    void setActivationRadius(float tiles);
+    float getActivationRadius() const;
+    bool isCoarse(int index) const;
+    int getCoarseCount() const;
+    // False if tracing is compiled out or the write fails
+    bool dumpDecisionTraces(const std::string &path) const;
+
+    static constexpr float ACTIVATION_RADIUS = 16.0f; // Tiles
+    static constexpr float ACTIVATION_MARGIN = 2.0f;  // Tiles
+    static constexpr float COARSE_TICK = 0.5f;        // Seconds
+
 private:
+    mutable TimerWheel timers; // Outlives the monsters
     std::vector<std::unique_ptr<Monster>> monsters;
+    BatchDirectionSolver directionSolver;
+    PathRequestQueue pathQueue;
+    AIScheduler aiScheduler;
+    LookaheadSearch lookahead;
+    bool dragonLookahead;
+    PerceptionBlackboard blackboard;
+    DisembodimentScheduler ghostSlots;
+    DecisionPipeline decisions;
+    std::vector<int> deciding;
+    std::vector<MonsterIntent> intents;
+    bool scriptedBehavior;
+    ScriptScheduler scriptClock;
+    bool coarseSimulation;
+    float activationRadius;
+    float coarseTimer;
+    std::vector<char> coarse;
+    std::vector<float> coarseProgress;
+    mutable MonsterStore store;
+    mutable bool storeDirty;
+    mutable std::vector<int> dragonIndices;
+    mutable SpatialHash monsterCells;
+    mutable bool cellsDirty;
+    mutable std::vector<int> cellCandidates;
+    float cellSize;
+    std::vector<Fire *> activeFires;
+
+    // Per-tick helpers
+    void applyDragonLookahead();
+    void applyScriptedBehavior();
+    void updateCoarseTier(const Player &player, const Grid &grid);
+    void rebuildStore() const;
+    void refreshStore();
+    void planChaseDirections(const Player &player, const Grid &grid);
+    void decideAndApply(const Player &player, Grid &grid);
 
     // Initialization helpers
     void ensureMinimumSpawns(std::vector<Vector2> &spawnPositions, const Grid &grid, Vector2 playerStartPos);
@@ -38,8 +121,7 @@ private:
     void ensureMinimumMonsterCount(const Grid &grid, Vector2 playerStartPos, int minCount);
 
     // Utility functions
-    template <typename T>
-    int countMonsterType() const;
+    int countMonsterKind(MonsterKind kind) const;
     std::vector<Vector2> findDistantTunnels(const Grid &grid, Vector2 playerStartPos, float minDistance);
 
     void addMonstersToEmptyTunnels(std::vector<Vector2> &spawnPositions, const Grid &grid, Vector2 playerStart);
@@ -0,0 +1,151 @@
+#include "MonsterScripts.h"
+
+BehaviorTask MonsterScripts::monster(ScriptAgent monster)
+{
+    while (true)
+    {
+        if (monster.check(BehaviorCondition::DISEMBODIED))
+        {
+            co_await haunt(monster, BehaviorAction::CHASE_PLAYER);
+            continue;
+        }
+
+        // Lie low for a while after reaching the tunnels, unless the player is already lined up
+        if (monster.check(BehaviorCondition::STATE_TIME_BELOW, SETTLE_TIME) &&
+            !monster.check(BehaviorCondition::PLAYER_IN_SAME_TUNNEL))
+        {
+            co_await seconds(SETTLE_TIME);
+            continue;
+        }
+
+        if (monster.act(BehaviorAction::FOLLOW_CORRIDOR) == BehaviorStatus::SUCCESS)
+        {
+            co_await reachedTile();
+            continue;
+        }
+
+        if (monster.check(BehaviorCondition::PLAYER_CLOSER_THAN, CHASE_RANGE))
+        {
+            monster.act(BehaviorAction::CHASE_PLAYER);
+            co_await reachedTile();
+            continue;
+        }
+
+        if (monster.check(BehaviorCondition::MAY_DISEMBODY) && monster.check(BehaviorCondition::WANTS_TO_DISEMBODY))
+        {
+            monster.act(BehaviorAction::BECOME_DISEMBODIED);
+            co_await nextThink();
+            continue;
+        }
+
+        if (monster.check(BehaviorCondition::AMBUSHES_CHOKEPOINTS) &&
+            monster.act(BehaviorAction::TAKE_AMBUSH_POSITION) == BehaviorStatus::SUCCESS)
+        {
+            co_await reachedTile();
+            continue;
+        }
+
+        // Drift toward the player now and then
+        if (monster.random() % 3 == 0)
+            monster.act(BehaviorAction::WANDER);
+        co_await reachedTile();
+    }
+}
+
+BehaviorTask MonsterScripts::greenDragon(ScriptAgent dragon)
+{
+    // Checks, chances and actions come in the tree's order, so the dragon plays as the tree does
+    while (true)
+    {
+        if (dragon.check(BehaviorCondition::IN_TUNNEL))
+        {
+            hunt(dragon);
+        }
+        else if (dragon.check(BehaviorCondition::DISEMBODIED))
+        {
+            co_await drift(dragon);
+            continue;
+        }
+        co_await nextThink();
+    }
+}
+
+void MonsterScripts::hunt(ScriptAgent dragon)
+{
+    // Fire along a clear tunnel whenever possible
+    if (dragon.check(BehaviorCondition::CAN_BREATHE_FIRE) &&
+        dragon.check(BehaviorCondition::PLAYER_IN_FIRE_RANGE) &&
+        dragon.check(BehaviorCondition::FIRE_LINE_TO_PLAYER) &&
+        dragon.act(BehaviorAction::BREATHE_FIRE) != BehaviorStatus::FAILURE)
+        return;
+
+    // Hard mode: plan by looking ahead
+    if (dragon.check(BehaviorCondition::IDLE) && dragon.act(BehaviorAction::SEARCH_AHEAD) != BehaviorStatus::FAILURE)
+        return;
+
+    BehaviorStatus approach = BehaviorStatus::FAILURE;
+    if (dragon.check(BehaviorCondition::PLAYER_CLOSER_THAN, CHASE_RANGE))
+    {
+        if (dragon.check(BehaviorCondition::IDLE))
+            approach = dragon.act(BehaviorAction::CHASE_PLAYER);
+    }
+    else if (dragon.check(BehaviorCondition::PLAYER_WITHIN, DRAGON_GHOST_RANGE))
+    {
+        // Mid range: mostly chase, sometimes line up a shot
+        if (dragon.check(BehaviorCondition::IDLE))
+        {
+            approach = dragon.random() % 5 < 1 ? dragon.act(BehaviorAction::TAKE_FIRING_POSITION)
+                                               : dragon.act(BehaviorAction::CHASE_PLAYER);
+        }
+    }
+    else
+    {
+        // Far: go ghost, or keep coming
+        if (dragon.check(BehaviorCondition::MAY_DISEMBODY) &&
+            dragon.check(BehaviorCondition::STATE_TIME_ABOVE, DRAGON_GHOST_DELAY))
+            approach = dragon.act(BehaviorAction::BECOME_DISEMBODIED);
+        if (approach == BehaviorStatus::FAILURE && dragon.check(BehaviorCondition::IDLE) && dragon.random() % 5 < 3)
+            approach = dragon.act(BehaviorAction::CHASE_PLAYER);
+    }
+    if (approach != BehaviorStatus::FAILURE)
+        return;
+
+    // Nothing else worked: the odd random step
+    if (dragon.check(BehaviorCondition::IDLE) && !dragon.check(BehaviorCondition::AWAITING_ROUTE) &&
+        dragon.random() % 10 < 1)
+        dragon.act(BehaviorAction::RANDOM_STEP);
+}
+
+BehaviorTask MonsterScripts::drift(ScriptAgent ghost)
+{
+    while (!ghost.check(BehaviorCondition::IN_TUNNEL) && ghost.check(BehaviorCondition::DISEMBODIED))
+    {
+        // Surface once the ghost time is up and there is tunnel below
+        if (ghost.check(BehaviorCondition::STATE_TIME_ABOVE, GHOST_TIME) && ghost.check(BehaviorCondition::OVER_TUNNEL))
+            ghost.act(BehaviorAction::RESURFACE);
+
+        // Ghosts ignore tunnels, so head straight in
+        if (ghost.check(BehaviorCondition::IDLE))
+            ghost.act(BehaviorAction::HOME_IN_ON_PLAYER);
+        co_await nextThink();
+    }
+}
+
+BehaviorTask MonsterScripts::haunt(ScriptAgent ghost, BehaviorAction step)
+{
+    // Nothing to decide until the ghost time is up, bar keeping on the player's trail
+    while (ghost.check(BehaviorCondition::DISEMBODIED) &&
+           !(ghost.check(BehaviorCondition::STATE_TIME_ABOVE, GHOST_TIME) && ghost.check(BehaviorCondition::OVER_TUNNEL)))
+    {
+        ghost.act(step);
+        co_await reachedTile();
+    }
+
+    if (ghost.check(BehaviorCondition::DISEMBODIED))
+        ghost.act(BehaviorAction::RESURFACE);
+}
+
+BehaviorScript MonsterScripts::forKind(MonsterKind kind)
+{
+    return kind == MonsterKind::GREEN_DRAGON ? &MonsterScripts::greenDragon : &MonsterScripts::monster;
+}
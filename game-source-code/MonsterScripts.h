@@ -0,0 +1,55 @@
+#ifndef MONSTER_SCRIPTS_H
+#define MONSTER_SCRIPTS_H
+
+#include "BehaviorScript.h"
+#include "GameEnums.h"
+
+/**
+ * @brief The stock monster behaviors, written as coroutine scripts
+ *
+ * One sequential routine per monster: settle, hunt, go ghost, resurface.
+ * The dragon's script plays exactly as the built-in green_dragon tree does,
+ * so dragons run it by default. The monster script settles by sleeping, so
+ * unlike the tree a monster does not stir if the player lines up meanwhile.
+ */
+class MonsterScripts
+{
+public:
+    static constexpr float SETTLE_TIME = 2.0f;          ///< Seconds a monster lies low after reaching the tunnels
+    static constexpr float GHOST_TIME = 4.0f;           ///< Least time a ghost drifts before it may resurface
+    static constexpr float CHASE_RANGE = 96.0f;         ///< Player distance inside which monsters give chase
+    static constexpr float DRAGON_GHOST_RANGE = 192.0f; ///< Player distance beyond which dragons may go ghost
+    static constexpr float DRAGON_GHOST_DELAY = 2.0f;   ///< Seconds in the tunnels before a dragon may go ghost
+
+    /**
+     * @brief Basic and red monsters
+     */
+    static BehaviorTask monster(ScriptAgent monster);
+
+    /**
+     * @brief Green dragons: fire when lined up, otherwise close in; the green_dragon tree as a script
+     */
+    static BehaviorTask greenDragon(ScriptAgent dragon);
+
+    /**
+     * @brief Drift through the earth as a ghost until it is time to resurface
+     * @param ghost The disembodied monster
+     * @param step Action taken for each step (a chase, or homing straight in)
+     */
+    static BehaviorTask haunt(ScriptAgent ghost, BehaviorAction step);
+
+    /**
+     * @brief Get the script for a kind of monster
+     * @param kind Monster kind
+     * @return Script to start
+     */
+    static BehaviorScript forKind(MonsterKind kind);
+
+private:
+    // One in-tunnel think of a dragon
+    static void hunt(ScriptAgent dragon);
+    // A dragon's thinks as a ghost, until it is back in the tunnels
+    static BehaviorTask drift(ScriptAgent ghost);
+};
+
+#endif // MONSTER_SCRIPTS_H
@@ -0,0 +1,126 @@
+#include "MonsterStore.h"
+#include "Monster.h"
+
+MonsterStore::MonsterStore() {}
+
+void MonsterStore::clear()
+{
+    resize(0);
+}
+
+void MonsterStore::resize(int count)
+{
+    positionX.resize(count, 0.0f);
+    positionY.resize(count, 0.0f);
+    targetX.resize(count, 0.0f);
+    targetY.resize(count, 0.0f);
+    widths.resize(count, 0.0f);
+    heights.resize(count, 0.0f);
+    stateTimers.resize(count, 0.0f);
+    states.resize(count, MonsterState::DEAD);
+    kinds.resize(count, MonsterKind::BASIC);
+    activeFlags.resize(count, 0);
+}
+
+void MonsterStore::write(int index, const Monster &monster, MonsterKind kind)
+{
+    Vector2 size = monster.getSize();
+    widths[index] = size.x;
+    heights[index] = size.y;
+    kinds[index] = kind;
+    writeDynamic(index, monster);
+}
+
+void MonsterStore::writeDynamic(int index, const Monster &monster)
+{
+    Vector2 position = monster.getPosition();
+    Vector2 target = monster.getTargetPosition();
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    targetX[index] = target.x;
+    targetY[index] = target.y;
+    stateTimers[index] = monster.getStateTimer();
+    states[index] = monster.getState();
+    activeFlags[index] = monster.isActive() ? 1 : 0;
+}
+
+void MonsterStore::writeVacant(int index)
+{
+    activeFlags[index] = 0;
+    states[index] = MonsterState::DEAD;
+}
+
+void MonsterStore::setState(int index, MonsterState state)
+{
+    states[index] = state;
+}
+
+int MonsterStore::size() const
+{
+    return static_cast<int>(states.size());
+}
+
+Vector2 MonsterStore::getPosition(int index) const
+{
+    return {positionX[index], positionY[index]};
+}
+
+Vector2 MonsterStore::getTargetPosition(int index) const
+{
+    return {targetX[index], targetY[index]};
+}
+
+Rectangle MonsterStore::getBounds(int index) const
+{
+    return Rectangle{positionX[index], positionY[index], widths[index], heights[index]};
+}
+
+MonsterState MonsterStore::getState(int index) const
+{
+    return states[index];
+}
+
+float MonsterStore::getStateTimer(int index) const
+{
+    return stateTimers[index];
+}
+
+MonsterKind MonsterStore::getKind(int index) const
+{
+    return kinds[index];
+}
+
+bool MonsterStore::isAlive(int index) const
+{
+    return activeFlags[index] && states[index] != MonsterState::DEAD;
+}
+
+int MonsterStore::countAlive() const
+{
+    int count = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        count += isAlive(i) ? 1 : 0;
+    }
+    return count;
+}
+
+int MonsterStore::countInState(MonsterState state) const
+{
+    int count = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        count += (activeFlags[i] && states[i] == state) ? 1 : 0;
+    }
+    return count;
+}
+
+int MonsterStore::findOverlapping(Rectangle bounds, int firstIndex) const
+{
+    for (int i = firstIndex; i < size(); i++)
+    {
+        if (isAlive(i) && CheckCollisionRecs(bounds, getBounds(i)))
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,123 @@
+#ifndef MONSTER_STORE_H
+#define MONSTER_STORE_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+
+class Monster;
+
+/**
+ * @brief Packed per-field copy of the monster list for the hot scans
+ *
+ * Each field lives in its own contiguous array indexed like the monster
+ * list, so counting survivors or testing overlaps is a linear pass over a
+ * few arrays instead of a pointer chase into every heap-allocated monster.
+ * The index of a monster doubles as its handle: MonsterManager::getMonster()
+ * turns it back into the full Monster interface.
+ */
+class MonsterStore
+{
+public:
+    /**
+     * @brief Constructor for MonsterStore
+     */
+    MonsterStore();
+
+    /**
+     * @brief Remove every entry
+     */
+    void clear();
+
+    /**
+     * @brief Set the number of entries (new entries start vacant)
+     * @param count New entry count
+     */
+    void resize(int count);
+
+    /**
+     * @brief Copy every field of a monster into an entry
+     * @param index Entry index
+     * @param monster Monster to copy
+     * @param kind Type of the monster
+     */
+    void write(int index, const Monster &monster, MonsterKind kind);
+
+    /**
+     * @brief Copy the fields that change from tick to tick
+     * @param index Entry index
+     * @param monster Monster to copy
+     */
+    void writeDynamic(int index, const Monster &monster);
+
+    /**
+     * @brief Mark an entry as holding no monster
+     * @param index Entry index
+     */
+    void writeVacant(int index);
+
+    /**
+     * @brief Change the state of an entry
+     * @param index Entry index
+     * @param state New state
+     */
+    void setState(int index, MonsterState state);
+
+    /**
+     * @brief Get the number of entries
+     * @return Entry count
+     */
+    int size() const;
+
+    Vector2 getPosition(int index) const;
+    Vector2 getTargetPosition(int index) const;
+    Rectangle getBounds(int index) const;
+    MonsterState getState(int index) const;
+    float getStateTimer(int index) const;
+    MonsterKind getKind(int index) const;
+
+    /**
+     * @brief Check if an entry is an active monster that is not dead
+     * @param index Entry index
+     * @return true if the monster is alive
+     */
+    bool isAlive(int index) const;
+
+    /**
+     * @brief Count the active monsters that are not dead
+     * @return Number of living monsters
+     */
+    int countAlive() const;
+
+    /**
+     * @brief Count the active monsters in a state
+     * @param state State to count
+     * @return Number of active monsters in that state
+     */
+    int countInState(MonsterState state) const;
+
+    /**
+     * @brief Find a living monster whose bounds overlap a rectangle
+     *
+     * Uses CheckCollisionRecs, so it agrees exactly with testing each
+     * monster's getBounds().
+     * @param bounds Rectangle to test
+     * @param firstIndex Index to start searching from
+     * @return Index of the first overlapping monster at or after firstIndex, or -1
+     */
+    int findOverlapping(Rectangle bounds, int firstIndex = 0) const;
+
+private:
+    std::vector<float> positionX;           // Current x positions
+    std::vector<float> positionY;           // Current y positions
+    std::vector<float> targetX;             // Movement target x positions
+    std::vector<float> targetY;             // Movement target y positions
+    std::vector<float> widths;              // Bounding box widths
+    std::vector<float> heights;             // Bounding box heights
+    std::vector<float> stateTimers;         // Seconds in the current state
+    std::vector<MonsterState> states;       // Monster states
+    std::vector<MonsterKind> kinds;         // Monster types
+    std::vector<unsigned char> activeFlags; // Whether the entry is an active monster
+};
+
+#endif // MONSTER_STORE_H
@@ -0,0 +1,87 @@
+#include "PathCache.h"
+
+PathCache::PathCache()
+    : frozen(false)
+{
+    clear();
+}
+
+bool PathCache::lookup(int startX, int startY, int goalX, int goalY,
+                       MonsterState movementClass, unsigned int gridVersion, Direction &result)
+{
+    const Entry &entry = entries[slotFor(startX, startY, goalX, goalY, movementClass)];
+
+    if (entry.valid && entry.gridVersion == gridVersion &&
+        entry.startX == startX && entry.startY == startY &&
+        entry.goalX == goalX && entry.goalY == goalY &&
+        entry.movementClass == movementClass)
+    {
+        result = entry.result;
+        if (!frozen)
+            hits++;
+        return true;
+    }
+
+    if (!frozen)
+        misses++;
+    return false;
+}
+
+void PathCache::store(int startX, int startY, int goalX, int goalY,
+                      MonsterState movementClass, unsigned int gridVersion, Direction result)
+{
+    if (frozen)
+        return;
+
+    Entry &entry = entries[slotFor(startX, startY, goalX, goalY, movementClass)];
+
+    entry.startX = static_cast<short>(startX);
+    entry.startY = static_cast<short>(startY);
+    entry.goalX = static_cast<short>(goalX);
+    entry.goalY = static_cast<short>(goalY);
+    entry.movementClass = movementClass;
+    entry.gridVersion = gridVersion;
+    entry.result = result;
+    entry.valid = true;
+}
+
+void PathCache::clear()
+{
+    for (Entry &entry : entries)
+    {
+        entry.valid = false;
+    }
+    hits = 0;
+    misses = 0;
+}
+
+void PathCache::setFrozen(bool readOnly)
+{
+    frozen = readOnly;
+}
+
+bool PathCache::isFrozen() const
+{
+    return frozen;
+}
+
+int PathCache::getHits() const
+{
+    return hits;
+}
+
+int PathCache::getMisses() const
+{
+    return misses;
+}
+
+int PathCache::slotFor(int startX, int startY, int goalX, int goalY, MonsterState movementClass)
+{
+    unsigned int hash = static_cast<unsigned int>(startX) * 73856093u;
+    hash ^= static_cast<unsigned int>(startY) * 19349663u;
+    hash ^= static_cast<unsigned int>(goalX) * 83492791u;
+    hash ^= static_cast<unsigned int>(goalY) * 2654435761u;
+    hash ^= static_cast<unsigned int>(movementClass) * 40503u;
+
+    return static_cast<int>((hash ^ (hash >> 16)) & (CACHE_SIZE - 1));
+}
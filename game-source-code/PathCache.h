@@ -0,0 +1,107 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <array>
+#include "GameEnums.h"
+
+/**
+ * @brief Direct-mapped cache of pathfinding direction results
+ *
+ * Entries are keyed by start tile, goal tile, movement class and the grid
+ * version the answer was computed against. A grid change bumps the version,
+ * so stale entries simply stop matching and are overwritten on the next miss.
+ */
+class PathCache
+{
+public:
+    static const int CACHE_SIZE = 256; ///< Number of slots (power of two)
+
+    /**
+     * @brief Constructor for PathCache
+     */
+    PathCache();
+
+    /**
+     * @brief Look up a cached direction
+     * @param startX Start tile x coordinate
+     * @param startY Start tile y coordinate
+     * @param goalX Goal tile x coordinate
+     * @param goalY Goal tile y coordinate
+     * @param movementClass Movement rules the answer was computed with
+     * @param gridVersion Current grid version
+     * @param result Receives the cached direction on a hit
+     * @return true on a cache hit
+     *
+     * Lookups on a frozen cache change nothing, so any number of threads may make them.
+     */
+    bool lookup(int startX, int startY, int goalX, int goalY,
+                MonsterState movementClass, unsigned int gridVersion, Direction &result);
+
+    /**
+     * @brief Store a direction, replacing whatever occupied its slot
+     * @param startX Start tile x coordinate
+     * @param startY Start tile y coordinate
+     * @param goalX Goal tile x coordinate
+     * @param goalY Goal tile y coordinate
+     * @param movementClass Movement rules the answer was computed with
+     * @param gridVersion Grid version the answer was computed against
+     * @param result Direction to cache
+     */
+    void store(int startX, int startY, int goalX, int goalY,
+               MonsterState movementClass, unsigned int gridVersion, Direction result);
+
+    /**
+     * @brief Make the cache read-only, or writable again
+     *
+     * While frozen, store() does nothing and lookups are not counted.
+     * @param readOnly Whether to freeze
+     */
+    void setFrozen(bool readOnly);
+    bool isFrozen() const;
+
+    /**
+     * @brief Drop every entry and reset the statistics
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of lookups that hit
+     * @return Hit count since the last clear
+     */
+    int getHits() const;
+
+    /**
+     * @brief Get the number of lookups that missed
+     * @return Miss count since the last clear
+     */
+    int getMisses() const;
+
+private:
+    /**
+     * @brief One cached answer
+     */
+    struct Entry
+    {
+        short startX;
+        short startY;
+        short goalX;
+        short goalY;
+        MonsterState movementClass;
+        unsigned int gridVersion;
+        Direction result;
+        bool valid;
+    };
+
+    std::array<Entry, CACHE_SIZE> entries; // Direct-mapped slots
+    int hits;                              // Lookups answered from the cache
+    int misses;                            // Lookups that had to search
+    bool frozen;                           // Read-only while monsters decide in parallel
+
+    /**
+     * @brief Hash a key to its slot
+     * @return Slot index in [0, CACHE_SIZE)
+     */
+    static int slotFor(int startX, int startY, int goalX, int goalY, MonsterState movementClass);
+};
+
+#endif // PATH_CACHE_H
@@ -1,153 +1,181 @@
 #include "PathFinding.h"
+#include "UtilityAI.h"
 #include <cmath>
-#include <algorithm>
 #include <random>
+#include <queue>
 
 float PathFinding::manhattanDistance(Vector2 from, Vector2 to)
 {
     return std::abs(to.x - from.x) + std::abs(to.y - from.y);
 }
 
-Direction PathFinding::findBestDirectionToTarget(
-    Vector2 currentPos,
-    Vector2 targetPos,
-    const Grid &grid,
-    std::function<bool(Vector2)> canMoveFunc)
+PathCache &PathFinding::getDirectionCache()
 {
-    std::vector<std::pair<Direction, float>> scoredDirections;
-    int tileSize = grid.getTileSize();
-
-    // Test all four directions
-    std::vector<Direction> allDirections = {
-        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
-
-    for (Direction dir : allDirections)
-    {
-        Vector2 testPos = getPositionAfterMove(currentPos, dir, tileSize);
+    static PathCache cache;
+    return cache;
+}
 
-        if (!canMoveFunc(testPos))
-            continue;
+const TunnelGraph &PathFinding::getTunnelGraph(const Grid &grid)
+{
+    static TunnelGraph graph;
+    graph.refresh(grid);
+    return graph;
+}
 
-        // Score this direction
-        float score = scoreDirection(currentPos, testPos, targetPos, grid);
-        scoredDirections.push_back({dir, score});
-    }
+const TunnelDistanceTable &PathFinding::getTunnelDistances(const Grid &grid)
+{
+    static TunnelDistanceTable table;
+    table.refresh(grid);
+    return table;
+}
 
-    // Sort by score (highest first)
-    std::sort(scoredDirections.begin(), scoredDirections.end(),
-              [](const std::pair<Direction, float> &a, const std::pair<Direction, float> &b)
-              {
-                  return a.second > b.second;
-              });
+Direction PathFinding::findTunnelRouteDirection(Vector2 currentPos, Vector2 targetPos, const Grid &grid)
+{
+    Vector2 currentGridPos = grid.worldToGrid(currentPos);
+    Vector2 targetGridPos = grid.worldToGrid(targetPos);
 
-    return scoredDirections.empty() ? Direction::NONE : scoredDirections[0].first;
+    return getTunnelDistances(grid).getNextHop(
+        static_cast<int>(currentGridPos.x), static_cast<int>(currentGridPos.y),
+        static_cast<int>(targetGridPos.x), static_cast<int>(targetGridPos.y));
 }
 
-std::vector<Direction> PathFinding::findValidDirections(
-    Vector2 currentPos,
-    const Grid &grid,
-    std::function<bool(Vector2)> canMoveFunc)
+bool PathFinding::hasDirectTunnelPath(Vector2 from, Vector2 to, const Grid &grid)
 {
-    std::vector<Direction> validDirections;
+    Vector2 fromCenter = {from.x + 16, from.y + 16};
+    Vector2 toCenter = {to.x + 16, to.y + 16};
+
+    // The closed form below relies on non-negative sample positions
+    if (fromCenter.x < 0 || fromCenter.y < 0)
+    {
+        return hasDirectPath(from, to, grid, [&grid](int x, int y)
+                             { return grid.isTunnel(x, y); });
+    }
+
+    float dx = toCenter.x - fromCenter.x;
+    float dy = toCenter.y - fromCenter.y;
+    bool checkHorizontal = std::abs(dx) > std::abs(dy);
     int tileSize = grid.getTileSize();
 
-    std::vector<Direction> allDirections = {
-        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    // Split into the axis hasDirectPath steps along and the lane it stays in
+    float primaryCenter = checkHorizontal ? fromCenter.x : fromCenter.y;
+    float lateralOffset = checkHorizontal ? dy : dx;
+    bool stepForward = (checkHorizontal ? dx : dy) > 0;
+    int startTile = static_cast<int>(primaryCenter) / tileSize;
+    int lane = static_cast<int>(checkHorizontal ? fromCenter.y : fromCenter.x) / tileSize;
+
+    Vector2 targetGridPos = grid.worldToGrid(to);
+    int targetTile = static_cast<int>(checkHorizontal ? targetGridPos.x : targetGridPos.y);
+    int targetLane = static_cast<int>(checkHorizontal ? targetGridPos.y : targetGridPos.x);
+
+    if (targetLane != lane)
+        return false;
 
-    for (Direction dir : allDirections)
+    // Number of steps until the target tile is reached, and the first tile stepped on
+    int steps = 0;
+    int firstTile = 0;
+    if (stepForward)
     {
-        Vector2 testPos = getPositionAfterMove(currentPos, dir, tileSize);
-        if (canMoveFunc(testPos))
-        {
-            validDirections.push_back(dir);
-        }
+        steps = targetTile - startTile;
+        firstTile = startTile + 1;
+    }
+    else if (startTile == 0)
+    {
+        // Stepping left/up out of tile 0 truncates back onto tile 0
+        steps = (targetTile == 0 && primaryCenter > 0) ? 1 : 0;
+        firstTile = 0;
+    }
+    else
+    {
+        steps = startTile - targetTile;
+        firstTile = startTile - 1;
     }
 
-    return validDirections;
-}
-
-Direction PathFinding::findRandomValidDirection(
-    Vector2 currentPos,
-    const Grid &grid,
-    std::function<bool(Vector2)> canMoveFunc)
-{
-    std::vector<Direction> validDirections = findValidDirections(currentPos, grid, canMoveFunc);
+    if (steps < 1 || steps > MAX_DIRECT_PATH_STEPS)
+        return false;
 
-    if (validDirections.empty())
-        return Direction::NONE;
+    // Every step before the target also requires the line to stay in its lane
+    if (steps > 1 && std::abs(lateralOffset) > tileSize / 2)
+        return false;
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, validDirections.size() - 1);
+    if (checkHorizontal)
+        return grid.isValidPosition(firstTile, lane) && grid.isClearRow(lane, firstTile, targetTile);
 
-    return validDirections[dis(gen)];
+    return grid.isValidPosition(lane, firstTile) && grid.isClearColumn(lane, firstTile, targetTile);
 }
 
-bool PathFinding::hasDirectPath(
-    Vector2 from,
-    Vector2 to,
+Direction PathFinding::findShortestPathDirection(
+    int startX, int startY,
+    int goalX, int goalY,
     const Grid &grid,
-    std::function<bool(int, int)> checkFunc)
+    MonsterState movementClass)
 {
-    Vector2 fromCenter = {from.x + 16, from.y + 16};
-    Vector2 toCenter = {to.x + 16, to.y + 16};
-
-    float dx = toCenter.x - fromCenter.x;
-    float dy = toCenter.y - fromCenter.y;
+    if (!grid.isValidPosition(startX, startY) || !canEnterTile(goalX, goalY, grid, movementClass))
+        return Direction::NONE;
 
-    // Determine primary direction
-    bool checkHorizontal = std::abs(dx) > std::abs(dy);
-    int tileSize = grid.getTileSize();
+    if (startX == goalX && startY == goalY)
+        return Direction::NONE;
 
-    Vector2 currentPos = fromCenter;
-    Vector2 targetGridPos = grid.worldToGrid(to);
+    static const int stepX[4] = {0, 0, -1, 1};
+    static const int stepY[4] = {-1, 1, 0, 0};
 
-    // Step through tiles
-    int maxSteps = 20; // Prevent infinite loops
-    int steps = 0;
+    int width = grid.getWidth();
+    std::vector<signed char> firstStep(width * grid.getHeight(), -1);
+    std::queue<int> frontier;
 
-    while (steps < maxSteps)
+    // Seed with the start's neighbours, remembering which way each was entered
+    for (int d = 0; d < 4; d++)
     {
-        // Move in primary direction
-        if (checkHorizontal)
+        int nx = startX + stepX[d];
+        int ny = startY + stepY[d];
+        if (canEnterTile(nx, ny, grid, movementClass))
         {
-            currentPos.x += (dx > 0 ? tileSize : -tileSize);
+            if (nx == goalX && ny == goalY)
+                return CARDINAL_DIRECTIONS[d];
+            firstStep[ny * width + nx] = static_cast<signed char>(d);
+            frontier.push(ny * width + nx);
         }
-        else
-        {
-            currentPos.y += (dy > 0 ? tileSize : -tileSize);
-        }
-
-        Vector2 currentGridPos = grid.worldToGrid(currentPos);
-        int gridX = static_cast<int>(currentGridPos.x);
-        int gridY = static_cast<int>(currentGridPos.y);
+    }
+    firstStep[startY * width + startX] = 4; // Visited, not a route
 
-        // Check bounds
-        if (!grid.isValidPosition(gridX, gridY))
-            return false;
+    while (!frontier.empty())
+    {
+        int tile = frontier.front();
+        frontier.pop();
+        int x = tile % width;
+        int y = tile / width;
 
-        // Check if reached target
-        if (gridX == static_cast<int>(targetGridPos.x) &&
-            gridY == static_cast<int>(targetGridPos.y))
+        for (int d = 0; d < 4; d++)
         {
-            return checkFunc(gridX, gridY);
+            int nx = x + stepX[d];
+            int ny = y + stepY[d];
+            if (!canEnterTile(nx, ny, grid, movementClass) || firstStep[ny * width + nx] != -1)
+                continue;
+
+            if (nx == goalX && ny == goalY)
+                return CARDINAL_DIRECTIONS[firstStep[tile]];
+
+            firstStep[ny * width + nx] = firstStep[tile];
+            frontier.push(ny * width + nx);
         }
+    }
 
-        // Check if path is blocked
-        if (!checkFunc(gridX, gridY))
-            return false;
+    return Direction::NONE;
+}
 
-        // Check if path curves too much
-        Vector2 dirToTarget = {toCenter.x - currentPos.x, toCenter.y - currentPos.y};
-        if (checkHorizontal && std::abs(dirToTarget.y) > tileSize / 2)
-            return false;
-        if (!checkHorizontal && std::abs(dirToTarget.x) > tileSize / 2)
-            return false;
+bool PathFinding::canEnterTile(int x, int y, const Grid &grid, MonsterState movementClass)
+{
+    if (!grid.isValidPosition(x, y))
+        return false;
 
-        steps++;
+    switch (movementClass)
+    {
+    case MonsterState::IN_TUNNEL:
+        return grid.isTunnel(x, y);
+    case MonsterState::DISEMBODIED:
+        return grid.getTile(x, y) != TileType::ROCK;
+    default:
+        return false;
     }
-
-    return false;
 }
 
 float PathFinding::scoreDirection(
@@ -156,7 +184,7 @@ float PathFinding::scoreDirection(
     Vector2 targetPos,
     const Grid &grid)
 {
-    float score = 0;
+    float values[static_cast<int>(MoveConsideration::COUNT)] = {};
 
     // Factor 1: Distance reduction (primary)
     Vector2 currentGridPos = grid.worldToGrid(currentPos);
@@ -165,9 +193,7 @@ float PathFinding::scoreDirection(
 
     float currentDistance = manhattanDistance(currentGridPos, targetGridPos);
     float newDistance = manhattanDistance(testGridPos, targetGridPos);
-    float distanceImprovement = currentDistance - newDistance;
-
-    score += distanceImprovement * 100;
+    values[static_cast<int>(MoveConsideration::DISTANCE_GAIN)] = currentDistance - newDistance;
 
     // Factor 2: Direction alignment
     float dx = targetGridPos.x - currentGridPos.x;
@@ -175,15 +201,15 @@ float PathFinding::scoreDirection(
 
     Vector2 moveVector = {testGridPos.x - currentGridPos.x, testGridPos.y - currentGridPos.y};
     float dotProduct = (moveVector.x * dx + moveVector.y * dy);
-
-    if (dotProduct > 0)
-        score += dotProduct * 50;
+    values[static_cast<int>(MoveConsideration::ALIGNMENT)] = dotProduct > 0 ? dotProduct : 0.0f;
 
     // Factor 3: Avoid dead ends
-    if (isDeadEnd(testPos, grid))
-        score -= 30;
+    values[static_cast<int>(MoveConsideration::DEAD_END)] = isDeadEnd(testPos, grid) ? 1.0f : 0.0f;
+
+    // Factor 4: Danger and crowding from this tick's influence layers
+    UtilityAI::sampleInfluence(static_cast<int>(testGridPos.x), static_cast<int>(testGridPos.y), grid, values);
 
-    return score;
+    return UtilityAI::scoreMove(values, UtilityAI::getWeights());
 }
 
 bool PathFinding::isDeadEnd(Vector2 pos, const Grid &grid)
@@ -219,6 +245,15 @@ int PathFinding::countTunnelNeighbors(Vector2 pos, const Grid &grid)
     return count;
 }
 
+int PathFinding::randomIndex(int count)
+{
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(0, count - 1);
+
+    return dis(gen);
+}
+
 Vector2 PathFinding::getPositionAfterMove(Vector2 pos, Direction dir, int tileSize)
 {
     Vector2 newPos = pos;
@@ -4,12 +4,20 @@
 #include <raylib-cpp.hpp>
 #include <vector>
 #include <utility>
+#include <cmath>
 #include "GameEnums.h"
 #include "Grid.h"
-#include <functional>
+#include "PathCache.h"
+#include "TunnelGraph.h"
+#include "TunnelDistanceTable.h"
+#include "DecisionTrace.h"
 
 /**
  * @brief Static utility class for pathfinding operations
+ *
+ * The movement and tile predicates are taken as template parameters so the
+ * monster lambdas inline into the search loops instead of going through a
+ * heap-allocated std::function on every AI tick.
  */
 class PathFinding
 {
@@ -30,11 +38,70 @@ public:
      * @param canMoveFunc Function to check if movement to a position is valid
      * @return Best direction to move
      */
+    template <typename CanMoveFunc>
     static Direction findBestDirectionToTarget(
         Vector2 currentPos,
         Vector2 targetPos,
         const Grid &grid,
-        std::function<bool(Vector2)> canMoveFunc);
+        CanMoveFunc &&canMoveFunc);
+
+    /**
+     * @brief Find the best direction to a target, reusing cached answers
+     *
+     * Results are cached per (start tile, goal tile, movement class, grid
+     * version), so monsters asking the same question within a few ticks skip
+     * the search. The caller guarantees that canMoveFunc depends only on the
+     * movement class and the grid. Positions that are not tile-aligned
+     * bypass the cache.
+     * @param currentPos Current world position
+     * @param targetPos Target world position
+     * @param grid Reference to the game grid
+     * @param movementClass Movement rules canMoveFunc applies
+     * @param canMoveFunc Function to check if movement to a position is valid
+     * @return Best direction to move
+     */
+    template <typename CanMoveFunc>
+    static Direction findBestDirectionCached(
+        Vector2 currentPos,
+        Vector2 targetPos,
+        const Grid &grid,
+        MonsterState movementClass,
+        CanMoveFunc &&canMoveFunc);
+
+    /**
+     * @brief Get the shared direction cache
+     * @return Reference to the cache used by findBestDirectionCached
+     */
+    static PathCache &getDirectionCache();
+
+    /**
+     * @brief Get the junction graph of a grid's tunnels
+     *
+     * The shared graph is rebuilt only when the grid version differs from
+     * the one it last described.
+     * @param grid Reference to the game grid
+     * @return Junctions and corridors of the grid's tunnels
+     */
+    static const TunnelGraph &getTunnelGraph(const Grid &grid);
+
+    /**
+     * @brief Get the all-pairs tunnel distance table of a grid
+     *
+     * The shared table is rebuilt or updated only when the grid version
+     * differs from the one it last described.
+     * @param grid Reference to the game grid
+     * @return Distances between the grid's tunnel tiles
+     */
+    static const TunnelDistanceTable &getTunnelDistances(const Grid &grid);
+
+    /**
+     * @brief Look up the first step of a shortest tunnel route
+     * @param currentPos Current world position (tile-aligned)
+     * @param targetPos Target world position
+     * @param grid Reference to the game grid
+     * @return Direction of the first step, or NONE if either end is off the tunnels or they are not connected
+     */
+    static Direction findTunnelRouteDirection(Vector2 currentPos, Vector2 targetPos, const Grid &grid);
 
     /**
      * @brief Find all valid directions from current position
@@ -43,10 +110,11 @@ public:
      * @param canMoveFunc Function to check if movement to a position is valid
      * @return Vector of valid directions
      */
+    template <typename CanMoveFunc>
     static std::vector<Direction> findValidDirections(
         Vector2 currentPos,
         const Grid &grid,
-        std::function<bool(Vector2)> canMoveFunc);
+        CanMoveFunc &&canMoveFunc);
 
     /**
      * @brief Find a random valid direction
@@ -55,10 +123,26 @@ public:
      * @param canMoveFunc Function to check if movement to a position is valid
      * @return Random valid direction or NONE
      */
+    template <typename CanMoveFunc>
     static Direction findRandomValidDirection(
         Vector2 currentPos,
         const Grid &grid,
-        std::function<bool(Vector2)> canMoveFunc);
+        CanMoveFunc &&canMoveFunc);
+
+    /**
+     * @brief Find a random valid direction, drawing from the caller's generator
+     * @param currentPos Current world position
+     * @param grid Reference to the game grid
+     * @param canMoveFunc Function to check if movement to a position is valid
+     * @param pickIndex Function returning a random index below the count it is given
+     * @return Random valid direction or NONE
+     */
+    template <typename CanMoveFunc, typename PickFunc>
+    static Direction findRandomValidDirection(
+        Vector2 currentPos,
+        const Grid &grid,
+        CanMoveFunc &&canMoveFunc,
+        PickFunc &&pickIndex);
 
     /**
      * @brief Check if there's a direct path between two positions
@@ -68,11 +152,53 @@ public:
      * @param checkFunc Function to check if a tile blocks the path
      * @return true if there's a direct path
      */
+    template <typename CheckFunc>
     static bool hasDirectPath(
         Vector2 from,
         Vector2 to,
         const Grid &grid,
-        std::function<bool(int, int)> checkFunc);
+        CheckFunc &&checkFunc);
+
+    /**
+     * @brief Check for a straight, unbroken tunnel between two positions
+     *
+     * Gives the same answer as hasDirectPath with a tunnel check, but uses
+     * the grid's row and column run index instead of stepping tile by tile.
+     * @param from Starting world position
+     * @param to Target world position
+     * @param grid Reference to the game grid
+     * @return true if a straight tunnel connects the two positions
+     */
+    static bool hasDirectTunnelPath(Vector2 from, Vector2 to, const Grid &grid);
+
+    /**
+     * @brief Find the first step of a shortest route between two tiles
+     *
+     * Breadth-first search over the tiles the movement class may enter,
+     * expanding neighbours in a fixed order so the answer is deterministic.
+     * @param startX Start tile x coordinate
+     * @param startY Start tile y coordinate
+     * @param goalX Goal tile x coordinate
+     * @param goalY Goal tile y coordinate
+     * @param grid Reference to the game grid
+     * @param movementClass Movement rules of the mover
+     * @return Direction of the first step, or NONE if unreachable or already there
+     */
+    static Direction findShortestPathDirection(
+        int startX, int startY,
+        int goalX, int goalY,
+        const Grid &grid,
+        MonsterState movementClass);
+
+    /**
+     * @brief Check if a movement class may enter a tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @param grid Reference to the game grid
+     * @param movementClass Movement rules of the mover
+     * @return true if the tile is inside the grid and passable
+     */
+    static bool canEnterTile(int x, int y, const Grid &grid, MonsterState movementClass);
 
     /**
      * @brief Score a direction based on multiple factors
@@ -105,6 +231,18 @@ public:
     static int countTunnelNeighbors(Vector2 pos, const Grid &grid);
 
 private:
+    static const int MAX_DIRECT_PATH_STEPS = 20; ///< Longest straight line hasDirectPath will follow
+
+    static constexpr Direction CARDINAL_DIRECTIONS[4] = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}; ///< Probe order for all searches
+
+    /**
+     * @brief Pick a uniformly random index using the shared pathfinding generator
+     * @param count Number of choices (must be positive)
+     * @return Index in [0, count)
+     */
+    static int randomIndex(int count);
+
     /**
      * @brief Get world position after moving in a direction
      * @param pos Current world position
@@ -115,4 +253,192 @@ private:
     static Vector2 getPositionAfterMove(Vector2 pos, Direction dir, int tileSize);
 };
 
+template <typename CanMoveFunc>
+Direction PathFinding::findBestDirectionToTarget(
+    Vector2 currentPos,
+    Vector2 targetPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc)
+{
+    int tileSize = grid.getTileSize();
+    Direction bestDirection = Direction::NONE;
+    float bestScore = 0.0f;
+
+    // Test all four directions, keeping the first highest-scoring one
+    DecisionScores::begin(DecisionRecord::SCORED_BY_GREEDY);
+    for (Direction dir : CARDINAL_DIRECTIONS)
+    {
+        Vector2 testPos = getPositionAfterMove(currentPos, dir, tileSize);
+
+        if (!canMoveFunc(testPos))
+            continue;
+
+        float score = scoreDirection(currentPos, testPos, targetPos, grid);
+        DecisionScores::note(dir, static_cast<int>(score * 100.0f));
+        if (bestDirection == Direction::NONE || score > bestScore)
+        {
+            bestDirection = dir;
+            bestScore = score;
+        }
+    }
+
+    return bestDirection;
+}
+
+template <typename CanMoveFunc>
+Direction PathFinding::findBestDirectionCached(
+    Vector2 currentPos,
+    Vector2 targetPos,
+    const Grid &grid,
+    MonsterState movementClass,
+    CanMoveFunc &&canMoveFunc)
+{
+    Vector2 startGridPos = grid.worldToGrid(currentPos);
+    Vector2 goalGridPos = grid.worldToGrid(targetPos);
+    int startX = static_cast<int>(startGridPos.x);
+    int startY = static_cast<int>(startGridPos.y);
+    int goalX = static_cast<int>(goalGridPos.x);
+    int goalY = static_cast<int>(goalGridPos.y);
+
+    // Mid-tile positions probe different neighbours, so only cache tile-aligned queries
+    Vector2 snapped = grid.gridToWorld(startX, startY);
+    if (snapped.x != currentPos.x || snapped.y != currentPos.y)
+        return findBestDirectionToTarget(currentPos, targetPos, grid, canMoveFunc);
+
+    PathCache &cache = getDirectionCache();
+    Direction result = Direction::NONE;
+    if (cache.lookup(startX, startY, goalX, goalY, movementClass, grid.getVersion(), result))
+    {
+        DecisionScores::begin(DecisionRecord::SCORED_BY_CACHE);
+        return result;
+    }
+
+    result = findBestDirectionToTarget(currentPos, targetPos, grid, canMoveFunc);
+    cache.store(startX, startY, goalX, goalY, movementClass, grid.getVersion(), result);
+    return result;
+}
+
+template <typename CanMoveFunc>
+std::vector<Direction> PathFinding::findValidDirections(
+    Vector2 currentPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc)
+{
+    std::vector<Direction> validDirections;
+    int tileSize = grid.getTileSize();
+
+    for (Direction dir : CARDINAL_DIRECTIONS)
+    {
+        Vector2 testPos = getPositionAfterMove(currentPos, dir, tileSize);
+        if (canMoveFunc(testPos))
+        {
+            validDirections.push_back(dir);
+        }
+    }
+
+    return validDirections;
+}
+
+template <typename CanMoveFunc>
+Direction PathFinding::findRandomValidDirection(
+    Vector2 currentPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc)
+{
+    return findRandomValidDirection(currentPos, grid, canMoveFunc, randomIndex);
+}
+
+template <typename CanMoveFunc, typename PickFunc>
+Direction PathFinding::findRandomValidDirection(
+    Vector2 currentPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc,
+    PickFunc &&pickIndex)
+{
+    Direction validDirections[4];
+    int validCount = 0;
+    int tileSize = grid.getTileSize();
+
+    for (Direction dir : CARDINAL_DIRECTIONS)
+    {
+        Vector2 testPos = getPositionAfterMove(currentPos, dir, tileSize);
+        if (canMoveFunc(testPos))
+        {
+            validDirections[validCount++] = dir;
+        }
+    }
+
+    if (validCount == 0)
+        return Direction::NONE;
+
+    return validDirections[pickIndex(validCount)];
+}
+
+template <typename CheckFunc>
+bool PathFinding::hasDirectPath(
+    Vector2 from,
+    Vector2 to,
+    const Grid &grid,
+    CheckFunc &&checkFunc)
+{
+    Vector2 fromCenter = {from.x + 16, from.y + 16};
+    Vector2 toCenter = {to.x + 16, to.y + 16};
+
+    float dx = toCenter.x - fromCenter.x;
+    float dy = toCenter.y - fromCenter.y;
+
+    // Determine primary direction
+    bool checkHorizontal = std::abs(dx) > std::abs(dy);
+    int tileSize = grid.getTileSize();
+
+    Vector2 currentPos = fromCenter;
+    Vector2 targetGridPos = grid.worldToGrid(to);
+
+    // Step through tiles
+    int steps = 0;
+
+    while (steps < MAX_DIRECT_PATH_STEPS)
+    {
+        // Move in primary direction
+        if (checkHorizontal)
+        {
+            currentPos.x += (dx > 0 ? tileSize : -tileSize);
+        }
+        else
+        {
+            currentPos.y += (dy > 0 ? tileSize : -tileSize);
+        }
+
+        Vector2 currentGridPos = grid.worldToGrid(currentPos);
+        int gridX = static_cast<int>(currentGridPos.x);
+        int gridY = static_cast<int>(currentGridPos.y);
+
+        // Check bounds
+        if (!grid.isValidPosition(gridX, gridY))
+            return false;
+
+        // Check if reached target
+        if (gridX == static_cast<int>(targetGridPos.x) &&
+            gridY == static_cast<int>(targetGridPos.y))
+        {
+            return checkFunc(gridX, gridY);
+        }
+
+        // Check if path is blocked
+        if (!checkFunc(gridX, gridY))
+            return false;
+
+        // Check if path curves too much
+        Vector2 dirToTarget = {toCenter.x - currentPos.x, toCenter.y - currentPos.y};
+        if (checkHorizontal && std::abs(dirToTarget.y) > tileSize / 2)
+            return false;
+        if (!checkHorizontal && std::abs(dirToTarget.x) > tileSize / 2)
+            return false;
+
+        steps++;
+    }
+
+    return false;
+}
+
 #endif // PATHFINDING_H
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "PathRequestQueue.h"
+#include "PathFinding.h"
+#include <algorithm>
+
+PathRequestQueue::PathRequestQueue()
+    : searchesRunning(0), stopping(false), nextTicket(0), lockstep(false)
+{
+}
+
+PathRequestQueue::~PathRequestQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+int PathRequestQueue::postRequest(Vector2 startPos, Vector2 goalPos, MonsterState movementClass, const Grid &grid)
+{
+    // Searches read a private copy, so the game may dig while they run
+    if (!snapshot || snapshot->getVersion() != grid.getVersion())
+    {
+        snapshot = std::make_shared<const Grid>(grid);
+    }
+
+    Vector2 startGridPos = grid.worldToGrid(startPos);
+    Vector2 goalGridPos = grid.worldToGrid(goalPos);
+
+    Request request;
+    request.ticket = nextTicket++;
+    request.startX = static_cast<int>(startGridPos.x);
+    request.startY = static_cast<int>(startGridPos.y);
+    request.goalX = static_cast<int>(goalGridPos.x);
+    request.goalY = static_cast<int>(goalGridPos.y);
+    request.movementClass = movementClass;
+    request.snapshot = snapshot;
+
+    outstanding.insert(request.ticket);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(request);
+    }
+
+    if (!worker.joinable())
+    {
+        worker = std::thread(&PathRequestQueue::workerLoop, this);
+    }
+    workAvailable.notify_one();
+
+    return request.ticket;
+}
+
+bool PathRequestQueue::pollResult(int ticket, Direction &result)
+{
+    auto it = published.find(ticket);
+    if (it == published.end())
+        return false;
+
+    result = it->second;
+    published.erase(it);
+    return true;
+}
+
+bool PathRequestQueue::isPending(int ticket) const
+{
+    return outstanding.count(ticket) > 0;
+}
+
+void PathRequestQueue::cancel(int ticket)
+{
+    outstanding.erase(ticket);
+    published.erase(ticket);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [ticket](const Request &request)
+                                 { return request.ticket == ticket; }),
+                  pending.end());
+}
+
+void PathRequestQueue::advanceTick(const Grid &grid)
+{
+    std::vector<Result> ready;
+    unsigned int version = grid.getVersion();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // Searches against an older layout would answer the wrong question
+        for (auto it = pending.begin(); it != pending.end();)
+        {
+            if (it->snapshot->getVersion() != version)
+            {
+                outstanding.erase(it->ticket);
+                it = pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (lockstep)
+        {
+            workDone.wait(lock, [this]()
+                          { return pending.empty() && searchesRunning == 0; });
+        }
+
+        ready.swap(finished);
+    }
+
+    for (const Result &result : ready)
+    {
+        // Skip results that were cancelled while in flight
+        if (outstanding.erase(result.ticket) == 0)
+            continue;
+
+        if (result.gridVersion == version)
+        {
+            published[result.ticket] = result.direction;
+        }
+    }
+}
+
+void PathRequestQueue::setLockstep(bool enabled)
+{
+    lockstep = enabled;
+}
+
+bool PathRequestQueue::isLockstep() const
+{
+    return lockstep;
+}
+
+void PathRequestQueue::clear()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    pending.clear();
+    workDone.wait(lock, [this]()
+                  { return searchesRunning == 0; });
+    finished.clear();
+    lock.unlock();
+
+    published.clear();
+    outstanding.clear();
+}
+
+void PathRequestQueue::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        workAvailable.wait(lock, [this]()
+                           { return stopping || !pending.empty(); });
+        if (stopping)
+            return;
+
+        Request request = pending.front();
+        pending.pop_front();
+        searchesRunning++;
+        lock.unlock();
+
+        Direction direction = PathFinding::findShortestPathDirection(
+            request.startX, request.startY, request.goalX, request.goalY,
+            *request.snapshot, request.movementClass);
+
+        lock.lock();
+        searchesRunning--;
+        finished.push_back({request.ticket, request.snapshot->getVersion(), direction});
+        workDone.notify_all();
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef PATH_REQUEST_QUEUE_H
+#define PATH_REQUEST_QUEUE_H
+
+#include <raylib-cpp.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+
+/**
+ * @brief Runs shortest-route searches on a worker thread
+ *
+ * Monsters post a request and get a ticket back. The worker searches a
+ * read-only snapshot of the grid, and results become visible at the next
+ * advanceTick(), so a monster keeps its heading for a tick or two instead of
+ * stalling the frame. Requests made against an older grid version are dropped
+ * when the grid changes, and their owners ask again. In lockstep mode
+ * advanceTick() waits for every outstanding search, so a result always
+ * arrives exactly one tick after it was posted, however fast the worker is.
+ */
+class PathRequestQueue
+{
+public:
+    /**
+     * @brief Constructor for PathRequestQueue (the worker starts on first use)
+     */
+    PathRequestQueue();
+
+    /**
+     * @brief Destructor, stops and joins the worker
+     */
+    ~PathRequestQueue();
+
+    PathRequestQueue(const PathRequestQueue &) = delete;
+    PathRequestQueue &operator=(const PathRequestQueue &) = delete;
+
+    /**
+     * @brief Post a route request
+     * @param startPos Mover world position
+     * @param goalPos Goal world position
+     * @param movementClass Movement rules of the mover
+     * @param grid Reference to the game grid (snapshotted if it changed)
+     * @return Ticket identifying the request
+     */
+    int postRequest(Vector2 startPos, Vector2 goalPos, MonsterState movementClass, const Grid &grid);
+
+    /**
+     * @brief Collect a published result, consuming it
+     * @param ticket Ticket returned by postRequest
+     * @param result Receives the first step of the route (NONE if unreachable)
+     * @return true if the result was available
+     */
+    bool pollResult(int ticket, Direction &result);
+
+    /**
+     * @brief Check if a request is still waiting for its result
+     * @param ticket Ticket returned by postRequest
+     * @return true if the result may still arrive
+     */
+    bool isPending(int ticket) const;
+
+    /**
+     * @brief Cancel a request; its result will never be published
+     * @param ticket Ticket returned by postRequest
+     */
+    void cancel(int ticket);
+
+    /**
+     * @brief Publish finished results and drop requests made stale by grid changes
+     * @param grid Reference to the game grid
+     */
+    void advanceTick(const Grid &grid);
+
+    /**
+     * @brief Enable or disable lockstep delivery
+     * @param enabled true to make result arrival independent of worker speed
+     */
+    void setLockstep(bool enabled);
+
+    /**
+     * @brief Check if lockstep delivery is enabled
+     * @return true in lockstep mode
+     */
+    bool isLockstep() const;
+
+    /**
+     * @brief Cancel every outstanding request and discard all results
+     */
+    void clear();
+
+private:
+    /**
+     * @brief A search waiting for or running on the worker
+     */
+    struct Request
+    {
+        int ticket;
+        int startX;
+        int startY;
+        int goalX;
+        int goalY;
+        MonsterState movementClass;
+        std::shared_ptr<const Grid> snapshot;
+    };
+
+    /**
+     * @brief A finished search waiting to be published
+     */
+    struct Result
+    {
+        int ticket;
+        unsigned int gridVersion;
+        Direction direction;
+    };
+
+    // Shared with the worker, guarded by mutex
+    std::deque<Request> pending;
+    std::vector<Result> finished;
+    int searchesRunning;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+
+    // Owned by the game thread
+    std::unordered_map<int, Direction> published;
+    std::unordered_set<int> outstanding;
+    std::shared_ptr<const Grid> snapshot;
+    int nextTicket;
+    bool lockstep;
+    std::thread worker;
+
+    /**
+     * @brief Worker thread body
+     */
+    void workerLoop();
+};
+
+#endif // PATH_REQUEST_QUEUE_H
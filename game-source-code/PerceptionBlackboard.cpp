@@ -0,0 +1,303 @@
+#include "PerceptionBlackboard.h"
+#include "PathFinding.h"
+#include <cmath>
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1}; // Indexed by Direction (UP, DOWN, LEFT, RIGHT)
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+}
+
+PerceptionBlackboard::PerceptionBlackboard()
+    : width(0), height(0), tick(0), squadSpreading(true), approachCount(0)
+{
+    clear();
+}
+
+void PerceptionBlackboard::clear()
+{
+    hasPreviousPlayer = false;
+    previousPlayerPosition = {0, 0};
+    playerPosition = {0, 0};
+    playerTileX = 0;
+    playerTileY = 0;
+    playerVelocity = {0, 0};
+    playerFacing = Direction::NONE;
+    harpoonOut = false;
+    harpoonDirection = Direction::NONE;
+    monsterPositions.clear();
+    monsterTileX.clear();
+    monsterTileY.clear();
+    distances.clear();
+    squadApproach.clear();
+    approachCount = 0;
+}
+
+void PerceptionBlackboard::build(const Grid &grid, const Player &player, const MonsterStore &monsters)
+{
+    tick++;
+
+    // Occupancy marks only need clearing when the grid changes size, or when the stamps wrap
+    if (width != grid.getWidth() || height != grid.getHeight() || tick == 0)
+    {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        occupancyStamps.assign(width * height, 0);
+        occupancyCounts.assign(width * height, 0);
+        tick = 1;
+    }
+
+    playerPosition = player.getPosition();
+    playerVelocity = hasPreviousPlayer ? Vector2{playerPosition.x - previousPlayerPosition.x,
+                                                 playerPosition.y - previousPlayerPosition.y}
+                                       : Vector2{0, 0};
+    previousPlayerPosition = playerPosition;
+    hasPreviousPlayer = true;
+
+    Vector2 playerTile = grid.worldToGrid(playerPosition);
+    playerTileX = static_cast<int>(playerTile.x);
+    playerTileY = static_cast<int>(playerTile.y);
+    playerFacing = player.getFacingDirection();
+    harpoonOut = player.getHarpoon().isHarpoonActive();
+    harpoonDirection = harpoonOut ? player.getHarpoon().getDirection() : Direction::NONE;
+
+    const int count = monsters.size();
+    monsterPositions.resize(count);
+    monsterTileX.resize(count);
+    monsterTileY.resize(count);
+    distances.resize(count);
+    squadApproach.assign(count, -1);
+
+    for (int i = 0; i < count; i++)
+    {
+        Vector2 pos = monsters.getPosition(i);
+        Vector2 tile = grid.worldToGrid(pos);
+        monsterPositions[i] = pos;
+        monsterTileX[i] = static_cast<int>(tile.x);
+        monsterTileY[i] = static_cast<int>(tile.y);
+
+        // Same expression as Monster::calculateDistanceToPlayer(), so both agree exactly
+        float dx = playerPosition.x - pos.x;
+        float dy = playerPosition.y - pos.y;
+        distances[i] = std::sqrt(dx * dx + dy * dy);
+
+        if (monsters.isAlive(i))
+            markOccupied(monsterTileX[i], monsterTileY[i]);
+    }
+
+    approachCount = 0;
+    if (squadSpreading)
+        assignApproaches(grid, monsters);
+}
+
+void PerceptionBlackboard::setSquadSpreading(bool enabled)
+{
+    squadSpreading = enabled;
+}
+
+bool PerceptionBlackboard::spreadsSquad() const
+{
+    return squadSpreading;
+}
+
+bool PerceptionBlackboard::describes(int slot, Vector2 monsterPos, Vector2 playerPos) const
+{
+    return isSlot(slot) &&
+           monsterPositions[slot].x == monsterPos.x && monsterPositions[slot].y == monsterPos.y &&
+           playerPosition.x == playerPos.x && playerPosition.y == playerPos.y;
+}
+
+Vector2 PerceptionBlackboard::getPlayerPosition() const
+{
+    return playerPosition;
+}
+
+int PerceptionBlackboard::getPlayerTileX() const
+{
+    return playerTileX;
+}
+
+int PerceptionBlackboard::getPlayerTileY() const
+{
+    return playerTileY;
+}
+
+Vector2 PerceptionBlackboard::getPlayerVelocity() const
+{
+    return playerVelocity;
+}
+
+Direction PerceptionBlackboard::getPlayerFacing() const
+{
+    return playerFacing;
+}
+
+bool PerceptionBlackboard::isHarpoonOut() const
+{
+    return harpoonOut;
+}
+
+Direction PerceptionBlackboard::getHarpoonDirection() const
+{
+    return harpoonDirection;
+}
+
+float PerceptionBlackboard::getDistanceToPlayer(int slot) const
+{
+    return isSlot(slot) ? distances[slot] : 0.0f;
+}
+
+bool PerceptionBlackboard::isInPlayerLine(int slot) const
+{
+    return isSlot(slot) && (monsterTileX[slot] == playerTileX || monsterTileY[slot] == playerTileY);
+}
+
+bool PerceptionBlackboard::isFacedByPlayer(int slot) const
+{
+    if (!isSlot(slot) || playerFacing == Direction::NONE)
+        return false;
+
+    int dx = monsterTileX[slot] - playerTileX;
+    int dy = monsterTileY[slot] - playerTileY;
+    int d = static_cast<int>(playerFacing);
+
+    // Ahead along the facing axis and level on the other one
+    return STEP_X[d] != 0 ? (dy == 0 && dx * STEP_X[d] > 0) : (dx == 0 && dy * STEP_Y[d] > 0);
+}
+
+bool PerceptionBlackboard::isPlayerApproaching(int slot) const
+{
+    if (!isSlot(slot))
+        return false;
+
+    float towardX = monsterPositions[slot].x - playerPosition.x;
+    float towardY = monsterPositions[slot].y - playerPosition.y;
+    return playerVelocity.x * towardX + playerVelocity.y * towardY > 0.0f;
+}
+
+bool PerceptionBlackboard::hasSquadTarget(int slot) const
+{
+    return isSlot(slot) && squadApproach[slot] != -1;
+}
+
+Vector2 PerceptionBlackboard::getSquadTarget(int slot) const
+{
+    if (!hasSquadTarget(slot))
+        return playerPosition;
+
+    return approachTargets[squadApproach[slot]];
+}
+
+int PerceptionBlackboard::getOccupantCount(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return 0;
+
+    int index = y * width + x;
+    return occupancyStamps[index] == tick ? occupancyCounts[index] : 0;
+}
+
+unsigned int PerceptionBlackboard::getTick() const
+{
+    return tick;
+}
+
+void PerceptionBlackboard::markOccupied(int x, int y)
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return;
+
+    int index = y * width + x;
+    if (occupancyStamps[index] != tick)
+    {
+        occupancyStamps[index] = tick;
+        occupancyCounts[index] = 0;
+    }
+    if (occupancyCounts[index] < 255)
+        occupancyCounts[index]++;
+}
+
+void PerceptionBlackboard::assignApproaches(const Grid &grid, const MonsterStore &monsters)
+{
+    for (int d = 0; d < 4; d++)
+    {
+        int x = playerTileX + STEP_X[d];
+        int y = playerTileY + STEP_Y[d];
+        if (grid.isTunnel(x, y))
+        {
+            approachX[approachCount] = x;
+            approachY[approachCount] = y;
+            approachTargets[approachCount] = grid.gridToWorld(x, y);
+            approachCount++;
+        }
+    }
+
+    // With a single way in there is nothing to share out
+    if (approachCount < 2)
+        return;
+
+    const TunnelDistanceTable &table = PathFinding::getTunnelDistances(grid);
+    const int count = monsters.size();
+    int load[MAX_APPROACHES] = {};
+    int distance[MAX_APPROACHES];
+
+    // Tunnel distance to every approach; returns the nearest, or -1 if none can be reached
+    auto measure = [&](int slot)
+    {
+        int nearest = -1;
+        for (int a = 0; a < approachCount; a++)
+        {
+            distance[a] = table.getDistance(monsterTileX[slot], monsterTileY[slot], approachX[a], approachY[a]);
+            if (distance[a] != -1 && (nearest == -1 || distance[a] < distance[nearest]))
+                nearest = a;
+        }
+        return nearest;
+    };
+    auto inTunnels = [&](int slot)
+    {
+        return monsters.isAlive(slot) && monsters.getState(slot) == MonsterState::IN_TUNNEL;
+    };
+
+    // Monsters about to arrive hold their approach first, whatever the order of the list
+    for (int i = 0; i < count; i++)
+    {
+        if (!inTunnels(i))
+            continue;
+
+        int nearest = measure(i);
+        if (nearest != -1 && distance[nearest] <= COMMIT_TILES)
+            load[nearest]++;
+    }
+
+    // The rest take the approach that is cheapest once the monsters already on it are counted
+    for (int i = 0; i < count; i++)
+    {
+        if (!inTunnels(i))
+            continue;
+
+        int nearest = measure(i);
+        if (nearest == -1 || distance[nearest] <= COMMIT_TILES)
+            continue;
+
+        int best = nearest;
+        int bestCost = distance[nearest] + SPREAD_TILES * load[nearest];
+        for (int a = 0; a < approachCount; a++)
+        {
+            int cost = distance[a] + SPREAD_TILES * load[a];
+            if (distance[a] != -1 && cost < bestCost)
+            {
+                best = a;
+                bestCost = cost;
+            }
+        }
+
+        load[best]++;
+        if (best != nearest)
+            squadApproach[i] = static_cast<signed char>(best);
+    }
+}
+
+bool PerceptionBlackboard::isSlot(int slot) const
+{
+    return slot >= 0 && slot < static_cast<int>(distances.size());
+}
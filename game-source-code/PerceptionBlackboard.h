@@ -0,0 +1,167 @@
+#ifndef PERCEPTION_BLACKBOARD_H
+#define PERCEPTION_BLACKBOARD_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+#include "Player.h"
+#include "MonsterStore.h"
+
+/**
+ * @brief What the monsters know about the world this tick, worked out once
+ *
+ * Every thinking monster used to look the player up itself: its position,
+ * its tile, the distance to it (a square root) and whether it shares a row
+ * or column. The blackboard does this once per tick for every store slot
+ * and keeps what the monsters share: the player's tile, velocity and
+ * facing, the harpoon, and which tiles are occupied.
+ *
+ * On top of that it coordinates the chase as a squad. The open tunnel
+ * tiles next to the player are the approaches; each monster in the tunnels
+ * is sent along the approach with the least tunnel distance plus a penalty
+ * for every monster already sent that way, so a pack spreads around the
+ * player instead of queueing down one corridor. Monsters already close to
+ * an approach keep it.
+ *
+ * Building is O(monsters): occupancy marks are stamped with the tick
+ * number rather than cleared, and approach distances come from the tunnel
+ * distance table.
+ */
+class PerceptionBlackboard
+{
+public:
+    static const int MAX_APPROACHES = 4; ///< Tunnel tiles next to the player
+    static const int SPREAD_TILES = 4;   ///< Extra tiles an approach counts for each monster already sent along it
+    static const int COMMIT_TILES = 2;   ///< Monsters this close to their nearest approach keep it
+
+    /**
+     * @brief Constructor for PerceptionBlackboard
+     */
+    PerceptionBlackboard();
+
+    /**
+     * @brief Forget everything, including the player's last position
+     */
+    void clear();
+
+    /**
+     * @brief Take this tick's perceptions
+     * @param grid Reference to the game grid
+     * @param player The player
+     * @param monsters Packed monster fields
+     */
+    void build(const Grid &grid, const Player &player, const MonsterStore &monsters);
+
+    /**
+     * @brief Turn squad coordination on or off (on by default)
+     * @param enabled Whether monsters are spread across approaches
+     */
+    void setSquadSpreading(bool enabled);
+    bool spreadsSquad() const;
+
+    /**
+     * @brief Check if a slot's perceptions still describe a monster
+     * @param slot Store index of the monster
+     * @param monsterPos Monster's current world position
+     * @param playerPos Player's current world position
+     * @return true if both stood exactly there when the blackboard was built
+     */
+    bool describes(int slot, Vector2 monsterPos, Vector2 playerPos) const;
+
+    Vector2 getPlayerPosition() const;
+    int getPlayerTileX() const;
+    int getPlayerTileY() const;
+
+    /**
+     * @brief Get how far the player moved since the last build
+     * @return Pixels per tick (zero on the first build)
+     */
+    Vector2 getPlayerVelocity() const;
+    Direction getPlayerFacing() const;
+    bool isHarpoonOut() const;
+    Direction getHarpoonDirection() const;
+
+    /**
+     * @brief Get the distance from a monster to the player
+     * @param slot Store index of the monster
+     * @return Pixels between their positions
+     */
+    float getDistanceToPlayer(int slot) const;
+
+    /**
+     * @brief Check if a monster shares a row or column with the player
+     * @param slot Store index of the monster
+     * @return true if the tiles line up
+     */
+    bool isInPlayerLine(int slot) const;
+
+    /**
+     * @brief Check if the player is looking straight at a monster
+     * @param slot Store index of the monster
+     * @return true if the monster is in the player's line, ahead of where they face
+     */
+    bool isFacedByPlayer(int slot) const;
+
+    /**
+     * @brief Check if the player is moving toward a monster
+     * @param slot Store index of the monster
+     * @return true if the player's velocity points the monster's way
+     */
+    bool isPlayerApproaching(int slot) const;
+
+    /**
+     * @brief Check if the squad sent a monster round by another approach
+     * @param slot Store index of the monster
+     * @return true if getSquadTarget() should replace the player as the chase target
+     */
+    bool hasSquadTarget(int slot) const;
+    Vector2 getSquadTarget(int slot) const;
+
+    /**
+     * @brief Count the living monsters on a tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return Monsters whose position lies on the tile
+     */
+    int getOccupantCount(int x, int y) const;
+
+    /**
+     * @brief Get the number of builds so far
+     * @return Build count (0 before the first)
+     */
+    unsigned int getTick() const;
+
+private:
+    int width;                                  ///< Grid width the occupancy marks cover
+    int height;                                 ///< Grid height the occupancy marks cover
+    unsigned int tick;                          ///< Builds so far; stamps this build's occupancy marks
+    bool squadSpreading;                        ///< Whether approaches are shared out
+    bool hasPreviousPlayer;                     ///< Whether previousPlayerPosition is from the last build
+    Vector2 previousPlayerPosition;             ///< Player position at the last build
+    Vector2 playerPosition;                     ///< Player world position
+    int playerTileX;                            ///< Player tile x
+    int playerTileY;                            ///< Player tile y
+    Vector2 playerVelocity;                     ///< Pixels moved since the last build
+    Direction playerFacing;                     ///< Way the player faces
+    bool harpoonOut;                            ///< Harpoon in flight
+    Direction harpoonDirection;                 ///< Way the harpoon flies
+    std::vector<Vector2> monsterPositions;      ///< Per slot: position the perceptions were taken at
+    std::vector<int> monsterTileX;              ///< Per slot: tile x
+    std::vector<int> monsterTileY;              ///< Per slot: tile y
+    std::vector<float> distances;               ///< Per slot: pixels to the player
+    std::vector<signed char> squadApproach;     ///< Per slot: approach the squad sent it to, or -1 to chase the player
+    std::vector<unsigned int> occupancyStamps;  ///< Per tile: tick of the counts below
+    std::vector<unsigned char> occupancyCounts; ///< Per tile: monsters on it
+    int approachCount;                          ///< Approaches in use
+    int approachX[MAX_APPROACHES];              ///< Approach tile x
+    int approachY[MAX_APPROACHES];              ///< Approach tile y
+    Vector2 approachTargets[MAX_APPROACHES];    ///< Approach tile world positions
+
+    void markOccupied(int x, int y);
+    // Share the approaches out among the monsters in the tunnels
+    void assignApproaches(const Grid &grid, const MonsterStore &monsters);
+    bool isSlot(int slot) const;
+};
+
+#endif // PERCEPTION_BLACKBOARD_H
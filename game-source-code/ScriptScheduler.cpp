@@ -0,0 +1,50 @@
+#include "ScriptScheduler.h"
+
+ScriptScheduler::ScriptScheduler()
+{
+}
+
+void ScriptScheduler::clear()
+{
+    wheel.clear();
+    alarms.clear();
+}
+
+void ScriptScheduler::sleep(int index, float seconds)
+{
+    if (index < 0)
+        return;
+
+    if (index >= static_cast<int>(alarms.size()))
+        alarms.resize(index + 1);
+
+    // The timer running is the sleep itself, so there is nothing to call back
+    wheel.cancel(alarms[index]);
+    alarms[index] = wheel.schedule(seconds, nullptr);
+}
+
+void ScriptScheduler::wake(int index)
+{
+    if (isAsleep(index))
+        wheel.cancel(alarms[index]);
+}
+
+void ScriptScheduler::advance(float seconds)
+{
+    wheel.advance(seconds);
+}
+
+bool ScriptScheduler::isAsleep(int index) const
+{
+    return index >= 0 && index < static_cast<int>(alarms.size()) && wheel.isPending(alarms[index]);
+}
+
+int ScriptScheduler::getSleepingCount() const
+{
+    return wheel.getPendingCount();
+}
+
+double ScriptScheduler::getTime() const
+{
+    return wheel.getTime();
+}
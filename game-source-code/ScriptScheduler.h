@@ -0,0 +1,66 @@
+#ifndef SCRIPT_SCHEDULER_H
+#define SCRIPT_SCHEDULER_H
+
+#include <vector>
+#include "TimerWheel.h"
+
+/**
+ * @brief Wakes sleeping behavior scripts when their time is up
+ *
+ * Each sleep is a timer on a wheel, so a tick only looks at the scripts that
+ * wake on it and waking one early is a cancel; a monster asleep costs nothing
+ * until then. Wake times are rounded up to the wheel's ticks. Monsters are
+ * identified by their store index.
+ */
+class ScriptScheduler
+{
+public:
+    /**
+     * @brief Constructor for ScriptScheduler
+     */
+    ScriptScheduler();
+
+    /**
+     * @brief Wake everyone and restart the clock
+     */
+    void clear();
+
+    /**
+     * @brief Put a monster's script to sleep
+     * @param index Store index of the monster
+     * @param seconds How long from now it wakes
+     */
+    void sleep(int index, float seconds);
+
+    /**
+     * @brief Wake a monster's script early
+     * @param index Store index of the monster
+     */
+    void wake(int index);
+
+    /**
+     * @brief Move the clock on, once per tick, waking the scripts whose time is up
+     * @param seconds Time since the last call
+     */
+    void advance(float seconds);
+
+    bool isAsleep(int index) const;
+
+    /**
+     * @brief Get the number of sleeping scripts
+     * @return Monsters asleep
+     */
+    int getSleepingCount() const;
+
+    /**
+     * @brief Get the time since the last clear
+     * @return Seconds
+     */
+    double getTime() const;
+
+private:
+    TimerWheel wheel;                ///< A pending timer per sleeping script
+    std::vector<TimerHandle> alarms; ///< Per store index: timer that wakes it
+};
+
+#endif // SCRIPT_SCHEDULER_H
@@ -0,0 +1,112 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Keeps cell numbers well inside int for coordinates far off the map
+    const float CELL_LIMIT = 1 << 20;
+}
+
+SpatialHash::SpatialHash()
+    : cellSize(32.0f),
+      bucketStarts(BUCKET_COUNT + 1, 0)
+{
+}
+
+void SpatialHash::begin(float size)
+{
+    cellSize = size > 0.0f ? size : 32.0f;
+    pending.clear();
+    ids.clear();
+    std::fill(bucketStarts.begin(), bucketStarts.end(), 0);
+}
+
+void SpatialHash::insert(int id, Rectangle bounds)
+{
+    int firstX = cellOf(bounds.x);
+    int lastX = cellOf(bounds.x + bounds.width);
+    int firstY = cellOf(bounds.y);
+    int lastY = cellOf(bounds.y + bounds.height);
+
+    for (int cellY = firstY; cellY <= lastY; cellY++)
+    {
+        for (int cellX = firstX; cellX <= lastX; cellX++)
+            pending.push_back(Entry{bucketOf(cellX, cellY), id});
+    }
+}
+
+void SpatialHash::finish()
+{
+    // Counting sort by bucket: count, turn the counts into offsets, then place
+    std::fill(bucketStarts.begin(), bucketStarts.end(), 0);
+    for (const Entry &entry : pending)
+        bucketStarts[entry.bucket + 1]++;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+        bucketStarts[bucket + 1] += bucketStarts[bucket];
+
+    ids.resize(pending.size());
+    cursors.assign(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (const Entry &entry : pending)
+        ids[cursors[entry.bucket]++] = entry.id;
+}
+
+void SpatialHash::query(Rectangle bounds, std::vector<int> &candidates) const
+{
+    candidates.clear();
+
+    int firstX = cellOf(bounds.x);
+    int lastX = cellOf(bounds.x + bounds.width);
+    int firstY = cellOf(bounds.y);
+    int lastY = cellOf(bounds.y + bounds.height);
+
+    long long cells = static_cast<long long>(lastX - firstX + 1) * (lastY - firstY + 1);
+    if (cells >= BUCKET_COUNT)
+    {
+        // Covers about as many cells as there are buckets: everyone is a candidate
+        candidates.assign(ids.begin(), ids.end());
+    }
+    else
+    {
+        for (int cellY = firstY; cellY <= lastY; cellY++)
+        {
+            for (int cellX = firstX; cellX <= lastX; cellX++)
+            {
+                int bucket = bucketOf(cellX, cellY);
+                candidates.insert(candidates.end(), ids.begin() + bucketStarts[bucket],
+                                  ids.begin() + bucketStarts[bucket + 1]);
+            }
+        }
+    }
+
+    // An id shows up once per shared cell, and buckets mix cells that hash alike
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+int SpatialHash::getEntryCount() const
+{
+    return static_cast<int>(ids.size());
+}
+
+float SpatialHash::getCellSize() const
+{
+    return cellSize;
+}
+
+int SpatialHash::cellOf(float coordinate) const
+{
+    float cell = std::floor(coordinate / cellSize);
+    if (!(cell > -CELL_LIMIT))
+        return static_cast<int>(-CELL_LIMIT);
+    if (cell > CELL_LIMIT)
+        return static_cast<int>(CELL_LIMIT);
+    return static_cast<int>(cell);
+}
+
+int SpatialHash::bucketOf(int cellX, int cellY)
+{
+    unsigned int hash = static_cast<unsigned int>(cellX) * 73856093u ^ static_cast<unsigned int>(cellY) * 19349663u;
+    hash ^= hash >> 15;
+    return static_cast<int>(hash & (BUCKET_COUNT - 1));
+}
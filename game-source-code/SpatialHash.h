@@ -0,0 +1,82 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+
+/**
+ * @brief Uniform-grid broadphase: rectangles bucketed by the cells they touch
+ *
+ * The world is cut into square cells and each cell hashed into one of a fixed
+ * number of buckets, so the table covers any coordinates without knowing the
+ * map size. An entry goes in every cell its rectangle touches, edges included,
+ * so two rectangles that overlap always share a cell: a query never misses an
+ * overlap, it only narrows down who is worth a CheckCollisionRecs.
+ *
+ * Entries are added between begin() and finish(); finish() lays the buckets
+ * out contiguously, and the arrays are reused from one build to the next.
+ */
+class SpatialHash
+{
+public:
+    static const int BUCKET_COUNT = 1024; ///< Hash buckets; a power of two
+
+    /**
+     * @brief Constructor for SpatialHash
+     */
+    SpatialHash();
+
+    /**
+     * @brief Drop every entry and start a new build
+     * @param size Side of a cell in pixels (the tile size suits)
+     */
+    void begin(float size);
+
+    /**
+     * @brief Add an entry to the build
+     * @param id Caller's number for the entry, at least 0
+     * @param bounds Its rectangle
+     */
+    void insert(int id, Rectangle bounds);
+
+    /**
+     * @brief Bucket the entries added since begin(), making them queryable
+     */
+    void finish();
+
+    /**
+     * @brief Find the entries sharing a cell with a rectangle
+     * @param bounds Rectangle to look around
+     * @param candidates Filled with their ids, ascending and without repeats
+     */
+    void query(Rectangle bounds, std::vector<int> &candidates) const;
+
+    /**
+     * @brief Get the number of cell entries of the last build
+     * @return Entries, counting an id once per cell it touches
+     */
+    int getEntryCount() const;
+
+    float getCellSize() const;
+
+private:
+    struct Entry
+    {
+        int bucket; ///< Bucket of one of the cells it touches
+        int id;     ///< Caller's number
+    };
+
+    float cellSize;                ///< Side of a cell in pixels
+    std::vector<Entry> pending;    ///< Added since begin(), one per cell touched
+    std::vector<int> bucketStarts; ///< Offset of each bucket in ids, plus the end
+    std::vector<int> ids;          ///< Entry ids grouped by bucket
+    std::vector<int> cursors;      ///< Next free place of each bucket while finish() fills ids
+
+    static_assert((BUCKET_COUNT & (BUCKET_COUNT - 1)) == 0, "buckets are picked by masking");
+
+    // Cell holding a coordinate, on either axis
+    int cellOf(float coordinate) const;
+    static int bucketOf(int cellX, int cellY);
+};
+
+#endif // SPATIAL_HASH_H
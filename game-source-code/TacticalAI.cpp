@@ -1,64 +1,7 @@
 #include "TacticalAI.h"
 #include "PathFinding.h"
+#include "UtilityAI.h"
 #include <cmath>
-#include <algorithm>
-
-Direction TacticalAI::findTacticalFirePosition(
-    Vector2 currentPos,
-    Vector2 playerPos,
-    const Grid &grid,
-    std::function<bool(Vector2)> canMoveFunc,
-    std::function<bool(Vector2)> hasFireLineFunc,
-    float fireRange)
-{
-    std::vector<std::pair<Direction, float>> tacticalMoves;
-    int tileSize = grid.getTileSize();
-
-    std::vector<Direction> allDirections = {
-        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
-
-    for (Direction dir : allDirections)
-    {
-        Vector2 testPos = currentPos;
-
-        switch (dir)
-        {
-        case Direction::UP:
-            testPos.y -= tileSize;
-            break;
-        case Direction::DOWN:
-            testPos.y += tileSize;
-            break;
-        case Direction::LEFT:
-            testPos.x -= tileSize;
-            break;
-        case Direction::RIGHT:
-            testPos.x += tileSize;
-            break;
-        default:
-            continue;
-        }
-
-        if (!canMoveFunc(testPos))
-            continue;
-
-        float score = evaluatePositionScore(testPos, playerPos, grid, hasFireLineFunc, fireRange);
-
-        if (score > 0)
-        {
-            tacticalMoves.push_back({dir, score});
-        }
-    }
-
-    // Sort by tactical score
-    std::sort(tacticalMoves.begin(), tacticalMoves.end(),
-              [](const std::pair<Direction, float> &a, const std::pair<Direction, float> &b)
-              {
-                  return a.second > b.second;
-              });
-
-    return tacticalMoves.empty() ? Direction::NONE : tacticalMoves[0].first;
-}
 
 bool TacticalAI::isInRange(Vector2 currentPos, Vector2 playerPos, float range)
 {
@@ -97,32 +40,55 @@ bool TacticalAI::isAlignedWithTarget(Vector2 currentPos, Vector2 targetPos, cons
            (static_cast<int>(currentGridPos.y) == static_cast<int>(targetGridPos.y));
 }
 
-float TacticalAI::evaluatePositionScore(
+const ChokepointMap &TacticalAI::getChokepoints(const Grid &grid)
+{
+    static ChokepointMap chokepoints;
+    chokepoints.refresh(grid);
+    return chokepoints;
+}
+
+InfluenceMap &TacticalAI::getInfluenceMap()
+{
+    static InfluenceMap influence;
+    return influence;
+}
+
+bool TacticalAI::isAmbushPosition(Vector2 pos, Vector2 playerPos, const Grid &grid, int ambushRange)
+{
+    Vector2 gridPos = grid.worldToGrid(pos);
+    Vector2 playerGridPos = grid.worldToGrid(playerPos);
+
+    if (PathFinding::manhattanDistance(gridPos, playerGridPos) > ambushRange)
+        return false;
+
+    return getChokepoints(grid).isChokepoint(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+}
+
+float TacticalAI::scorePosition(
     Vector2 pos,
     Vector2 playerPos,
     const Grid &grid,
-    std::function<bool(Vector2)> hasFireLineFunc,
+    bool hasFireLine,
     float fireRange)
 {
+    const UtilityWeights &weights = UtilityAI::getWeights();
     float score = 0;
 
-    // Check if position has fire line to player
-    bool hasFireLine = hasFireLineFunc(pos);
     bool inRange = isInRange(pos, playerPos, fireRange);
 
     if (hasFireLine && inRange)
     {
-        score += 100; // Perfect fire position
+        score += weights.get(PositionConsideration::FIRE_LINE_IN_RANGE); // Perfect fire position
     }
     else if (hasFireLine)
     {
-        score += 60; // Good fire line but maybe too far
+        score += weights.get(PositionConsideration::FIRE_LINE_OUT_OF_RANGE); // Good fire line but maybe too far
     }
 
     // Bonus for alignment with player (better fire lines)
     if (isAlignedWithTarget(pos, playerPos, grid))
     {
-        score += 40;
+        score += weights.get(PositionConsideration::ALIGNED);
     }
 
     // Calculate distance change
@@ -134,8 +100,14 @@ float TacticalAI::evaluatePositionScore(
     // Prefer positions that are not too far from player
     if (distanceToPlayer > 6) // More than 6 tiles away
     {
-        score -= 20;
+        score += weights.get(PositionConsideration::TOO_FAR);
+    }
+    // Bonus for holding a chokepoint of the tunnels near the player
+    else if (getChokepoints(grid).isChokepoint(static_cast<int>(currentGridPos.x),
+                                               static_cast<int>(currentGridPos.y)))
+    {
+        score += weights.get(PositionConsideration::CHOKEPOINT);
     }
 
     return score;
-}
\ No newline at end of file
+}
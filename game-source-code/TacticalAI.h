@@ -5,7 +5,23 @@
 #include "GameEnums.h"
 #include "Grid.h"
 #include "Player.h"
-#include <functional>
+#include "PathFinding.h"
+#include "ChokepointMap.h"
+#include "InfluenceMap.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/**
+ * @brief Nearest tile a dragon can breathe at the player from, and the way there
+ */
+struct FirePositionPlan
+{
+    Direction firstStep = Direction::NONE; ///< First step of a shortest way there; NONE if already on it
+    int steps = -1;                        ///< Length of that way, or -1 if no tile in reach has a shot
+    int tileX = -1;                        ///< Grid x coordinate of the tile
+    int tileY = -1;                        ///< Grid y coordinate of the tile
+};
 
 /**
  * @brief Handles tactical decision making for monsters
@@ -13,6 +29,8 @@
 class TacticalAI
 {
 public:
+    static const int MAX_FIRE_PLAN_STEPS = 8; ///< Farthest planFirePosition() looks, in steps
+
     /**
      * @brief Find tactical firing position for ranged attacks
      * @param currentPos Current world position
@@ -23,14 +41,61 @@ public:
      * @param fireRange Maximum firing range
      * @return Direction to move for tactical advantage
      */
+    template <typename CanMoveFunc, typename FireLineFunc>
     static Direction findTacticalFirePosition(
         Vector2 currentPos,
         Vector2 playerPos,
         const Grid &grid,
-        std::function<bool(Vector2)> canMoveFunc,
-        std::function<bool(Vector2)> hasFireLineFunc,
+        CanMoveFunc &&canMoveFunc,
+        FireLineFunc &&hasFireLineFunc,
         float fireRange);
 
+    /**
+     * @brief Find tactical firing position from the per-tick influence layers
+     *
+     * Chooses exactly as the overload above with PathFinding::hasDirectTunnelPath()
+     * as the fire line, but each candidate costs one array lookup.
+     * @param currentPos Current world position (tile-aligned)
+     * @param grid Reference to the game grid
+     * @param canMoveFunc Function to check if movement is valid
+     * @param influence Layers built for this grid, the player's position and the fire range
+     * @return Direction to move for tactical advantage
+     */
+    template <typename CanMoveFunc>
+    static Direction findTacticalFirePosition(
+        Vector2 currentPos,
+        const Grid &grid,
+        CanMoveFunc &&canMoveFunc,
+        const InfluenceMap &influence);
+
+    /**
+     * @brief Find the cheapest tile to reach that has a shot at the player
+     *
+     * A breadth-first pass over every tile within maxSteps steps, run in
+     * fixed-size buffers on the stack: it allocates nothing and is safe to run
+     * for every dragon at once. A tile has a shot when it is within fireRange
+     * of the player and hasFireLineFunc says the line is clear. Of the tiles
+     * at the smallest number of steps, the one scorePosition() rates highest
+     * wins, the first found on a tie.
+     * @param currentPos Current world position (tile-aligned)
+     * @param playerPos Player's world position
+     * @param grid Reference to the game grid
+     * @param canMoveFunc Function to check if a tile can be entered
+     * @param hasFireLineFunc Function to check if a position has a clear fire line
+     * @param fireRange Maximum firing range
+     * @param maxSteps Farthest tile to consider, at most MAX_FIRE_PLAN_STEPS
+     * @return The tile and the first step toward it; steps is 0 when the current tile has a shot
+     */
+    template <typename CanMoveFunc, typename FireLineFunc>
+    static FirePositionPlan planFirePosition(
+        Vector2 currentPos,
+        Vector2 playerPos,
+        const Grid &grid,
+        CanMoveFunc &&canMoveFunc,
+        FireLineFunc &&hasFireLineFunc,
+        float fireRange,
+        int maxSteps = MAX_FIRE_PLAN_STEPS);
+
     /**
      * @brief Check if player is within firing range
      * @param currentPos Current world position
@@ -66,12 +131,318 @@ public:
      * @param fireRange Maximum firing range
      * @return Score for position (higher is better)
      */
+    template <typename FireLineFunc>
     static float evaluatePositionScore(
         Vector2 pos,
         Vector2 playerPos,
         const Grid &grid,
-        std::function<bool(Vector2)> hasFireLineFunc,
+        FireLineFunc &&hasFireLineFunc,
+        float fireRange);
+
+    /**
+     * @brief Get the chokepoint analysis of a grid
+     *
+     * The shared analysis is rebuilt only when the grid version differs from
+     * the one it last described, so repeated calls within a tick are O(1).
+     * @param grid Reference to the game grid
+     * @return Chokepoints and bridges of the grid's tunnels
+     */
+    static const ChokepointMap &getChokepoints(const Grid &grid);
+
+    /**
+     * @brief Get the shared influence layers
+     *
+     * MonsterManager rebuilds them at the start of each tick's decisions;
+     * check InfluenceMap::describes() before sampling them elsewhere.
+     * @return Influence layers of the last tick
+     */
+    static InfluenceMap &getInfluenceMap();
+
+    /**
+     * @brief Check if a position is a chokepoint close enough to the player to ambush from
+     * @param pos Position to evaluate
+     * @param playerPos Player's world position
+     * @param grid Reference to the game grid
+     * @param ambushRange Maximum Manhattan distance in tiles to the player
+     * @return true if the player's way through passes this tile
+     */
+    static bool isAmbushPosition(Vector2 pos, Vector2 playerPos, const Grid &grid, int ambushRange);
+
+    /**
+     * @brief Find a move onto a neighbouring ambush position
+     * @param currentPos Current world position
+     * @param playerPos Player's world position
+     * @param grid Reference to the game grid
+     * @param canMoveFunc Function to check if movement is valid
+     * @param ambushRange Maximum Manhattan distance in tiles to the player
+     * @return Direction of the ambush position closest to the player, or NONE
+     */
+    template <typename CanMoveFunc>
+    static Direction findAmbushDirection(
+        Vector2 currentPos,
+        Vector2 playerPos,
+        const Grid &grid,
+        CanMoveFunc &&canMoveFunc,
+        int ambushRange);
+
+    /**
+     * @brief Score the range, alignment and distance factors of a position
+     * @param pos Position to evaluate
+     * @param playerPos Player's world position
+     * @param grid Reference to the game grid
+     * @param hasFireLine Whether the position has a clear fire line
+     * @param fireRange Maximum firing range
+     * @return Score for position (higher is better)
+     */
+    static float scorePosition(
+        Vector2 pos,
+        Vector2 playerPos,
+        const Grid &grid,
+        bool hasFireLine,
         float fireRange);
 };
 
+template <typename CanMoveFunc, typename FireLineFunc>
+Direction TacticalAI::findTacticalFirePosition(
+    Vector2 currentPos,
+    Vector2 playerPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc,
+    FireLineFunc &&hasFireLineFunc,
+    float fireRange)
+{
+    static constexpr Direction allDirections[4] = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+    int tileSize = grid.getTileSize();
+    Direction bestDirection = Direction::NONE;
+    float bestScore = 0.0f;
+
+    for (Direction dir : allDirections)
+    {
+        Vector2 testPos = currentPos;
+
+        switch (dir)
+        {
+        case Direction::UP:
+            testPos.y -= tileSize;
+            break;
+        case Direction::DOWN:
+            testPos.y += tileSize;
+            break;
+        case Direction::LEFT:
+            testPos.x -= tileSize;
+            break;
+        case Direction::RIGHT:
+            testPos.x += tileSize;
+            break;
+        default:
+            continue;
+        }
+
+        if (!canMoveFunc(testPos))
+            continue;
+
+        float score = evaluatePositionScore(testPos, playerPos, grid, hasFireLineFunc, fireRange);
+
+        // Keep the first move with the highest positive tactical score
+        if (score > bestScore)
+        {
+            bestDirection = dir;
+            bestScore = score;
+        }
+    }
+
+    return bestDirection;
+}
+
+template <typename CanMoveFunc>
+Direction TacticalAI::findTacticalFirePosition(
+    Vector2 currentPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc,
+    const InfluenceMap &influence)
+{
+    static constexpr Direction allDirections[4] = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static constexpr int stepX[4] = {0, 0, -1, 1};
+    static constexpr int stepY[4] = {-1, 1, 0, 0};
+
+    int tileSize = grid.getTileSize();
+    Vector2 gridPos = grid.worldToGrid(currentPos);
+    Direction bestDirection = Direction::NONE;
+    float bestScore = 0.0f;
+
+    for (int d = 0; d < 4; d++)
+    {
+        Vector2 testPos = {currentPos.x + stepX[d] * tileSize, currentPos.y + stepY[d] * tileSize};
+        if (!canMoveFunc(testPos))
+            continue;
+
+        float score = influence.getFirePositionScore(static_cast<int>(gridPos.x) + stepX[d],
+                                                     static_cast<int>(gridPos.y) + stepY[d]);
+
+        // Keep the first move with the highest positive tactical score
+        if (score > bestScore)
+        {
+            bestDirection = allDirections[d];
+            bestScore = score;
+        }
+    }
+
+    return bestDirection;
+}
+
+template <typename CanMoveFunc, typename FireLineFunc>
+FirePositionPlan TacticalAI::planFirePosition(
+    Vector2 currentPos,
+    Vector2 playerPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc,
+    FireLineFunc &&hasFireLineFunc,
+    float fireRange,
+    int maxSteps)
+{
+    static constexpr Direction allDirections[4] = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    static constexpr int stepX[4] = {0, 0, -1, 1};
+    static constexpr int stepY[4] = {-1, 1, 0, 0};
+    // Nothing in reach lies outside a square this wide around the start
+    static constexpr int SPAN = 2 * MAX_FIRE_PLAN_STEPS + 1;
+
+    int tileSize = grid.getTileSize();
+    Vector2 gridPos = grid.worldToGrid(currentPos);
+    int startX = static_cast<int>(gridPos.x);
+    int startY = static_cast<int>(gridPos.y);
+    maxSteps = std::min(maxSteps, static_cast<int>(MAX_FIRE_PLAN_STEPS));
+
+    FirePositionPlan plan;
+    if (isInRange(currentPos, playerPos, fireRange) && hasFireLineFunc(currentPos))
+    {
+        plan.steps = 0;
+        plan.tileX = startX;
+        plan.tileY = startY;
+        return plan;
+    }
+
+    // Square cells are (dx + MAX_FIRE_PLAN_STEPS) + (dy + MAX_FIRE_PLAN_STEPS) * SPAN from the start
+    std::array<bool, SPAN * SPAN> seen{};
+    std::array<Direction, SPAN * SPAN> firstSteps;
+    std::array<int, SPAN * SPAN> frontier;
+    int head = 0;
+    int tail = 0;
+    int origin = MAX_FIRE_PLAN_STEPS + MAX_FIRE_PLAN_STEPS * SPAN;
+    seen[origin] = true;
+    frontier[tail++] = origin;
+
+    for (int steps = 1; steps <= maxSteps && head < tail; steps++)
+    {
+        float bestScore = 0.0f;
+        int levelEnd = tail;
+
+        while (head < levelEnd)
+        {
+            int cell = frontier[head++];
+            int dx = cell % SPAN - MAX_FIRE_PLAN_STEPS;
+            int dy = cell / SPAN - MAX_FIRE_PLAN_STEPS;
+
+            for (int d = 0; d < 4; d++)
+            {
+                int next = cell + stepX[d] + stepY[d] * SPAN;
+                if (seen[next])
+                    continue;
+                seen[next] = true;
+
+                Vector2 testPos = {currentPos.x + (dx + stepX[d]) * tileSize, currentPos.y + (dy + stepY[d]) * tileSize};
+                if (!canMoveFunc(testPos))
+                    continue;
+
+                firstSteps[next] = steps == 1 ? allDirections[d] : firstSteps[cell];
+                frontier[tail++] = next;
+
+                if (!isInRange(testPos, playerPos, fireRange) || !hasFireLineFunc(testPos))
+                    continue;
+
+                float score = scorePosition(testPos, playerPos, grid, true, fireRange);
+                if (plan.steps == -1 || score > bestScore)
+                {
+                    plan.firstStep = firstSteps[next];
+                    plan.steps = steps;
+                    plan.tileX = startX + dx + stepX[d];
+                    plan.tileY = startY + dy + stepY[d];
+                    bestScore = score;
+                }
+            }
+        }
+
+        if (plan.steps != -1)
+            return plan;
+    }
+
+    return plan;
+}
+
+template <typename CanMoveFunc>
+Direction TacticalAI::findAmbushDirection(
+    Vector2 currentPos,
+    Vector2 playerPos,
+    const Grid &grid,
+    CanMoveFunc &&canMoveFunc,
+    int ambushRange)
+{
+    static constexpr Direction allDirections[4] = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+    int tileSize = grid.getTileSize();
+    Vector2 playerGridPos = grid.worldToGrid(playerPos);
+    Direction bestDirection = Direction::NONE;
+    float bestDistance = 0.0f;
+
+    for (Direction dir : allDirections)
+    {
+        Vector2 testPos = currentPos;
+
+        switch (dir)
+        {
+        case Direction::UP:
+            testPos.y -= tileSize;
+            break;
+        case Direction::DOWN:
+            testPos.y += tileSize;
+            break;
+        case Direction::LEFT:
+            testPos.x -= tileSize;
+            break;
+        case Direction::RIGHT:
+            testPos.x += tileSize;
+            break;
+        default:
+            continue;
+        }
+
+        if (!canMoveFunc(testPos) || !isAmbushPosition(testPos, playerPos, grid, ambushRange))
+            continue;
+
+        float distance = PathFinding::manhattanDistance(grid.worldToGrid(testPos), playerGridPos);
+        if (bestDirection == Direction::NONE || distance < bestDistance)
+        {
+            bestDirection = dir;
+            bestDistance = distance;
+        }
+    }
+
+    return bestDirection;
+}
+
+template <typename FireLineFunc>
+float TacticalAI::evaluatePositionScore(
+    Vector2 pos,
+    Vector2 playerPos,
+    const Grid &grid,
+    FireLineFunc &&hasFireLineFunc,
+    float fireRange)
+{
+    return scorePosition(pos, playerPos, grid, hasFireLineFunc(pos), fireRange);
+}
+
 #endif // TACTICAL_AI_H
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    // Absorbs float error in frame times summed up to a tick boundary
+    const double TICK_EPSILON = 1e-6;
+}
+
+TimerWheel::TimerWheel()
+    : time(0.0),
+      tick(0),
+      freeNode(-1),
+      heads(LEVELS * SLOTS, -1),
+      tails(LEVELS * SLOTS, -1),
+      pendingCount(0)
+{
+}
+
+void TimerWheel::clear()
+{
+    // Nodes are freed rather than dropped, so handles issued before the clear go stale
+    for (int i = 0; i < static_cast<int>(nodes.size()); i++)
+    {
+        if (nodes[i].bucket != -1)
+        {
+            unlink(i);
+            release(i);
+        }
+    }
+    time = 0.0;
+    tick = 0;
+}
+
+TimerHandle TimerWheel::schedule(float seconds, Callback callback)
+{
+    int index = freeNode;
+    if (index != -1)
+    {
+        freeNode = nodes[index].next;
+    }
+    else
+    {
+        index = static_cast<int>(nodes.size());
+        nodes.push_back(Node{0, nullptr, -1, -1, -1, 0});
+    }
+
+    Node &node = nodes[index];
+    long long due = static_cast<long long>(std::ceil((time + std::max(seconds, 0.0f)) / TICK_SECONDS - TICK_EPSILON));
+    node.deadline = std::max(due, tick + 1);
+    node.callback = std::move(callback);
+    place(index);
+    pendingCount++;
+
+    return TimerHandle{index, node.generation};
+}
+
+bool TimerWheel::cancel(TimerHandle &handle)
+{
+    int index = findNode(handle);
+    handle = TimerHandle{};
+    if (index == -1)
+        return false;
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+bool TimerWheel::isPending(const TimerHandle &handle) const
+{
+    return findNode(handle) != -1;
+}
+
+float TimerWheel::getRemaining(const TimerHandle &handle) const
+{
+    int index = findNode(handle);
+    if (index == -1)
+        return 0.0f;
+
+    return static_cast<float>(std::max(nodes[index].deadline * TICK_SECONDS - time, 0.0));
+}
+
+void TimerWheel::advance(float seconds)
+{
+    time += seconds;
+    long long target = static_cast<long long>(std::floor(time / TICK_SECONDS + TICK_EPSILON));
+
+    // Nothing to fire or cascade: skip the idle ticks outright
+    if (pendingCount == 0)
+    {
+        tick = std::max(tick, target);
+        return;
+    }
+
+    while (tick < target)
+        step();
+}
+
+double TimerWheel::getTime() const
+{
+    return time;
+}
+
+long long TimerWheel::getTick() const
+{
+    return tick;
+}
+
+int TimerWheel::getPendingCount() const
+{
+    return pendingCount;
+}
+
+int TimerWheel::findNode(const TimerHandle &handle) const
+{
+    if (handle.node < 0 || handle.node >= static_cast<int>(nodes.size()))
+        return -1;
+
+    const Node &node = nodes[handle.node];
+    return node.bucket != -1 && node.generation == handle.generation ? handle.node : -1;
+}
+
+void TimerWheel::place(int index)
+{
+    Node &node = nodes[index];
+    long long delta = std::max(node.deadline - tick, 0LL);
+    long long key = node.deadline;
+
+    int level = 0;
+    while (level < LEVELS && delta >= (1LL << ((level + 1) * SLOT_BITS)))
+        level++;
+    if (level == LEVELS)
+    {
+        // Beyond the top level: park as far out as it reaches and re-place on the way down
+        level = LEVELS - 1;
+        key = tick + (1LL << (LEVELS * SLOT_BITS)) - 1;
+    }
+
+    int bucket = level * SLOTS + static_cast<int>((key >> (level * SLOT_BITS)) & (SLOTS - 1));
+    node.bucket = bucket;
+    node.prev = tails[bucket];
+    node.next = -1;
+    if (tails[bucket] != -1)
+        nodes[tails[bucket]].next = index;
+    else
+        heads[bucket] = index;
+    tails[bucket] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+    Node &node = nodes[index];
+    if (node.prev != -1)
+        nodes[node.prev].next = node.next;
+    else
+        heads[node.bucket] = node.next;
+    if (node.next != -1)
+        nodes[node.next].prev = node.prev;
+    else
+        tails[node.bucket] = node.prev;
+
+    node.prev = -1;
+    node.next = -1;
+    node.bucket = -1;
+}
+
+void TimerWheel::release(int index)
+{
+    Node &node = nodes[index];
+    node.callback = nullptr;
+    node.generation++;
+    node.next = freeNode;
+    freeNode = index;
+    pendingCount--;
+}
+
+void TimerWheel::step()
+{
+    tick++;
+
+    // Every level whose lower levels all wrapped on this tick hands its bucket down, coarsest first
+    int wrapped = 0;
+    while (wrapped + 1 < LEVELS && (tick & ((1LL << ((wrapped + 1) * SLOT_BITS)) - 1)) == 0)
+        wrapped++;
+    for (int level = wrapped; level >= 1; level--)
+        cascade(level, static_cast<int>((tick >> (level * SLOT_BITS)) & (SLOTS - 1)));
+
+    // Callbacks may schedule or cancel; new timers are at least a tick out, so never land here
+    int bucket = static_cast<int>(tick & (SLOTS - 1));
+    while (heads[bucket] != -1)
+    {
+        int index = heads[bucket];
+        Callback callback = std::move(nodes[index].callback);
+        unlink(index);
+        release(index);
+        if (callback)
+            callback();
+    }
+}
+
+void TimerWheel::cascade(int level, int slot)
+{
+    int bucket = level * SLOTS + slot;
+    int index = heads[bucket];
+    heads[bucket] = -1;
+    tails[bucket] = -1;
+
+    while (index != -1)
+    {
+        int next = nodes[index].next;
+        place(index);
+        index = next;
+    }
+}
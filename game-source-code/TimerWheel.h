@@ -0,0 +1,131 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Names one timer on a TimerWheel
+ *
+ * A handle goes stale once its timer fires or is cancelled: the node it names
+ * is reused under a new generation, so stale handles are safe to keep around.
+ */
+struct TimerHandle
+{
+    int node = -1;               ///< Node in the wheel's pool, or -1 for none
+    unsigned int generation = 0; ///< Use of the node the handle was issued for
+};
+
+/**
+ * @brief Hierarchical timer wheel for gameplay deadlines
+ *
+ * Time is cut into fixed ticks. A timer due within SLOTS ticks waits in the
+ * bucket of its tick on the lowest level; later ones wait on a coarser level
+ * and cascade down each time the level below wraps round. Timers are nodes of
+ * intrusive lists in a pooled array, so scheduling and cancelling are O(1),
+ * and a tick only visits the timers due on it (plus a cascade every SLOTS
+ * ticks). Whoever waits on a timer costs nothing until it fires.
+ */
+class TimerWheel
+{
+public:
+    static const int SLOT_BITS = 6;                    ///< log2 of the buckets per level
+    static const int SLOTS = 1 << SLOT_BITS;           ///< Buckets per level
+    static const int LEVELS = 4;                       ///< Levels; together they span SLOTS^LEVELS ticks
+    static constexpr double TICK_SECONDS = 1.0 / 60.0; ///< Length of a tick
+
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Constructor for TimerWheel
+     */
+    TimerWheel();
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * @brief Drop every timer without calling it and restart the clock
+     */
+    void clear();
+
+    /**
+     * @brief Call back once a delay is up
+     * @param seconds Delay from now; it ends on the first tick at or after it, and at least one tick on
+     * @param callback Run from advance(); may schedule or cancel timers (nullptr just lets the timer lapse)
+     * @return Handle to ask after or cancel the timer with
+     */
+    TimerHandle schedule(float seconds, Callback callback);
+
+    /**
+     * @brief Cancel a timer before it fires
+     * @param handle Timer to cancel; left naming no timer
+     * @return true if the timer was still pending
+     */
+    bool cancel(TimerHandle &handle);
+
+    bool isPending(const TimerHandle &handle) const;
+
+    /**
+     * @brief Get how long until a timer fires
+     * @param handle Timer to ask after
+     * @return Seconds left, or 0 if it is not pending
+     */
+    float getRemaining(const TimerHandle &handle) const;
+
+    /**
+     * @brief Move the clock on, firing the timers of every tick passed, in tick order
+     * @param seconds Time since the last call
+     */
+    void advance(float seconds);
+
+    /**
+     * @brief Get the time since the last clear
+     * @return Seconds, not rounded to ticks
+     */
+    double getTime() const;
+
+    /**
+     * @brief Get the number of the last tick passed
+     * @return Ticks since the last clear
+     */
+    long long getTick() const;
+
+    /**
+     * @brief Get the number of timers waiting to fire
+     * @return Pending timers
+     */
+    int getPendingCount() const;
+
+private:
+    struct Node
+    {
+        long long deadline;       ///< Tick the timer fires on
+        Callback callback;        ///< What it calls
+        int prev;                 ///< Previous node in the bucket, or -1
+        int next;                 ///< Next node in the bucket (or on the free list), or -1
+        int bucket;               ///< Bucket it waits in, or -1 while free
+        unsigned int generation;  ///< Bumped each time the node is freed
+    };
+
+    double time;               ///< Seconds since the last clear
+    long long tick;            ///< Last tick passed
+    std::vector<Node> nodes;   ///< Pool of timers, free ones included
+    int freeNode;              ///< Head of the free list, or -1
+    std::vector<int> heads;    ///< First node of each bucket (level-major), or -1
+    std::vector<int> tails;    ///< Last node of each bucket, so a bucket fires in scheduling order
+    int pendingCount;          ///< Timers waiting to fire
+
+    // Index of the node a handle names, or -1 if the handle is stale
+    int findNode(const TimerHandle &handle) const;
+    // Put a node in the bucket its deadline calls for, relative to the current tick
+    void place(int index);
+    void unlink(int index);
+    void release(int index);
+    // Pass one tick: cascade the levels that wrapped, then fire the tick's bucket
+    void step();
+    // Re-place every node of a coarser bucket on the levels below
+    void cascade(int level, int slot);
+};
+
+#endif // TIMER_WHEEL_H
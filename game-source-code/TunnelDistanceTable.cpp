@@ -0,0 +1,204 @@
+#include "TunnelDistanceTable.h"
+#include "DecisionTrace.h"
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1}; // Indexed by Direction (UP, DOWN, LEFT, RIGHT)
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+}
+
+TunnelDistanceTable::TunnelDistanceTable()
+    : width(0), height(0), sourceGrid(nullptr), gridVersion(0), lastRefreshIncremental(false)
+{
+}
+
+void TunnelDistanceTable::refresh(const Grid &grid)
+{
+    if (sourceGrid == &grid && gridVersion == grid.getVersion() && width == grid.getWidth() &&
+        height == grid.getHeight())
+        return;
+
+    if (gridVersion == 0 || sourceGrid != &grid || width != grid.getWidth() || height != grid.getHeight() ||
+        !grid.getChangesSince(gridVersion, changedTiles))
+    {
+        rebuild(grid);
+        return;
+    }
+
+    // Only digging can be folded in; a tunnel that closed up invalidates routes through it
+    for (const auto &change : changedTiles)
+    {
+        int tile = change.second * width + change.first;
+        if (inTable[tile] && !grid.isTunnel(change.first, change.second))
+        {
+            rebuild(grid);
+            return;
+        }
+    }
+
+    for (const auto &change : changedTiles)
+    {
+        int tile = change.second * width + change.first;
+        if (!inTable[tile] && grid.isTunnel(change.first, change.second))
+            insertTile(tile);
+    }
+
+    gridVersion = grid.getVersion();
+    lastRefreshIncremental = true;
+}
+
+int TunnelDistanceTable::getDistance(int fromX, int fromY, int toX, int toY) const
+{
+    if (fromX < 0 || fromX >= width || fromY < 0 || fromY >= height ||
+        toX < 0 || toX >= width || toY < 0 || toY >= height)
+        return -1;
+
+    int from = fromY * width + fromX;
+    int to = toY * width + toX;
+    if (!inTable[from] || !inTable[to])
+        return -1;
+
+    unsigned short distance = distances[static_cast<size_t>(from) * width * height + to];
+    return distance == UNREACHABLE ? -1 : distance;
+}
+
+Direction TunnelDistanceTable::getNextHop(int fromX, int fromY, int toX, int toY) const
+{
+    int distance = getDistance(fromX, fromY, toX, toY);
+    if (distance <= 0)
+        return Direction::NONE;
+
+    const size_t tileCount = static_cast<size_t>(width) * height;
+    int from = fromY * width + fromX;
+    int to = toY * width + toX;
+
+    DecisionScores::begin(DecisionRecord::SCORED_BY_ROUTE_TABLE);
+    for (int d = 0; d < 4; d++)
+    {
+        int next = neighbour(from, d);
+        if (next == -1 || !inTable[next])
+            continue;
+
+        unsigned short onward = distances[next * tileCount + to];
+        DecisionScores::note(static_cast<Direction>(d), onward == UNREACHABLE ? DecisionRecord::UNREACHABLE : onward);
+        if (onward == distance - 1)
+            return static_cast<Direction>(d);
+    }
+
+    return Direction::NONE;
+}
+
+bool TunnelDistanceTable::wasLastRefreshIncremental() const
+{
+    return lastRefreshIncremental;
+}
+
+unsigned int TunnelDistanceTable::getGridVersion() const
+{
+    return gridVersion;
+}
+
+void TunnelDistanceTable::rebuild(const Grid &grid)
+{
+    width = grid.getWidth();
+    height = grid.getHeight();
+    sourceGrid = &grid;
+    gridVersion = grid.getVersion();
+    lastRefreshIncremental = false;
+
+    const size_t tileCount = static_cast<size_t>(width) * height;
+    distances.assign(tileCount * tileCount, UNREACHABLE);
+    inTable.assign(tileCount, 0);
+    viaTile.assign(tileCount, UNREACHABLE);
+    tunnelTiles.clear();
+
+    for (int tile = 0; tile < static_cast<int>(tileCount); tile++)
+    {
+        if (grid.isTunnel(tile % width, tile / width))
+        {
+            inTable[tile] = 1;
+            tunnelTiles.push_back(tile);
+        }
+    }
+
+    // One breadth-first search per tunnel tile fills its row
+    for (int source : tunnelTiles)
+    {
+        unsigned short *row = &distances[source * tileCount];
+        row[source] = 0;
+        frontier.clear();
+        frontier.push_back(source);
+
+        for (size_t head = 0; head < frontier.size(); head++)
+        {
+            int tile = frontier[head];
+            for (int d = 0; d < 4; d++)
+            {
+                int next = neighbour(tile, d);
+                if (next == -1 || !inTable[next] || row[next] != UNREACHABLE)
+                    continue;
+
+                row[next] = row[tile] + 1;
+                frontier.push_back(next);
+            }
+        }
+    }
+}
+
+void TunnelDistanceTable::insertTile(int tile)
+{
+    const size_t tileCount = static_cast<size_t>(width) * height;
+
+    // Distances from the new tile go through one of its tunnel neighbours
+    for (int other : tunnelTiles)
+    {
+        unsigned short best = UNREACHABLE;
+        for (int d = 0; d < 4; d++)
+        {
+            int next = neighbour(tile, d);
+            if (next == -1 || !inTable[next])
+                continue;
+
+            unsigned short viaNext = distances[next * tileCount + other];
+            if (viaNext != UNREACHABLE && viaNext + 1 < best)
+                best = viaNext + 1;
+        }
+        viaTile[other] = best;
+    }
+
+    inTable[tile] = 1;
+    tunnelTiles.push_back(tile);
+    viaTile[tile] = 0;
+
+    for (int other : tunnelTiles)
+    {
+        distances[tile * tileCount + other] = viaTile[other];
+        distances[other * tileCount + tile] = viaTile[other];
+    }
+
+    // Every route the new tile shortens passes through it
+    for (int source : tunnelTiles)
+    {
+        unsigned short toSource = viaTile[source];
+        if (toSource == UNREACHABLE)
+            continue;
+
+        unsigned short *row = &distances[source * tileCount];
+        for (int target : tunnelTiles)
+        {
+            unsigned short toTarget = viaTile[target];
+            if (toTarget != UNREACHABLE && toSource + toTarget < row[target])
+                row[target] = static_cast<unsigned short>(toSource + toTarget);
+        }
+    }
+}
+
+int TunnelDistanceTable::neighbour(int tile, int direction) const
+{
+    int x = tile % width + STEP_X[direction];
+    int y = tile / width + STEP_Y[direction];
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return -1;
+
+    return y * width + x;
+}
@@ -0,0 +1,109 @@
+#ifndef TUNNEL_DISTANCE_TABLE_H
+#define TUNNEL_DISTANCE_TABLE_H
+
+#include <vector>
+#include <utility>
+#include "GameEnums.h"
+#include "Grid.h"
+
+/**
+ * @brief Shortest tunnel distance between every pair of tunnel tiles
+ *
+ * Distances are stored in a tiles x tiles matrix of 16-bit steps, which for
+ * the full 28x22 map is about 760 KB. The next hop is not stored: it is the
+ * first neighbour, in UP, DOWN, LEFT, RIGHT order, that is one step closer
+ * to the target, so both lookups are O(1).
+ *
+ * A freshly dug tile can only shorten routes that pass through it, so new
+ * tunnel tiles are folded in with one O(tiles^2) relaxation instead of a
+ * rebuild. Any other change, or a lost change history, rebuilds from scratch
+ * with one breadth-first search per tunnel tile.
+ */
+class TunnelDistanceTable
+{
+public:
+    /**
+     * @brief Constructor for TunnelDistanceTable
+     */
+    TunnelDistanceTable();
+
+    /**
+     * @brief Bring the table up to date with the grid
+     *
+     * Does nothing when the grid version has not changed since the last
+     * refresh. A different grid than last time is always rebuilt for: version
+     * stamps are shared by all grids, so another grid's change log says
+     * nothing about how this table differs from it.
+     * @param grid Reference to the game grid
+     */
+    void refresh(const Grid &grid);
+
+    /**
+     * @brief Get the number of steps between two tunnel tiles
+     * @param fromX Start tile x coordinate
+     * @param fromY Start tile y coordinate
+     * @param toX Target tile x coordinate
+     * @param toY Target tile y coordinate
+     * @return Steps along the tunnels, or -1 if either tile is not a tunnel or they are not connected
+     */
+    int getDistance(int fromX, int fromY, int toX, int toY) const;
+
+    /**
+     * @brief Get the first step of a shortest tunnel route
+     * @param fromX Start tile x coordinate
+     * @param fromY Start tile y coordinate
+     * @param toX Target tile x coordinate
+     * @param toY Target tile y coordinate
+     * @return Direction of the first step, or NONE if unreachable or already there
+     */
+    Direction getNextHop(int fromX, int fromY, int toX, int toY) const;
+
+    /**
+     * @brief Check how the last refresh that did any work brought the table up to date
+     * @return true if it folded in dug tiles, false if it rebuilt from scratch
+     */
+    bool wasLastRefreshIncremental() const;
+
+    /**
+     * @brief Get the grid version the table describes
+     * @return Version stamp as of the last refresh (0 before the first)
+     */
+    unsigned int getGridVersion() const;
+
+private:
+    static constexpr unsigned short UNREACHABLE = 0xFFFF; ///< Distance between disconnected tiles
+
+    int width;                                     ///< Grid width the table was built for
+    int height;                                    ///< Grid height the table was built for
+    const Grid *sourceGrid;                        ///< Grid the table was built for
+    unsigned int gridVersion;                      ///< Grid version the table describes
+    bool lastRefreshIncremental;                   ///< Whether the last update avoided a rebuild
+    std::vector<unsigned short> distances;         ///< Row-major tiles x tiles step counts
+    std::vector<unsigned char> inTable;            ///< Per tile: whether it is a tunnel tile of the table
+    std::vector<int> tunnelTiles;                  ///< Indices of all tiles in the table
+    std::vector<unsigned short> viaTile;           ///< Scratch: distances to a tile being folded in
+    std::vector<std::pair<int, int>> changedTiles; ///< Scratch: tiles changed since the last refresh
+    std::vector<int> frontier;                     ///< Scratch: breadth-first search queue
+
+    /**
+     * @brief Recompute every distance from scratch
+     * @param grid Reference to the game grid
+     */
+    void rebuild(const Grid &grid);
+
+    /**
+     * @brief Fold one newly dug tunnel tile into the table
+     * @param tile Tile index
+     */
+    void insertTile(int tile);
+
+    /**
+     * @brief Get the tile index of a neighbour
+     * @param tile Tile index
+     * @param direction Direction index (UP, DOWN, LEFT, RIGHT)
+     * @return Neighbour tile index, or -1 off the grid
+     */
+    int neighbour(int tile, int direction) const;
+};
+
+#endif // TUNNEL_DISTANCE_TABLE_H
@@ -0,0 +1,214 @@
+#include "TunnelGraph.h"
+#include <algorithm>
+
+namespace
+{
+    const int STEP_X[4] = {0, 0, -1, 1}; // Indexed by Direction (UP, DOWN, LEFT, RIGHT)
+    const int STEP_Y[4] = {-1, 1, 0, 0};
+
+    int opposite(int direction)
+    {
+        return direction ^ 1; // UP <-> DOWN, LEFT <-> RIGHT
+    }
+
+    int countExits(unsigned char exitMask)
+    {
+        return (exitMask & 1) + ((exitMask >> 1) & 1) + ((exitMask >> 2) & 1) + ((exitMask >> 3) & 1);
+    }
+}
+
+TunnelGraph::TunnelGraph()
+    : width(0), height(0), gridVersion(0)
+{
+}
+
+void TunnelGraph::refresh(const Grid &grid)
+{
+    if (gridVersion == grid.getVersion() && width == grid.getWidth() && height == grid.getHeight())
+        return;
+
+    rebuild(grid);
+}
+
+int TunnelGraph::getNodeId(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return -1;
+
+    return nodeIds[y * width + x];
+}
+
+int TunnelGraph::getCorridorId(int x, int y) const
+{
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return -1;
+
+    return corridorIds[y * width + x];
+}
+
+bool TunnelGraph::isNode(int x, int y) const
+{
+    return getNodeId(x, y) != -1;
+}
+
+int TunnelGraph::getNodeCount() const
+{
+    return static_cast<int>(nodeTiles.size());
+}
+
+int TunnelGraph::getCorridorCount() const
+{
+    return static_cast<int>(corridors.size());
+}
+
+Vector2 TunnelGraph::getNodeTile(int node) const
+{
+    int tile = nodeTiles[node];
+    return {static_cast<float>(tile % width), static_cast<float>(tile / width)};
+}
+
+const std::vector<TunnelGraph::Edge> &TunnelGraph::getEdges(int node) const
+{
+    return edges[node];
+}
+
+void TunnelGraph::getCorridorEnds(int corridor, int &nodeA, int &nodeB) const
+{
+    nodeA = corridors[corridor].nodeA;
+    nodeB = corridors[corridor].nodeB;
+}
+
+Direction TunnelGraph::continueCorridor(int x, int y, Direction heading) const
+{
+    if (getCorridorId(x, y) == -1 || heading == Direction::NONE)
+        return Direction::NONE;
+
+    int back = opposite(static_cast<int>(heading));
+    unsigned char exitMask = exits[y * width + x];
+
+    // A corridor tile has exactly two exits; arriving through neither is no heading at all
+    if ((exitMask & (1 << back)) == 0)
+        return Direction::NONE;
+
+    for (int d = 0; d < 4; d++)
+    {
+        if (d != back && (exitMask & (1 << d)))
+            return static_cast<Direction>(d);
+    }
+
+    return Direction::NONE;
+}
+
+unsigned int TunnelGraph::getGridVersion() const
+{
+    return gridVersion;
+}
+
+void TunnelGraph::rebuild(const Grid &grid)
+{
+    width = grid.getWidth();
+    height = grid.getHeight();
+    gridVersion = grid.getVersion();
+
+    const int tileCount = width * height;
+    exits.assign(tileCount, 0);
+    traced.assign(tileCount, 0);
+    nodeIds.assign(tileCount, -1);
+    corridorIds.assign(tileCount, -1);
+    nodeTiles.clear();
+    edges.clear();
+    corridors.clear();
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (!grid.isTunnel(x, y))
+                continue;
+
+            unsigned char exitMask = 0;
+            for (int d = 0; d < 4; d++)
+            {
+                int nx = x + STEP_X[d];
+                int ny = y + STEP_Y[d];
+                if (grid.isValidPosition(nx, ny) && grid.isTunnel(nx, ny))
+                    exitMask |= (1 << d);
+            }
+            exits[y * width + x] = exitMask;
+
+            if (countExits(exitMask) != 2)
+                addNode(y * width + x);
+        }
+    }
+
+    for (int node = 0; node < getNodeCount(); node++)
+        traceCorridors(node);
+
+    // Whatever is left are closed loops with no junction on them
+    for (int tile = 0; tile < tileCount; tile++)
+    {
+        if (exits[tile] != 0 && nodeIds[tile] == -1 && corridorIds[tile] == -1)
+        {
+            addNode(tile);
+            traceCorridors(nodeIds[tile]);
+        }
+    }
+
+    for (auto &nodeEdges : edges)
+    {
+        std::sort(nodeEdges.begin(), nodeEdges.end(),
+                  [](const Edge &a, const Edge &b)
+                  { return a.direction < b.direction; });
+    }
+}
+
+void TunnelGraph::addNode(int tile)
+{
+    nodeIds[tile] = static_cast<int>(nodeTiles.size());
+    nodeTiles.push_back(tile);
+    edges.emplace_back();
+}
+
+void TunnelGraph::traceCorridors(int node)
+{
+    int start = nodeTiles[node];
+
+    for (int d = 0; d < 4; d++)
+    {
+        if ((exits[start] & (1 << d)) == 0 || (traced[start] & (1 << d)))
+            continue;
+
+        int corridor = static_cast<int>(corridors.size());
+        int step = d;
+        int current = start + STEP_Y[d] * width + STEP_X[d];
+        int length = 1;
+
+        // Corridor tiles have two exits: leave by the one we did not come in through
+        while (nodeIds[current] == -1)
+        {
+            corridorIds[current] = corridor;
+
+            int back = opposite(step);
+            for (int e = 0; e < 4; e++)
+            {
+                if (e != back && (exits[current] & (1 << e)))
+                {
+                    step = e;
+                    break;
+                }
+            }
+
+            current += STEP_Y[step] * width + STEP_X[step];
+            length++;
+        }
+
+        int arrival = opposite(step);
+        int endNode = nodeIds[current];
+        traced[start] |= (1 << d);
+        traced[current] |= (1 << arrival);
+
+        corridors.push_back({node, endNode, length});
+        edges[node].push_back({endNode, length, static_cast<Direction>(d), corridor});
+        edges[endNode].push_back({node, length, static_cast<Direction>(arrival), corridor});
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef TUNNEL_GRAPH_H
+#define TUNNEL_GRAPH_H
+
+#include <raylib-cpp.hpp>
+#include <vector>
+#include "GameEnums.h"
+#include "Grid.h"
+
+/**
+ * @brief Tunnel network compressed to junctions and the corridors between them
+ *
+ * Nodes are the tunnel tiles where a mover has a real choice to make:
+ * junctions (three or more exits) and dead ends (one or none). Every other
+ * tunnel tile has exactly two exits and belongs to a corridor, which is
+ * stored as one edge with its length. A closed loop without any junction
+ * gets one of its tiles promoted to a node. The graph is rebuilt in linear
+ * time whenever the grid version changes.
+ */
+class TunnelGraph
+{
+public:
+    /**
+     * @brief One corridor as seen from one of its end nodes
+     */
+    struct Edge
+    {
+        int toNode;          ///< Node at the far end
+        int length;          ///< Steps from this node to the far end
+        Direction direction; ///< First step out of this node
+        int corridor;        ///< Corridor the edge runs along
+    };
+
+    /**
+     * @brief Constructor for TunnelGraph
+     */
+    TunnelGraph();
+
+    /**
+     * @brief Bring the graph up to date with the grid
+     *
+     * Does nothing when the grid version has not changed since the last
+     * refresh.
+     * @param grid Reference to the game grid
+     */
+    void refresh(const Grid &grid);
+
+    /**
+     * @brief Get the node at a tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return Node index, or -1 if the tile is not a node
+     */
+    int getNodeId(int x, int y) const;
+
+    /**
+     * @brief Get the corridor through a tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return Corridor index, or -1 for nodes and non-tunnel tiles
+     */
+    int getCorridorId(int x, int y) const;
+
+    /**
+     * @brief Check if a tile is a node of the graph
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @return true for junctions and dead ends
+     */
+    bool isNode(int x, int y) const;
+
+    /**
+     * @brief Get the number of nodes
+     * @return Node count
+     */
+    int getNodeCount() const;
+
+    /**
+     * @brief Get the number of corridors
+     * @return Corridor count (one per edge pair)
+     */
+    int getCorridorCount() const;
+
+    /**
+     * @brief Get the tile of a node
+     * @param node Node index
+     * @return Tile in grid coordinates
+     */
+    Vector2 getNodeTile(int node) const;
+
+    /**
+     * @brief Get the corridors leaving a node
+     * @param node Node index
+     * @return Edges in UP, DOWN, LEFT, RIGHT order of their first step
+     */
+    const std::vector<Edge> &getEdges(int node) const;
+
+    /**
+     * @brief Get the two end nodes of a corridor
+     * @param corridor Corridor index
+     * @param nodeA Receives one end
+     * @param nodeB Receives the other end
+     */
+    void getCorridorEnds(int corridor, int &nodeA, int &nodeB) const;
+
+    /**
+     * @brief Get the way onward from a corridor tile
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @param heading Direction the mover arrived in
+     * @return The exit that does not lead back, or NONE off a corridor or without a heading
+     */
+    Direction continueCorridor(int x, int y, Direction heading) const;
+
+    /**
+     * @brief Get the grid version the graph describes
+     * @return Version stamp as of the last refresh (0 before the first)
+     */
+    unsigned int getGridVersion() const;
+
+private:
+    /**
+     * @brief End nodes and length of a corridor
+     */
+    struct Corridor
+    {
+        int nodeA;  ///< Node the corridor was traced from
+        int nodeB;  ///< Node it arrived at
+        int length; ///< Steps between the two nodes
+    };
+
+    int width;                            ///< Grid width the graph was built for
+    int height;                           ///< Grid height the graph was built for
+    unsigned int gridVersion;             ///< Grid version the graph describes
+    std::vector<unsigned char> exits;     ///< Per tile: bit d set if direction d leads into tunnel
+    std::vector<unsigned char> traced;    ///< Per node tile: bit d set once exit d has been followed
+    std::vector<int> nodeIds;             ///< Per tile: node index or -1
+    std::vector<int> corridorIds;         ///< Per tile: corridor index or -1
+    std::vector<int> nodeTiles;           ///< Per node: tile index
+    std::vector<std::vector<Edge>> edges; ///< Per node: corridors leaving it
+    std::vector<Corridor> corridors;      ///< Per corridor: ends and length
+
+    /**
+     * @brief Recompute the graph from scratch
+     * @param grid Reference to the game grid
+     */
+    void rebuild(const Grid &grid);
+
+    /**
+     * @brief Make a tile a node
+     * @param tile Tile index
+     */
+    void addNode(int tile);
+
+    /**
+     * @brief Follow every untraced exit of a node to the next node
+     * @param node Node index
+     */
+    void traceCorridors(int node);
+};
+
+#endif // TUNNEL_GRAPH_H
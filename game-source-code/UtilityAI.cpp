@@ -0,0 +1,158 @@
+#include "UtilityAI.h"
+#include "TacticalAI.h"
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    const int MOVE_COUNT = static_cast<int>(MoveConsideration::COUNT);
+    const int POSITION_COUNT = static_cast<int>(PositionConsideration::COUNT);
+
+    // Names used in weights files, in enum order
+    const char *const MOVE_NAMES[MOVE_COUNT] = {
+        "distance_gain", "alignment", "dead_end", "player_threat",
+        "fire_danger", "rock_danger", "crowding"};
+    const char *const POSITION_NAMES[POSITION_COUNT] = {
+        "fire_line_in_range", "fire_line_out_of_range", "aligned_with_player",
+        "too_far", "chokepoint"};
+
+    std::string trim(const std::string &text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return "";
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+}
+
+UtilityWeights::UtilityWeights()
+    : moves{100.0f, 50.0f, -30.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+      positions{100.0f, 60.0f, 40.0f, -20.0f, 30.0f}
+{
+}
+
+float UtilityWeights::get(MoveConsideration consideration) const
+{
+    return moves[static_cast<int>(consideration)];
+}
+
+float UtilityWeights::get(PositionConsideration consideration) const
+{
+    return positions[static_cast<int>(consideration)];
+}
+
+bool UtilityWeights::usesInfluence() const
+{
+    return get(MoveConsideration::PLAYER_THREAT) != 0.0f || get(MoveConsideration::FIRE_DANGER) != 0.0f ||
+           get(MoveConsideration::ROCK_DANGER) != 0.0f || get(MoveConsideration::CROWDING) != 0.0f;
+}
+
+void UtilityBatch::reset(int candidateCount)
+{
+    for (auto &values : columns)
+        values.assign(candidateCount, 0.0f);
+    scores.assign(candidateCount, 0.0f);
+}
+
+float *UtilityBatch::column(MoveConsideration consideration)
+{
+    return columns[static_cast<int>(consideration)].data();
+}
+
+const std::vector<float> &UtilityBatch::score(const UtilityWeights &weights)
+{
+    const int count = static_cast<int>(scores.size());
+    float *out = scores.data();
+
+    for (int c = 0; c < MOVE_COUNT; c++)
+    {
+        const float weight = weights.moves[c];
+        const float *values = columns[c].data();
+        for (int k = 0; k < count; k++)
+            out[k] += weight * values[k];
+    }
+
+    return scores;
+}
+
+UtilityWeights &UtilityAI::getWeights()
+{
+    static UtilityWeights weights;
+    return weights;
+}
+
+bool UtilityAI::parseWeights(const std::string &text, UtilityWeights &weights)
+{
+    UtilityWeights parsed = weights;
+    std::istringstream lines(text);
+    std::string line;
+
+    while (std::getline(lines, line))
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+            return false;
+
+        std::string name = trim(line.substr(0, equals));
+        std::istringstream valueText(line.substr(equals + 1));
+        float value = 0.0f;
+        std::string rest;
+        if (!(valueText >> value) || (valueText >> rest))
+            return false;
+
+        float *slot = nullptr;
+        for (int c = 0; c < MOVE_COUNT && !slot; c++)
+        {
+            if (name == MOVE_NAMES[c])
+                slot = &parsed.moves[c];
+        }
+        for (int c = 0; c < POSITION_COUNT && !slot; c++)
+        {
+            if (name == POSITION_NAMES[c])
+                slot = &parsed.positions[c];
+        }
+        if (!slot)
+            return false;
+
+        *slot = value;
+    }
+
+    weights = parsed;
+    return true;
+}
+
+bool UtilityAI::loadWeights(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parseWeights(contents.str(), getWeights());
+}
+
+void UtilityAI::sampleInfluence(int x, int y, const Grid &grid, float *values)
+{
+    const InfluenceMap &influence = TacticalAI::getInfluenceMap();
+    if (influence.getGridVersion() != grid.getVersion())
+        return;
+
+    values[static_cast<int>(MoveConsideration::PLAYER_THREAT)] = influence.getPlayerThreat(x, y) / 255.0f;
+    values[static_cast<int>(MoveConsideration::FIRE_DANGER)] = influence.getFireCoverage(x, y) / 255.0f;
+    values[static_cast<int>(MoveConsideration::ROCK_DANGER)] = influence.getRockDanger(x, y) / 255.0f;
+    values[static_cast<int>(MoveConsideration::CROWDING)] = influence.getMonsterDensity(x, y);
+}
+
+float UtilityAI::scoreMove(const float *values, const UtilityWeights &weights)
+{
+    float score = 0.0f;
+    for (int c = 0; c < MOVE_COUNT; c++)
+        score += weights.moves[c] * values[c];
+    return score;
+}
@@ -0,0 +1,151 @@
+#ifndef UTILITY_AI_H
+#define UTILITY_AI_H
+
+#include <string>
+#include <vector>
+#include "Grid.h"
+
+/**
+ * @brief Considerations weighed when choosing a move to a neighbouring tile
+ */
+enum class MoveConsideration
+{
+    DISTANCE_GAIN, // Tiles closer to the target (Manhattan)
+    ALIGNMENT,     // Dot product of the step with the way to the target, if positive
+    DEAD_END,      // 1 if the tile has at most one tunnel neighbour
+    PLAYER_THREAT, // Harpoon threat on the tile, 0 to 1
+    FIRE_DANGER,   // Fire in flight will pass the tile, 0 or 1
+    ROCK_DANGER,   // A loose rock may fall on the tile, 0 or 1
+    CROWDING,      // Monsters in the tile's 3x3 neighbourhood
+    COUNT
+};
+
+/**
+ * @brief Terms of the score of a tactical firing position
+ */
+enum class PositionConsideration
+{
+    FIRE_LINE_IN_RANGE,     // Clear fire line with the player in range
+    FIRE_LINE_OUT_OF_RANGE, // Clear fire line but the player too far
+    ALIGNED,                // Same row or column as the player
+    TOO_FAR,                // More than six tiles from the player
+    CHOKEPOINT,             // A chokepoint within six tiles of the player
+    COUNT
+};
+
+/**
+ * @brief Weights of every consideration
+ *
+ * The defaults reproduce the hand-tuned constants the scoring used before
+ * weights were data. The danger and crowding weights default to zero.
+ */
+struct UtilityWeights
+{
+    float moves[static_cast<int>(MoveConsideration::COUNT)];         ///< Per move consideration
+    float positions[static_cast<int>(PositionConsideration::COUNT)]; ///< Per position consideration
+
+    /**
+     * @brief Constructor, sets the default weights
+     */
+    UtilityWeights();
+
+    float get(MoveConsideration consideration) const;
+    float get(PositionConsideration consideration) const;
+
+    /**
+     * @brief Check if move scores depend on the per-tick influence layers
+     * @return true if any danger or crowding weight is non-zero
+     */
+    bool usesInfluence() const;
+};
+
+/**
+ * @brief Move considerations of many candidate moves in packed columns
+ *
+ * One contiguous float column per consideration, one entry per candidate.
+ * Scoring is a weighted sum taken a whole column at a time, so the inner
+ * loop is a multiply-add over contiguous floats that the compiler can
+ * vectorise. The sum runs in consideration order, exactly as
+ * UtilityAI::scoreMove() adds the terms of a single candidate, so both give
+ * bit-identical scores.
+ */
+class UtilityBatch
+{
+public:
+    /**
+     * @brief Set the number of candidates, zeroing every column (keeps capacity)
+     * @param candidateCount Number of candidates
+     */
+    void reset(int candidateCount);
+
+    /**
+     * @brief Get the column of one consideration for writing
+     * @param consideration Consideration
+     * @return Pointer to candidateCount floats
+     */
+    float *column(MoveConsideration consideration);
+
+    /**
+     * @brief Score every candidate
+     * @param weights Weights to apply
+     * @return One score per candidate
+     */
+    const std::vector<float> &score(const UtilityWeights &weights);
+
+private:
+    std::vector<float> columns[static_cast<int>(MoveConsideration::COUNT)]; ///< Consideration values
+    std::vector<float> scores;                                             ///< Weighted sums
+};
+
+/**
+ * @brief Shared utility-AI weights and the scoring of single candidates
+ */
+class UtilityAI
+{
+public:
+    /**
+     * @brief Get the weights every scorer uses
+     * @return Shared weights
+     */
+    static UtilityWeights &getWeights();
+
+    /**
+     * @brief Parse weights written as "name = value" lines
+     *
+     * Anything after a '#' is a comment and blank lines are ignored.
+     * Weights that are not mentioned keep their value in the output.
+     * @param text Contents of a weights file
+     * @param weights Receives the weights; untouched if the text has an error
+     * @return true if every line was a known weight with a numeric value
+     */
+    static bool parseWeights(const std::string &text, UtilityWeights &weights);
+
+    /**
+     * @brief Replace the shared weights with the ones in a file
+     * @param path Path of the weights file
+     * @return true if the file was read and parsed; the weights are unchanged otherwise
+     */
+    static bool loadWeights(const std::string &path);
+
+    /**
+     * @brief Fill the influence-based move considerations of a tile
+     *
+     * Reads TacticalAI::getInfluenceMap() when it describes the grid's
+     * current version, and leaves zeros otherwise.
+     * @param x Grid x coordinate
+     * @param y Grid y coordinate
+     * @param grid Reference to the game grid
+     * @param values Array of MoveConsideration::COUNT values to fill
+     */
+    static void sampleInfluence(int x, int y, const Grid &grid, float *values);
+
+    /**
+     * @brief Score one candidate move
+     * @param values One value per MoveConsideration
+     * @param weights Weights to apply
+     * @return Weighted sum, in consideration order
+     */
+    static float scoreMove(const float *values, const UtilityWeights &weights);
+};
+
+#endif // UTILITY_AI_H
@@ -1,4 +1,6 @@
 #include "Game.h"
+#include "UtilityAI.h"
+#include "BehaviorLibrary.h"
 #include <iostream>
 
 Game::Game()
@@ -21,6 +23,25 @@ void Game::init()
     // Set the target FPS
     window.SetTargetFPS(60);
 
+    // Load designer-tuned AI weights; the built-in defaults stand if the file is missing
+    if (UtilityAI::loadWeights("resources/ai_weights.txt") ||
+        UtilityAI::loadWeights("../resources/ai_weights.txt"))
+    {
+        std::cout << "AI weights loaded" << std::endl;
+    }
+
+    // Likewise the monster behavior trees; a broken file is reported and ignored
+    std::string behaviorError;
+    if (BehaviorLibrary::getShared().load("resources/behaviors.txt", behaviorError) ||
+        BehaviorLibrary::getShared().load("../resources/behaviors.txt", behaviorError))
+    {
+        std::cout << "Monster behaviors loaded" << std::endl;
+    }
+    else
+    {
+        std::cout << "Monster behaviors: " << behaviorError << std::endl;
+    }
+
     // Initialize the state manager
     stateManager.init();
 
@@ -6,7 +6,7 @@ Menu::Menu()
       selectedOption(0),
       gameWon(false)
 {
-    mainMenuOptions = {"Start Game", "Instructions", "Exit"};
+    mainMenuOptions = {"Start Game", "Start Game (Hard)", "Instructions", "Exit"};
     currentOptions = mainMenuOptions;
 }
 
@@ -66,12 +66,13 @@ void Menu::handleMainMenuInput()
         switch (selectedOption)
         {
         case 0: // Start Game
+        case 1: // Start Game (Hard)
             // This will be handled by GameStateManager
             break;
-        case 1: // Instructions
+        case 2: // Instructions
             currentState = MenuState::INSTRUCTIONS;
             break;
-        case 2: // Exit
+        case 3: // Exit
             // This will be handled by GameStateManager
             break;
         }
@@ -217,14 +218,19 @@ MenuState Menu::getMenuState() const
 bool Menu::shouldStartGame() const
 {
     return currentState == MenuState::MAIN_MENU &&
-           selectedOption == 0 &&
+           (selectedOption == 0 || selectedOption == 1) &&
            InputHandler::isEnterPressed();
 }
 
+bool Menu::isHardModeSelected() const
+{
+    return selectedOption == 1;
+}
+
 bool Menu::shouldExitGame() const
 {
     return currentState == MenuState::MAIN_MENU &&
-           selectedOption == 2 &&
+           selectedOption == 3 &&
            InputHandler::isEnterPressed();
 }
 
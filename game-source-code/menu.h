@@ -44,6 +44,12 @@ public:
      */
     bool shouldStartGame() const;
 
+    /**
+     * @brief Check if the selected game is the hard one
+     * @return true if the hard start option is selected
+     */
+    bool isHardModeSelected() const;
+
     /**
      * @brief Check if the game should exit
      * @return true if the game should exit, false otherwise
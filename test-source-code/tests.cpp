@@ -1,6 +1,12 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include <raylib-cpp.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <thread>
 
 // Include headers for classes we want to test
 #include "Grid.h"
@@ -17,6 +23,29 @@
 #include "Fire.h"
 #include "CollisionManager.h"
 #include "MonsterManager.h"
+#include "PathFinding.h"
+#include "BatchDirectionSolver.h"
+#include "PathRequestQueue.h"
+#include "DStarLite.h"
+#include "ChokepointMap.h"
+#include "TunnelGraph.h"
+#include "TunnelDistanceTable.h"
+#include "TacticalAI.h"
+#include "InfluenceMap.h"
+#include "UtilityAI.h"
+#include "AIScheduler.h"
+#include "BehaviorTree.h"
+#include "BehaviorLibrary.h"
+#include "LookaheadSearch.h"
+#include "PerceptionBlackboard.h"
+#include "DisembodimentScheduler.h"
+#include "DecisionPipeline.h"
+#include "BehaviorScript.h"
+#include "ScriptScheduler.h"
+#include "MonsterScripts.h"
+#include "TimerWheel.h"
+#include "SpatialHash.h"
+#include "DecisionTrace.h"
 
 // ==================== GRID TESTS ====================
 
@@ -120,6 +149,61 @@ TEST_CASE("Grid converts grid to world coordinates correctly")
     CHECK(worldPos.y == 64.0f);
 }
 
+TEST_CASE("Grid version changes only when a tile changes type")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    unsigned int initialVersion = grid.getVersion();
+
+    // Act & Assert
+    grid.setTile(2, 2, TileType::EARTH);
+    CHECK(grid.getVersion() == initialVersion);
+
+    grid.digTunnel(2, 2);
+    CHECK(grid.getVersion() != initialVersion);
+}
+
+TEST_CASE("Grid run index tracks unbroken tunnel spans")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 2; x <= 7; x++)
+        grid.digTunnel(x, 4);
+
+    // Act & Assert
+    CHECK(grid.isClearRow(4, 2, 7) == true);
+    CHECK(grid.isClearRow(4, 7, 3) == true);
+    CHECK(grid.isClearRow(4, 1, 7) == false);
+    CHECK(grid.isClearColumn(5, 4, 4) == true);
+    CHECK(grid.isClearColumn(5, 3, 4) == false);
+
+    grid.setTile(5, 4, TileType::ROCK);
+    CHECK(grid.isClearRow(4, 2, 7) == false);
+    CHECK(grid.isClearRow(4, 2, 4) == true);
+
+    grid.digTunnel(5, 3);
+    CHECK(grid.isClearColumn(5, 3, 3) == true);
+}
+
+TEST_CASE("Grid reports the tiles changed since a version")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    unsigned int before = grid.getVersion();
+    grid.digTunnel(1, 1);
+    grid.digTunnel(2, 1);
+    std::vector<std::pair<int, int>> changes;
+
+    // Act
+    bool covered = grid.getChangesSince(before, changes);
+
+    // Assert
+    CHECK(covered == true);
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0] == std::make_pair(1, 1));
+    CHECK(changes[1] == std::make_pair(2, 1));
+}
+
 // ==================== MENU TESTS ====================
 
 TEST_CASE("Menu initializes in main menu state")
@@ -1066,3 +1150,2039 @@ TEST_CASE("CollisionManager deactivates harpoon after hit")
     // Assert
     CHECK(player.getHarpoon().isHarpoonActive() == false);
 }
+
+// ==================== PATHFINDING TESTS ====================
+
+TEST_CASE("PathFinding picks the direction that closes distance along a tunnel")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    auto canMoveFunc = [&grid](Vector2 pos)
+    {
+        Vector2 gridPos = grid.worldToGrid(pos);
+        return grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    };
+
+    // Act
+    Direction direction = PathFinding::findBestDirectionToTarget(
+        grid.gridToWorld(4, 5), grid.gridToWorld(8, 5), grid, canMoveFunc);
+
+    // Assert
+    CHECK(direction == Direction::RIGHT);
+}
+
+TEST_CASE("PathFinding returns NONE when no move is allowed")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+
+    // Act
+    Direction best = PathFinding::findBestDirectionToTarget(
+        grid.gridToWorld(4, 5), grid.gridToWorld(8, 5), grid, [](Vector2)
+        { return false; });
+    Direction random = PathFinding::findRandomValidDirection(
+        grid.gridToWorld(4, 5), grid, [](Vector2)
+        { return false; });
+
+    // Assert
+    CHECK(best == Direction::NONE);
+    CHECK(random == Direction::NONE);
+}
+
+TEST_CASE("PathFinding direct path requires every tile to pass the check")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    auto isTunnel = [&grid](int x, int y)
+    { return grid.isTunnel(x, y); };
+
+    // Act & Assert
+    CHECK(PathFinding::hasDirectPath(grid.gridToWorld(2, 5), grid.gridToWorld(7, 5), grid, isTunnel) == true);
+
+    grid.setTile(5, 5, TileType::ROCK);
+    CHECK(PathFinding::hasDirectPath(grid.gridToWorld(2, 5), grid.gridToWorld(7, 5), grid, isTunnel) == false);
+}
+
+TEST_CASE("PathFinding cache answers repeated queries and invalidates on dig")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    int probes = 0;
+    auto canMoveFunc = [&grid, &probes](Vector2 pos)
+    {
+        probes++;
+        Vector2 gridPos = grid.worldToGrid(pos);
+        return grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    };
+    PathFinding::getDirectionCache().clear();
+    Vector2 start = grid.gridToWorld(4, 5);
+    Vector2 target = grid.gridToWorld(4, 2);
+
+    // Act
+    Direction first = PathFinding::findBestDirectionCached(start, target, grid, MonsterState::IN_TUNNEL, canMoveFunc);
+    int probesAfterFirst = probes;
+    Direction second = PathFinding::findBestDirectionCached(start, target, grid, MonsterState::IN_TUNNEL, canMoveFunc);
+
+    // Assert
+    CHECK(second == first);
+    CHECK(probes == probesAfterFirst);
+    CHECK(PathFinding::getDirectionCache().getHits() == 1);
+
+    // Act - open a tunnel toward the target
+    grid.digTunnel(4, 4);
+    Direction afterDig = PathFinding::findBestDirectionCached(start, target, grid, MonsterState::IN_TUNNEL, canMoveFunc);
+
+    // Assert
+    CHECK(afterDig == Direction::UP);
+    CHECK(probes > probesAfterFirst);
+}
+
+TEST_CASE("PathFinding tunnel line index matches tile-by-tile stepping")
+{
+    // Arrange
+    Grid grid(12, 10, 32);
+    for (int x = 0; x < 12; x++)
+        grid.digTunnel(x, 3);
+    for (int y = 0; y < 10; y++)
+        grid.digTunnel(6, y);
+    grid.setTile(9, 3, TileType::ROCK);
+    auto isTunnel = [&grid](int x, int y)
+    { return grid.isTunnel(x, y); };
+
+    // Act & Assert
+    for (int fromX = 0; fromX < 12; fromX++)
+    {
+        for (int toX = 0; toX < 12; toX++)
+        {
+            for (int toY = 0; toY < 10; toY++)
+            {
+                Vector2 from = {fromX * 32.0f + 5.0f, 3 * 32.0f};
+                Vector2 to = grid.gridToWorld(toX, toY);
+                CHECK(PathFinding::hasDirectTunnelPath(from, to, grid) ==
+                      PathFinding::hasDirectPath(from, to, grid, isTunnel));
+            }
+        }
+    }
+}
+
+TEST_CASE("BatchDirectionSolver agrees with per-monster pathfinding")
+{
+    // Arrange - a mixed layout of tunnels, earth and rock
+    Grid grid(12, 10, 32);
+    for (int y = 0; y < 10; y++)
+    {
+        for (int x = 0; x < 12; x++)
+        {
+            int pattern = (x * 7 + y * 3 + x * y) % 5;
+            if (pattern < 3)
+                grid.setTile(x, y, TileType::TUNNEL);
+            else if (pattern == 4)
+                grid.setTile(x, y, TileType::ROCK);
+        }
+    }
+    Vector2 target = grid.gridToWorld(6, 4);
+    BatchDirectionSolver solver;
+    std::vector<Monster> monsters;
+    for (int y = 0; y < 10; y++)
+    {
+        for (int x = 0; x < 12; x++)
+        {
+            MonsterState state = (x + y) % 2 == 0 ? MonsterState::IN_TUNNEL : MonsterState::DISEMBODIED;
+            monsters.emplace_back(grid.gridToWorld(x, y), state);
+            solver.addQuery(grid.gridToWorld(x, y), target, state, grid);
+        }
+    }
+
+    // Act
+    const std::vector<Direction> &directions = solver.solve(grid);
+
+    // Assert
+    REQUIRE(directions.size() == monsters.size());
+    for (size_t i = 0; i < monsters.size(); i++)
+    {
+        const Monster &monster = monsters[i];
+        Direction expected = PathFinding::findBestDirectionToTarget(
+            monster.getPosition(), target, grid, [&monster, &grid](Vector2 pos)
+            { return monster.canMoveTo(pos, grid); });
+        CHECK(directions[i] == expected);
+    }
+}
+
+TEST_CASE("BatchDirectionSolver rejects positions between tiles")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    BatchDirectionSolver solver;
+
+    // Act
+    int index = solver.addQuery({40.0f, 64.0f}, {0.0f, 0.0f}, MonsterState::IN_TUNNEL, grid);
+
+    // Assert
+    CHECK(index == -1);
+    CHECK(solver.getQueryCount() == 0);
+}
+
+TEST_CASE("PathFinding shortest route goes around a dead end")
+{
+    // Arrange - the direct way right is a dead end; the route loops up and over
+    Grid grid(10, 10, 32);
+    for (int x = 2; x <= 5; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    for (int y = 2; y <= 5; y++)
+        grid.setTile(2, y, TileType::TUNNEL);
+    for (int x = 2; x <= 8; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    for (int y = 2; y <= 5; y++)
+        grid.setTile(8, y, TileType::TUNNEL);
+
+    // Act
+    Direction first = PathFinding::findShortestPathDirection(3, 5, 8, 5, grid, MonsterState::IN_TUNNEL);
+    Direction unreachable = PathFinding::findShortestPathDirection(3, 5, 0, 0, grid, MonsterState::IN_TUNNEL);
+
+    // Assert
+    CHECK(first == Direction::LEFT);
+    CHECK(unreachable == Direction::NONE);
+}
+
+TEST_CASE("PathRequestQueue delivers lockstep results on the next tick")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    PathRequestQueue queue;
+    queue.setLockstep(true);
+
+    // Act
+    int ticket = queue.postRequest(grid.gridToWorld(2, 5), grid.gridToWorld(7, 5), MonsterState::IN_TUNNEL, grid);
+    Direction result = Direction::NONE;
+    bool availableSameTick = queue.pollResult(ticket, result);
+    queue.advanceTick(grid);
+
+    // Assert
+    CHECK(availableSameTick == false);
+    CHECK(queue.pollResult(ticket, result) == true);
+    CHECK(result == Direction::RIGHT);
+    CHECK(queue.isPending(ticket) == false);
+}
+
+TEST_CASE("PathRequestQueue drops requests when the grid changes")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    PathRequestQueue queue;
+    queue.setLockstep(true);
+    int ticket = queue.postRequest(grid.gridToWorld(2, 5), grid.gridToWorld(7, 5), MonsterState::IN_TUNNEL, grid);
+
+    // Act
+    grid.digTunnel(4, 4);
+    queue.advanceTick(grid);
+
+    // Assert
+    Direction result = Direction::NONE;
+    CHECK(queue.pollResult(ticket, result) == false);
+    CHECK(queue.isPending(ticket) == false);
+}
+
+TEST_CASE("PathRequestQueue drops searches that finish against an old layout")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    PathRequestQueue queue;
+    int ticket = queue.postRequest(grid.gridToWorld(2, 5), grid.gridToWorld(7, 3), MonsterState::IN_TUNNEL, grid);
+
+    // Act - the search may be queued, running or done when the grid changes
+    grid.digTunnel(7, 4);
+    grid.digTunnel(7, 3);
+    for (int tick = 0; tick < 1000 && queue.isPending(ticket); tick++)
+    {
+        queue.advanceTick(grid);
+        if (queue.isPending(ticket))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Assert
+    Direction result = Direction::NONE;
+    CHECK(queue.isPending(ticket) == false);
+    CHECK(queue.pollResult(ticket, result) == false);
+}
+
+TEST_CASE("Monster keeps moving while its asynchronous route is worked out")
+{
+    // Arrange - the player stands in earth, off the tunnel distance table
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    PathRequestQueue queue;
+    queue.setLockstep(true);
+    Monster monster(grid.gridToWorld(6, 5), MonsterState::IN_TUNNEL);
+    monster.setPathRequestQueue(&queue);
+    Player player(grid.gridToWorld(4, 6));
+
+    // Act - think once the AI timer is due, then let the answer arrive mid-step
+    for (int frame = 0; frame < 200 && !monster.isAwaitingRoute(); frame++)
+    {
+        monster.update();
+        monster.updateAI(player, grid, false);
+    }
+    bool waited = monster.isAwaitingRoute();
+    bool movedWhileWaiting = monster.getTargetPosition().x == grid.gridToWorld(5, 5).x;
+    queue.advanceTick(grid);
+    monster.resumeRoute(grid);
+    for (int frame = 0; frame < 60; frame++)
+    {
+        monster.update();
+        monster.resumeRoute(grid);
+    }
+
+    // Assert - the answer for the tile it was heading to is taken there
+    CHECK(waited == true);
+    CHECK(movedWhileWaiting == true);
+    CHECK(monster.isAwaitingRoute() == false);
+    CHECK(monster.getPosition().x == grid.gridToWorld(4, 5).x);
+}
+
+TEST_CASE("DStarLite repairs its route incrementally when a shortcut is dug")
+{
+    // Arrange - a U-shaped tunnel from (1,5) round to (7,5)
+    Grid grid(10, 10, 32);
+    for (int y = 2; y <= 5; y++)
+    {
+        grid.setTile(1, y, TileType::TUNNEL);
+        grid.setTile(7, y, TileType::TUNNEL);
+    }
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    DStarLite planner;
+    Vector2 start = grid.gridToWorld(1, 5);
+    Vector2 goal = grid.gridToWorld(7, 5);
+
+    // Act
+    Direction initial = planner.nextStep(start, goal, grid, MonsterState::IN_TUNNEL);
+    bool initialIncremental = planner.wasLastQueryIncremental();
+    for (int x = 2; x <= 6; x++)
+        grid.digTunnel(x, 5);
+    Direction repaired = planner.nextStep(start, goal, grid, MonsterState::IN_TUNNEL);
+
+    // Assert
+    CHECK(initial == Direction::UP);
+    CHECK(initialIncremental == false);
+    CHECK(repaired == Direction::RIGHT);
+    CHECK(planner.wasLastQueryIncremental() == true);
+}
+
+TEST_CASE("DStarLite keeps its plan while the player walks")
+{
+    // Arrange - an L-shaped tunnel: along row 5, then up column 8
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 8; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    for (int y = 1; y <= 5; y++)
+        grid.setTile(8, y, TileType::TUNNEL);
+    DStarLite planner;
+    Vector2 start = grid.gridToWorld(1, 5);
+    planner.nextStep(start, grid.gridToWorld(7, 5), grid, MonsterState::IN_TUNNEL);
+
+    // Act - the player walks round the corner and up, one tile per query
+    bool allIncremental = true;
+    bool allRight = true;
+    for (int y = 5; y >= 1; y--)
+    {
+        Direction step = planner.nextStep(start, grid.gridToWorld(8, y), grid, MonsterState::IN_TUNNEL);
+        allIncremental = allIncremental && planner.wasLastQueryIncremental();
+        allRight = allRight && step == Direction::RIGHT;
+    }
+    Direction atCorner = planner.nextStep(grid.gridToWorld(8, 5), grid.gridToWorld(8, 1), grid, MonsterState::IN_TUNNEL);
+
+    // Assert
+    CHECK(allIncremental);
+    CHECK(allRight);
+    CHECK(atCorner == Direction::UP);
+    CHECK(planner.wasLastQueryIncremental() == true);
+}
+
+TEST_CASE("DStarLite starts over on a different grid")
+{
+    // Arrange - the second grid's change log covers the version the plan was made at
+    Grid other(10, 10, 32);
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    DStarLite planner;
+    Vector2 start = grid.gridToWorld(1, 5);
+    Vector2 goal = grid.gridToWorld(7, 5);
+    planner.nextStep(start, goal, grid, MonsterState::IN_TUNNEL);
+
+    // Act - the other grid only has the first three tiles of that tunnel
+    for (int x = 1; x <= 3; x++)
+        other.digTunnel(x, 5);
+    Direction step = planner.nextStep(start, goal, other, MonsterState::IN_TUNNEL);
+
+    // Assert
+    CHECK(planner.wasLastQueryIncremental() == false);
+    CHECK(step == Direction::NONE);
+}
+
+TEST_CASE("GreenDragon chases along a planned route")
+{
+    // Arrange - the greedy step from (3,5) leads into a dead end at (4,5)
+    Grid grid(10, 10, 32);
+    for (int x = 2; x <= 4; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    for (int y = 2; y <= 5; y++)
+    {
+        grid.setTile(2, y, TileType::TUNNEL);
+        grid.setTile(6, y, TileType::TUNNEL);
+    }
+    for (int x = 2; x <= 6; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    GreenDragon dragon(grid.gridToWorld(3, 5));
+    Player player(grid.gridToWorld(6, 5));
+
+    // Act - think once, without any chance to breathe fire through the earth
+    for (int frame = 0; frame < 13; frame++)
+    {
+        dragon.update();
+        dragon.updateAI(player, grid, false);
+    }
+    for (int frame = 0; frame < 60; frame++)
+        dragon.update();
+
+    // Assert
+    CHECK(dragon.plansRoutes() == true);
+    CHECK(dragon.getPosition().x == grid.gridToWorld(2, 5).x);
+}
+
+// Two 2x2 tunnel loops joined by a three-tile corridor along row 1
+static void digDumbbell(Grid &grid)
+{
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 1, TileType::TUNNEL);
+    grid.setTile(1, 2, TileType::TUNNEL);
+    grid.setTile(2, 2, TileType::TUNNEL);
+    grid.setTile(6, 2, TileType::TUNNEL);
+    grid.setTile(7, 2, TileType::TUNNEL);
+}
+
+TEST_CASE("ChokepointMap finds the chokepoints and bridges of the tunnels")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    digDumbbell(grid);
+    ChokepointMap chokepoints;
+
+    // Act
+    chokepoints.refresh(grid);
+
+    // Assert
+    CHECK(chokepoints.getChokepointCount() == 5);
+    for (int x = 2; x <= 6; x++)
+        CHECK(chokepoints.isChokepoint(x, 1) == true);
+    CHECK(chokepoints.isChokepoint(1, 1) == false);
+    CHECK(chokepoints.isChokepoint(7, 2) == false);
+    CHECK(chokepoints.isBridge(2, 1, Direction::RIGHT) == true);
+    CHECK(chokepoints.isBridge(6, 1, Direction::LEFT) == true);
+    CHECK(chokepoints.isBridge(1, 1, Direction::RIGHT) == false);
+    CHECK(chokepoints.isBridge(1, 1, Direction::DOWN) == false);
+}
+
+TEST_CASE("ChokepointMap updates when a bypass is dug")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    digDumbbell(grid);
+    ChokepointMap chokepoints;
+    chokepoints.refresh(grid);
+
+    // Act - a parallel corridor along row 2 closes one big loop
+    for (int x = 3; x <= 5; x++)
+        grid.digTunnel(x, 2);
+    chokepoints.refresh(grid);
+
+    // Assert
+    CHECK(chokepoints.getGridVersion() == grid.getVersion());
+    CHECK(chokepoints.getChokepointCount() == 0);
+    CHECK(chokepoints.isBridge(3, 1, Direction::RIGHT) == false);
+}
+
+TEST_CASE("TacticalAI ambushes only at chokepoints near the player")
+{
+    // Arrange
+    Grid grid(20, 10, 32);
+    digDumbbell(grid);
+    Vector2 corridor = grid.gridToWorld(4, 1);
+    Vector2 loop = grid.gridToWorld(1, 2);
+    auto canMoveFunc = [&grid](Vector2 pos)
+    {
+        Vector2 gridPos = grid.worldToGrid(pos);
+        return grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    };
+
+    // Act & Assert
+    CHECK(TacticalAI::isAmbushPosition(corridor, grid.gridToWorld(7, 2), grid, 6) == true);
+    CHECK(TacticalAI::isAmbushPosition(corridor, grid.gridToWorld(18, 8), grid, 6) == false);
+    CHECK(TacticalAI::isAmbushPosition(loop, grid.gridToWorld(7, 2), grid, 6) == false);
+    CHECK(TacticalAI::findAmbushDirection(loop, grid.gridToWorld(7, 2), grid, canMoveFunc, 6) == Direction::NONE);
+    CHECK(TacticalAI::findAmbushDirection(grid.gridToWorld(1, 1), grid.gridToWorld(7, 2), grid, canMoveFunc, 6) ==
+          Direction::RIGHT);
+}
+
+TEST_CASE("TacticalAI plans the way to the nearest tile with a shot at the player")
+{
+    // Arrange - a bent corridor; only the tiles below (6,5) are in range with a clear line
+    Grid grid(10, 12, 32);
+    for (int x = 1; x <= 6; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    for (int y = 3; y <= 9; y++)
+        grid.setTile(6, y, TileType::TUNNEL);
+    Vector2 playerPos = grid.gridToWorld(6, 9);
+    auto canMoveFunc = [&grid](Vector2 pos)
+    {
+        Vector2 gridPos = grid.worldToGrid(pos);
+        return grid.isTunnel(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    };
+    auto hasFireLineFunc = [&grid, playerPos](Vector2 pos)
+    { return PathFinding::hasDirectTunnelPath(pos, playerPos, grid); };
+
+    // Act
+    FirePositionPlan plan = TacticalAI::planFirePosition(grid.gridToWorld(1, 2), playerPos, grid, canMoveFunc,
+                                                         hasFireLineFunc, 128.0f);
+    FirePositionPlan outOfReach = TacticalAI::planFirePosition(grid.gridToWorld(1, 2), playerPos, grid, canMoveFunc,
+                                                               hasFireLineFunc, 128.0f, 7);
+    FirePositionPlan inPlace = TacticalAI::planFirePosition(grid.gridToWorld(6, 6), playerPos, grid, canMoveFunc,
+                                                            hasFireLineFunc, 128.0f);
+
+    // Assert - eight steps: along the top, then down the column
+    CHECK(plan.steps == 8);
+    CHECK(plan.firstStep == Direction::RIGHT);
+    CHECK(plan.tileX == 6);
+    CHECK(plan.tileY == 5);
+    CHECK(outOfReach.steps == -1);
+    CHECK(outOfReach.firstStep == Direction::NONE);
+    CHECK(inPlace.steps == 0);
+    CHECK(inPlace.firstStep == Direction::NONE);
+}
+
+TEST_CASE("TunnelGraph compresses a bent corridor into one edge")
+{
+    // Arrange - dead ends at (1,1) and (5,4), bending at (5,1)
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 5; x++)
+        grid.setTile(x, 1, TileType::TUNNEL);
+    for (int y = 2; y <= 4; y++)
+        grid.setTile(5, y, TileType::TUNNEL);
+    TunnelGraph graph;
+
+    // Act
+    graph.refresh(grid);
+
+    // Assert
+    REQUIRE(graph.getNodeCount() == 2);
+    CHECK(graph.getCorridorCount() == 1);
+    int start = graph.getNodeId(1, 1);
+    REQUIRE(start != -1);
+    REQUIRE(graph.getEdges(start).size() == 1);
+    CHECK(graph.getEdges(start)[0].toNode == graph.getNodeId(5, 4));
+    CHECK(graph.getEdges(start)[0].length == 7);
+    CHECK(graph.getEdges(start)[0].direction == Direction::RIGHT);
+    CHECK(graph.getCorridorId(3, 1) == graph.getEdges(start)[0].corridor);
+    CHECK(graph.continueCorridor(5, 1, Direction::RIGHT) == Direction::DOWN);
+    CHECK(graph.continueCorridor(5, 1, Direction::UP) == Direction::LEFT);
+}
+
+TEST_CASE("TunnelGraph splits a corridor when a side tunnel is dug")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 5; x++)
+        grid.setTile(x, 1, TileType::TUNNEL);
+    TunnelGraph graph;
+    graph.refresh(grid);
+
+    // Act
+    grid.digTunnel(3, 2);
+    graph.refresh(grid);
+
+    // Assert
+    CHECK(graph.isNode(3, 1) == true);
+    CHECK(graph.getNodeCount() == 4);
+    CHECK(graph.getCorridorCount() == 3);
+    CHECK(graph.getEdges(graph.getNodeId(3, 1)).size() == 3);
+}
+
+TEST_CASE("TunnelGraph gives a junctionless loop a single node")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    grid.setTile(2, 2, TileType::TUNNEL);
+    grid.setTile(3, 2, TileType::TUNNEL);
+    grid.setTile(2, 3, TileType::TUNNEL);
+    grid.setTile(3, 3, TileType::TUNNEL);
+    TunnelGraph graph;
+
+    // Act
+    graph.refresh(grid);
+
+    // Assert
+    REQUIRE(graph.getNodeCount() == 1);
+    CHECK(graph.getCorridorCount() == 1);
+    REQUIRE(graph.getEdges(0).size() == 2);
+    CHECK(graph.getEdges(0)[0].toNode == 0);
+    CHECK(graph.getEdges(0)[0].length == 4);
+}
+
+TEST_CASE("Monster keeps going along a corridor without re-deciding")
+{
+    // Arrange - a long corridor, with the player far off in the earth
+    Grid grid(12, 10, 32);
+    for (int x = 1; x <= 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Monster monster(grid.gridToWorld(2, 5), MonsterState::IN_TUNNEL);
+    Player player(grid.gridToWorld(11, 9));
+    for (int frame = 0; frame < 150; frame++)
+        monster.update();
+    monster.move(Direction::RIGHT, grid);
+    for (int frame = 0; frame < 30; frame++)
+        monster.update();
+
+    // Act
+    bool committed = monster.isCommittedToCorridor(player.getPosition(), grid);
+    monster.updateAI(player, grid, false);
+    for (int frame = 0; frame < 30; frame++)
+        monster.update();
+
+    // Assert
+    CHECK(committed == true);
+    CHECK(monster.getPosition().x == grid.gridToWorld(4, 5).x);
+    CHECK(monster.isCommittedToCorridor(grid.gridToWorld(1, 5), grid) == false);
+}
+
+TEST_CASE("TunnelDistanceTable gives tunnel distances and next hops")
+{
+    // Arrange - a U-shaped tunnel from (1,5) round to (7,5)
+    Grid grid(10, 10, 32);
+    for (int y = 2; y <= 5; y++)
+    {
+        grid.setTile(1, y, TileType::TUNNEL);
+        grid.setTile(7, y, TileType::TUNNEL);
+    }
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    TunnelDistanceTable table;
+
+    // Act
+    table.refresh(grid);
+
+    // Assert
+    CHECK(table.getDistance(1, 5, 7, 5) == 12);
+    CHECK(table.getNextHop(1, 5, 7, 5) == Direction::UP);
+    CHECK(table.getNextHop(7, 5, 7, 5) == Direction::NONE);
+    CHECK(table.getDistance(1, 5, 4, 5) == -1);
+    CHECK(table.getNextHop(1, 5, 4, 5) == Direction::NONE);
+    CHECK(table.wasLastRefreshIncremental() == false);
+}
+
+TEST_CASE("TunnelDistanceTable folds in a dug shortcut without rebuilding")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int y = 2; y <= 5; y++)
+    {
+        grid.setTile(1, y, TileType::TUNNEL);
+        grid.setTile(7, y, TileType::TUNNEL);
+    }
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    TunnelDistanceTable table;
+    table.refresh(grid);
+
+    // Act
+    for (int x = 2; x <= 6; x++)
+        grid.digTunnel(x, 5);
+    table.refresh(grid);
+
+    // Assert
+    CHECK(table.wasLastRefreshIncremental() == true);
+    CHECK(table.getGridVersion() == grid.getVersion());
+    CHECK(table.getDistance(1, 5, 7, 5) == 6);
+    CHECK(table.getNextHop(1, 5, 7, 5) == Direction::RIGHT);
+    CHECK(table.getDistance(1, 3, 7, 3) == 8);
+}
+
+TEST_CASE("TunnelDistanceTable rebuilds when a tunnel is filled in")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    TunnelDistanceTable table;
+    table.refresh(grid);
+
+    // Act
+    grid.setTile(4, 5, TileType::ROCK);
+    table.refresh(grid);
+
+    // Assert
+    CHECK(table.wasLastRefreshIncremental() == false);
+    CHECK(table.getDistance(1, 5, 7, 5) == -1);
+    CHECK(table.getDistance(1, 5, 3, 5) == 2);
+}
+
+TEST_CASE("TunnelDistanceTable rebuilds for a different grid rather than patching")
+{
+    // Arrange - the second grid's change log covers the version the table was built at
+    Grid other(10, 10, 32);
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 7; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    TunnelDistanceTable table;
+    table.refresh(grid);
+
+    // Act
+    for (int x = 1; x <= 3; x++)
+        other.digTunnel(x, 5);
+    table.refresh(other);
+
+    // Assert
+    CHECK(table.wasLastRefreshIncremental() == false);
+    CHECK(table.getDistance(1, 5, 7, 5) == -1);
+    CHECK(table.getDistance(1, 5, 3, 5) == 2);
+}
+
+// ==================== MONSTER STORE TESTS ====================
+
+TEST_CASE("MonsterManager store mirrors the monster list")
+{
+    // Arrange
+    MonsterManager monsterManager;
+    auto &monsters = monsterManager.getMonsters();
+    monsters.push_back(std::make_unique<Monster>(Vector2{64, 64}, MonsterState::IN_TUNNEL));
+    monsters.push_back(std::make_unique<GreenDragon>(Vector2{128, 64}));
+    monsters.push_back(std::make_unique<Monster>(Vector2{192, 64}, MonsterState::DISEMBODIED));
+
+    // Act
+    const MonsterStore &store = monsterManager.getStore();
+
+    // Assert
+    REQUIRE(store.size() == 3);
+    CHECK(store.getPosition(1).x == 128);
+    CHECK(store.getKind(0) == MonsterKind::BASIC);
+    CHECK(store.getKind(1) == MonsterKind::GREEN_DRAGON);
+    CHECK(store.getState(2) == MonsterState::DISEMBODIED);
+    CHECK(store.countAlive() == 3);
+    CHECK(store.countInState(MonsterState::DISEMBODIED) == 1);
+}
+
+TEST_CASE("MonsterManager kills through the store and the monster alike")
+{
+    // Arrange
+    MonsterManager monsterManager;
+    auto &monsters = monsterManager.getMonsters();
+    monsters.push_back(std::make_unique<Monster>(Vector2{64, 64}, MonsterState::IN_TUNNEL));
+    monsters.push_back(std::make_unique<Monster>(Vector2{70, 64}, MonsterState::IN_TUNNEL));
+    Rectangle probe = {60, 60, 12, 8};
+
+    // Act
+    int first = monsterManager.getStore().findOverlapping(probe);
+    monsterManager.killMonster(first);
+
+    // Assert
+    CHECK(first == 0);
+    CHECK(monsters[0]->isDead() == true);
+    CHECK(monsterManager.getStore().isAlive(0) == false);
+    CHECK(monsterManager.getStore().findOverlapping(probe) == 1);
+    CHECK(monsterManager.areAllMonstersDead() == false);
+}
+
+TEST_CASE("Monsters carry their kind tag")
+{
+    // Arrange & Act
+    Monster monster({0, 0}, MonsterState::IN_TUNNEL);
+    RedMonster red({0, 0});
+    GreenDragon dragon({0, 0});
+
+    // Assert
+    CHECK(monster.getKind() == MonsterKind::BASIC);
+    CHECK(red.getKind() == MonsterKind::RED);
+    CHECK(dragon.getKind() == MonsterKind::GREEN_DRAGON);
+}
+
+TEST_CASE("MonsterManager lists only fire that is in flight")
+{
+    // Arrange
+    MonsterManager monsterManager;
+    auto &monsters = monsterManager.getMonsters();
+    monsters.push_back(std::make_unique<Monster>(Vector2{64, 64}, MonsterState::IN_TUNNEL));
+    monsters.push_back(std::make_unique<GreenDragon>(Vector2{128, 64}));
+    monsters.push_back(std::make_unique<GreenDragon>(Vector2{256, 64}));
+    GreenDragon &breathing = static_cast<GreenDragon &>(*monsters[2]);
+
+    // Act
+    size_t before = monsterManager.getActiveFires().size();
+    breathing.breatheFire(Vector2{384, 64});
+    const std::vector<Fire *> &fires = monsterManager.getActiveFires();
+
+    // Assert
+    CHECK(before == 0);
+    REQUIRE(fires.size() == 1);
+    CHECK(fires[0] == &breathing.getFire());
+}
+
+// ==================== AI SCHEDULER TESTS ====================
+
+TEST_CASE("AIScheduler runs nearest decisions first and carries the rest over")
+{
+    // Arrange
+    AIScheduler scheduler;
+    scheduler.setFrameBudget(0); // One decision per frame
+    std::vector<int> order;
+    auto think = [&order](int id)
+    { order.push_back(id); };
+
+    scheduler.request(0, 300.0f);
+    scheduler.request(1, 50.0f);
+    scheduler.request(2, 120.0f);
+
+    // Act
+    int firstFrame = scheduler.runFrame(think);
+    scheduler.request(3, 10.0f); // Fresh and closest, but the carried-over work goes first
+    scheduler.runFrame(think);
+    scheduler.runFrame(think);
+    scheduler.runFrame(think);
+
+    // Assert
+    CHECK(firstFrame == 1);
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 2);
+    CHECK(order[2] == 0);
+    CHECK(order[3] == 3);
+    CHECK(scheduler.getPendingCount() == 0);
+}
+
+TEST_CASE("AIScheduler stretches the think interval under load and relaxes afterwards")
+{
+    // Arrange
+    AIScheduler scheduler;
+    scheduler.setFrameBudget(0);
+    auto think = [](int) {};
+
+    // Act
+    for (int id = 0; id < 6; id++)
+        scheduler.request(id, static_cast<float>(id));
+    scheduler.request(2, 1000.0f); // Already queued: only its priority changes
+    int queued = scheduler.getPendingCount();
+    scheduler.runFrame(think);
+    scheduler.runFrame(think);
+    float loaded = scheduler.getIntervalStretch();
+
+    while (scheduler.getPendingCount() > 0)
+        scheduler.runFrame(think);
+    for (int frame = 0; frame < 100; frame++)
+        scheduler.runFrame(think);
+
+    // Assert
+    CHECK(queued == 6);
+    CHECK(loaded > 1.0f);
+    CHECK(loaded <= AIScheduler::MAX_INTERVAL_STRETCH);
+    CHECK(scheduler.getIntervalStretch() == doctest::Approx(1.0f));
+}
+
+TEST_CASE("AIScheduler runs every queued decision within a generous budget")
+{
+    // Arrange
+    AIScheduler scheduler;
+    scheduler.setFrameBudget(1000000);
+    int ran = 0;
+
+    for (int id = 0; id < 8; id++)
+        scheduler.request(id, 0.0f);
+
+    // Act
+    int count = scheduler.runFrame([&ran](int)
+                                   { ran++; });
+
+    // Assert
+    CHECK(count == 8);
+    CHECK(ran == 8);
+    CHECK(scheduler.getPendingCount() == 0);
+    CHECK(scheduler.getIntervalStretch() == doctest::Approx(1.0f));
+}
+
+// ==================== INFLUENCE MAP TESTS ====================
+
+TEST_CASE("InfluenceMap fire position scores match TacticalAI scoring")
+{
+    // Arrange
+    Grid grid(12, 10, 32);
+    for (int x = 1; x < 11; x++)
+        grid.setTile(x, 4, TileType::TUNNEL);
+    for (int y = 1; y < 9; y++)
+        grid.setTile(6, y, TileType::TUNNEL);
+
+    Vector2 playerPos = {6 * 32 + 5, 4 * 32};
+    Player player(playerPos);
+    MonsterStore monsters;
+    InfluenceMap influence;
+
+    // Act
+    influence.build(grid, player, monsters, {}, 128.0f);
+
+    // Assert
+    CHECK(influence.describes(grid, playerPos, 128.0f));
+    CHECK_FALSE(influence.describes(grid, {0, 0}, 128.0f));
+    for (int y = 0; y < grid.getHeight(); y++)
+    {
+        for (int x = 0; x < grid.getWidth(); x++)
+        {
+            Vector2 pos = grid.gridToWorld(x, y);
+            bool fireLine = PathFinding::hasDirectTunnelPath(pos, playerPos, grid);
+            CHECK(influence.getFirePositionScore(x, y) ==
+                  TacticalAI::scorePosition(pos, playerPos, grid, fireLine, 128.0f));
+        }
+    }
+}
+
+TEST_CASE("InfluenceMap marks harpoon threat, loose rocks and monster density")
+{
+    // Arrange
+    Grid grid(12, 10, 32);
+    for (int x = 1; x < 11; x++)
+        grid.setTile(x, 4, TileType::TUNNEL);
+    for (int y = 5; y < 8; y++)
+        grid.setTile(2, y, TileType::TUNNEL);
+    grid.setTile(2, 3, TileType::ROCK); // Nothing but tunnel below it
+
+    Player player({5 * 32, 4 * 32}); // Faces right
+    MonsterStore monsters;
+    monsters.resize(2);
+    Monster first({9 * 32, 4 * 32}, MonsterState::IN_TUNNEL);
+    Monster second({9 * 32, 5 * 32}, MonsterState::IN_TUNNEL);
+    monsters.write(0, first, MonsterKind::BASIC);
+    monsters.write(1, second, MonsterKind::BASIC);
+    InfluenceMap influence;
+
+    // Act
+    influence.build(grid, player, monsters, {}, 128.0f);
+
+    // Assert
+    CHECK(influence.getPlayerThreat(8, 4) == InfluenceMap::THREAT_FACING);
+    CHECK(influence.getPlayerThreat(2, 4) == InfluenceMap::THREAT_TURNING);
+    CHECK(influence.getPlayerThreat(5, 5) == 0); // Earth stops the harpoon
+
+    CHECK(influence.getRockDanger(2, 4) == InfluenceMap::DANGER);
+    CHECK(influence.getRockDanger(2, 7) == InfluenceMap::DANGER);
+    CHECK(influence.getRockDanger(2, 8) == 0);
+    CHECK(influence.getRockDanger(3, 4) == 0);
+
+    CHECK(influence.getMonsterDensity(9, 4) == 2);
+    CHECK(influence.getMonsterDensity(10, 6) == 1);
+    CHECK(influence.getMonsterDensity(7, 4) == 0);
+    CHECK(influence.getFireCoverage(8, 4) == 0);
+}
+
+// ==================== UTILITY AI TESTS ====================
+
+TEST_CASE("UtilityAI parses weights files and rejects bad ones whole")
+{
+    // Arrange
+    UtilityWeights weights;
+    std::string good = "# tuning\n"
+                       "dead_end = -45.5   # avoid pockets\n"
+                       "\n"
+                       "  crowding=-3\n"
+                       "chokepoint = 12\n";
+    std::string bad = "alignment = 10\nnot_a_weight = 1\n";
+
+    // Act
+    bool parsedGood = UtilityAI::parseWeights(good, weights);
+    bool parsedBad = UtilityAI::parseWeights(bad, weights);
+
+    // Assert
+    CHECK(parsedGood);
+    CHECK(weights.get(MoveConsideration::DEAD_END) == doctest::Approx(-45.5f));
+    CHECK(weights.get(MoveConsideration::CROWDING) == doctest::Approx(-3.0f));
+    CHECK(weights.get(PositionConsideration::CHOKEPOINT) == doctest::Approx(12.0f));
+    CHECK(weights.get(MoveConsideration::DISTANCE_GAIN) == doctest::Approx(100.0f)); // Untouched default
+    CHECK(weights.usesInfluence());
+
+    CHECK_FALSE(parsedBad);
+    CHECK(weights.get(MoveConsideration::ALIGNMENT) == doctest::Approx(50.0f)); // Nothing applied
+    CHECK_FALSE(UtilityAI::parseWeights("alignment = fast\n", weights));
+    CHECK_FALSE(UtilityAI::loadWeights("no/such/weights.txt"));
+}
+
+TEST_CASE("BatchDirectionSolver agrees with per-monster pathfinding under danger weights")
+{
+    // Arrange - tunnels with loose rocks, a player and a crowd to weigh
+    Grid grid(12, 10, 32);
+    for (int y = 0; y < 10; y++)
+    {
+        for (int x = 0; x < 12; x++)
+        {
+            int pattern = (x * 5 + y * 3 + x * y) % 6;
+            if (pattern < 4)
+                grid.setTile(x, y, TileType::TUNNEL);
+            else if (pattern == 5)
+                grid.setTile(x, y, TileType::ROCK);
+        }
+    }
+    Player player(grid.gridToWorld(3, 3));
+    MonsterStore crowd;
+    crowd.resize(2);
+    crowd.write(0, Monster(grid.gridToWorld(7, 5)), MonsterKind::BASIC);
+    crowd.write(1, Monster(grid.gridToWorld(8, 5)), MonsterKind::BASIC);
+    TacticalAI::getInfluenceMap().build(grid, player, crowd, {}, 128.0f);
+
+    UtilityWeights saved = UtilityAI::getWeights();
+    UtilityAI::parseWeights("player_threat = -70\nrock_danger = -120\ncrowding = -15.5\n", UtilityAI::getWeights());
+
+    Vector2 target = grid.gridToWorld(6, 4);
+    BatchDirectionSolver solver;
+    std::vector<Monster> monsters;
+    for (int y = 0; y < 10; y++)
+    {
+        for (int x = 0; x < 12; x++)
+        {
+            MonsterState state = (x + y) % 2 == 0 ? MonsterState::IN_TUNNEL : MonsterState::DISEMBODIED;
+            monsters.emplace_back(grid.gridToWorld(x, y), state);
+            solver.addQuery(grid.gridToWorld(x, y), target, state, grid);
+        }
+    }
+
+    // Act
+    std::vector<Direction> directions = solver.solve(grid);
+    std::vector<Direction> expected;
+    for (const Monster &monster : monsters)
+    {
+        expected.push_back(PathFinding::findBestDirectionToTarget(
+            monster.getPosition(), target, grid, [&monster, &grid](Vector2 pos)
+            { return monster.canMoveTo(pos, grid); }));
+    }
+    UtilityAI::getWeights() = saved;
+
+    // Assert
+    REQUIRE(directions.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        CHECK(directions[i] == expected[i]);
+}
+
+// ==================== BEHAVIOR TREE TESTS ====================
+
+namespace
+{
+    // Answers conditions from a table and logs every leaf it is asked about
+    struct ScriptedAgent
+    {
+        bool answers[static_cast<int>(BehaviorCondition::COUNT)] = {};
+        BehaviorStatus outcome = BehaviorStatus::SUCCESS;
+        std::vector<std::string> log;
+
+        bool checkCondition(BehaviorCondition condition, float value)
+        {
+            log.push_back("condition " + std::to_string(static_cast<int>(condition)) + " " + std::to_string(static_cast<int>(value)));
+            return answers[static_cast<int>(condition)];
+        }
+
+        BehaviorStatus runAction(BehaviorAction action)
+        {
+            log.push_back("action " + std::to_string(static_cast<int>(action)));
+            return outcome;
+        }
+
+        int random()
+        {
+            return rand();
+        }
+    };
+}
+
+TEST_CASE("BehaviorTree compiles indented text into a pre-order node array")
+{
+    // Arrange
+    std::vector<std::string> text = {
+        "  selector            # root",
+        "    sequence",
+        "      condition idle",
+        "      action chase_player",
+        "",
+        "    branch",
+        "      chance 1 5",
+        "      action random_step",
+        "      invert",
+        "        condition awaiting_route"};
+    BehaviorTree tree;
+    std::string error;
+
+    // Act
+    bool compiled = tree.compile(text, error);
+    const std::vector<BehaviorNode> &nodes = tree.getNodes();
+
+    // Assert
+    REQUIRE(compiled);
+    REQUIRE(nodes.size() == 9);
+    CHECK(nodes[0].type == BehaviorNodeType::SELECTOR);
+    CHECK(nodes[0].end == 9);
+    CHECK(nodes[1].type == BehaviorNodeType::SEQUENCE);
+    CHECK(nodes[1].end == 4); // Next sibling, the branch, starts here
+    CHECK(nodes[3].leaf == static_cast<unsigned char>(BehaviorAction::CHASE_PLAYER));
+    CHECK(nodes[4].type == BehaviorNodeType::BRANCH);
+    CHECK(nodes[5].type == BehaviorNodeType::CHANCE);
+    CHECK(nodes[5].value == doctest::Approx(1.0f));
+    CHECK(nodes[5].modulus == 5);
+    CHECK(nodes[7].type == BehaviorNodeType::INVERT);
+    CHECK(nodes[8].end == 9);
+}
+
+TEST_CASE("BehaviorTree rejects malformed trees and keeps the old one")
+{
+    // Arrange
+    BehaviorTree tree;
+    std::string error;
+    REQUIRE(tree.compile({"action wander"}, error));
+
+    // Act / Assert
+    CHECK_FALSE(tree.compile({"selector", "  action teleport"}, error));
+    CHECK(error.find("teleport") != std::string::npos);
+    CHECK_FALSE(tree.compile({"branch", "  condition idle", "  action wander"}, error)); // Missing else
+    CHECK_FALSE(tree.compile({"invert"}, error));
+    CHECK_FALSE(tree.compile({"sequence", "   condition idle"}, error)); // Odd indent
+    CHECK_FALSE(tree.compile({"action wander", "  condition idle"}, error)); // Child of a leaf
+    CHECK_FALSE(tree.compile({"action wander", "action chase_player"}, error)); // Two roots
+    CHECK_FALSE(tree.compile({"condition player_within"}, error));              // Missing value
+    CHECK_FALSE(tree.compile({"chance 1 0"}, error));
+    CHECK(error.find("line 1") != std::string::npos);
+    REQUIRE(tree.getNodes().size() == 1);
+    CHECK(tree.getNodes()[0].type == BehaviorNodeType::ACTION);
+}
+
+TEST_CASE("BehaviorTree ticks from the root and tracks running leaves")
+{
+    // Arrange - chase if idle, otherwise fall back to a random step
+    BehaviorTree tree;
+    std::string error;
+    REQUIRE(tree.compile({"selector",
+                          "  sequence",
+                          "    condition idle",
+                          "    condition player_closer_than 96",
+                          "    action chase_player",
+                          "  action random_step"},
+                         error));
+    BehaviorState state = BehaviorTree::initialState();
+    ScriptedAgent agent;
+
+    // Act - not idle: the sequence fails at its first leaf
+    BehaviorStatus fellBack = tree.tick(state, agent);
+    std::vector<std::string> firstLog = agent.log;
+
+    agent.answers[static_cast<int>(BehaviorCondition::IDLE)] = true;
+    agent.answers[static_cast<int>(BehaviorCondition::PLAYER_CLOSER_THAN)] = true;
+    agent.outcome = BehaviorStatus::RUNNING;
+    agent.log.clear();
+    tree.tick(state, agent);
+    BehaviorStatus running = tree.tick(state, agent);
+
+    // Assert
+    CHECK(fellBack == BehaviorStatus::SUCCESS);
+    REQUIRE(firstLog.size() == 2);
+    CHECK(firstLog[0] == "condition " + std::to_string(static_cast<int>(BehaviorCondition::IDLE)) + " 0");
+    CHECK(firstLog[1] == "action " + std::to_string(static_cast<int>(BehaviorAction::RANDOM_STEP)));
+
+    CHECK(running == BehaviorStatus::RUNNING);
+    CHECK(agent.log.size() == 6); // Both ticks re-ran the whole sequence
+    CHECK(agent.log[1] == "condition " + std::to_string(static_cast<int>(BehaviorCondition::PLAYER_CLOSER_THAN)) + " 96");
+    CHECK(state.lastLeaf == 4);
+    CHECK(state.runningTicks == 2);
+}
+
+TEST_CASE("BehaviorLibrary loads monster behavior from text")
+{
+    // Arrange - monsters that give up the chase and go ghost at once
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player player(grid.gridToWorld(1, 5));
+    Monster monster(grid.gridToWorld(6, 5), MonsterState::IN_TUNNEL);
+    std::string error;
+
+    BehaviorLibrary saved = BehaviorLibrary::getShared();
+    bool missingDragon = BehaviorLibrary::getShared().parse("tree monster\n  action wander\n", error);
+    std::string missingError = error;
+    bool loaded = BehaviorLibrary::getShared().parse("tree monster\n"
+                                                     "  sequence\n"
+                                                     "    condition in_tunnel\n"
+                                                     "    action become_disembodied\n"
+                                                     "tree green_dragon\n"
+                                                     "  succeed\n",
+                                                     error);
+
+    // Act
+    for (int frame = 0; frame < 60 && monster.getState() == MonsterState::IN_TUNNEL; frame++)
+    {
+        monster.update();
+        monster.updateAI(player, grid, false);
+    }
+    MonsterState state = monster.getState();
+    BehaviorLibrary::getShared() = saved;
+
+    // Assert
+    CHECK_FALSE(missingDragon);
+    CHECK(missingError.find("green_dragon") != std::string::npos);
+    CHECK(loaded);
+    CHECK(state == MonsterState::DISEMBODIED);
+    CHECK_FALSE(BehaviorLibrary().getTree(MonsterKind::RED).getNodes().empty());
+    CHECK_FALSE(saved.load("no/such/behaviors.txt", error));
+}
+
+TEST_CASE("BehaviorLibrary built-in trees match the shipped behaviors file")
+{
+    // Arrange - resources/ sits beside the directory of this file
+    std::string source = __FILE__;
+    std::string path = source.substr(0, source.find_last_of("/\\") + 1) + "../resources/behaviors.txt";
+    BehaviorLibrary shipped;
+    BehaviorLibrary edited;
+    std::string error;
+
+    // Act
+    bool loaded = shipped.load(path, error);
+    edited.parse("tree monster\n  action wander\ntree green_dragon\n  action chase_player\n", error);
+
+    // Assert
+    CHECK(loaded);
+    CHECK(shipped.isBuiltIn(MonsterKind::BASIC));
+    CHECK(shipped.isBuiltIn(MonsterKind::RED));
+    CHECK(shipped.isBuiltIn(MonsterKind::GREEN_DRAGON));
+    CHECK_FALSE(edited.isBuiltIn(MonsterKind::GREEN_DRAGON));
+}
+
+// ==================== LOOKAHEAD SEARCH TESTS ====================
+
+TEST_CASE("LookaheadSearch closes in on a player the dragon cannot yet burn")
+{
+    // Arrange - one straight tunnel, the player facing away up the shaft
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player player(grid.gridToWorld(7, 5));
+    player.move(Direction::UP, grid);
+    player.setPosition(grid.gridToWorld(7, 5));
+    LookaheadSearch search;
+    search.setTimeBudget(1000000);
+    search.setRolloutLimit(600);
+
+    // Act - fire is still cooling down
+    LookaheadChoice choice = search.search(grid.gridToWorld(2, 5), 1.3f, 10.0f, 128.0f, player, grid);
+
+    // Assert
+    CHECK_FALSE(choice.breatheFire);
+    CHECK(choice.direction == Direction::RIGHT);
+    CHECK(search.getLastRollouts() == 600);
+    CHECK(search.getRolloutsPerMs() > 0.0f);
+}
+
+TEST_CASE("LookaheadSearch breathes fire along a clear line in range")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player player(grid.gridToWorld(5, 5));
+    LookaheadSearch search;
+    search.setTimeBudget(1000000);
+    search.setRolloutLimit(300);
+
+    // Act
+    LookaheadChoice choice = search.search(grid.gridToWorld(2, 5), 1.3f, 0.0f, 128.0f, player, grid);
+
+    // Assert
+    CHECK(choice.breatheFire);
+}
+
+TEST_CASE("LookaheadSearch shares one time budget between the searches of a frame")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x < 9; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player player(grid.gridToWorld(7, 5));
+    LookaheadSearch search;
+    search.setTimeBudget(5000);
+
+    // Act - the first search spends the whole budget, the second gets what is left
+    search.beginFrame();
+    search.search(grid.gridToWorld(2, 5), 1.3f, 10.0f, 128.0f, player, grid);
+    double spent = search.getFrameElapsedUs();
+    search.search(grid.gridToWorld(3, 5), 1.3f, 10.0f, 128.0f, player, grid);
+    int lateRollouts = search.getLastRollouts();
+    search.beginFrame();
+    double spentAfterNewFrame = search.getFrameElapsedUs();
+
+    // Assert - a search past the budget still runs one batch between clock reads
+    CHECK(spent >= 5000.0);
+    CHECK(lateRollouts == 16);
+    CHECK(spentAfterNewFrame == 0.0);
+}
+
+TEST_CASE("MonsterManager hard mode lets dragons plan with the lookahead search")
+{
+    // Arrange
+    srand(7);
+    Level level;
+    Player player(level.getPlayerStartPosition());
+    MonsterManager manager;
+    manager.setDragonLookahead(true);
+    manager.initialize(level, level.getPlayerStartPosition());
+    manager.getLookaheadSearch().setTimeBudget(0); // No deadline, so only the rollout limit stops a search
+    manager.getLookaheadSearch().setRolloutLimit(32);
+
+    // Act
+    for (int frame = 0; frame < 120; frame++)
+        manager.update(player, level.getGrid());
+
+    // Assert
+    CHECK(manager.usesDragonLookahead());
+    CHECK(manager.getLookaheadSearch().getLastRollouts() == 32);
+}
+
+// ==================== PERCEPTION BLACKBOARD TESTS ====================
+
+TEST_CASE("PerceptionBlackboard takes the player and monster perceptions once per tick")
+{
+    // Arrange
+    Grid grid(12, 10, 32);
+    for (int x = 1; x < 11; x++)
+        grid.setTile(x, 4, TileType::TUNNEL);
+
+    Player player(grid.gridToWorld(5, 4)); // Faces right
+    MonsterStore monsters;
+    monsters.resize(3);
+    Monster ahead(grid.gridToWorld(9, 4), MonsterState::IN_TUNNEL);
+    Monster behind(grid.gridToWorld(2, 4), MonsterState::IN_TUNNEL);
+    Monster sharing(grid.gridToWorld(9, 4), MonsterState::IN_TUNNEL);
+    monsters.write(0, ahead, MonsterKind::BASIC);
+    monsters.write(1, behind, MonsterKind::BASIC);
+    monsters.write(2, sharing, MonsterKind::BASIC);
+    PerceptionBlackboard board;
+
+    // Act
+    board.build(grid, player, monsters);
+    player.setPosition({5 * 32 + 3, 4 * 32});
+    board.build(grid, player, monsters);
+
+    // Assert
+    CHECK(board.getTick() == 2);
+    CHECK(board.getPlayerTileX() == 5);
+    CHECK(board.getPlayerTileY() == 4);
+    CHECK(board.getPlayerVelocity().x == 3.0f);
+    CHECK(board.getPlayerVelocity().y == 0.0f);
+    CHECK_FALSE(board.isHarpoonOut());
+
+    float dx = player.getPosition().x - ahead.getPosition().x;
+    CHECK(board.getDistanceToPlayer(0) == std::sqrt(dx * dx));
+    CHECK(board.describes(0, ahead.getPosition(), player.getPosition()));
+    CHECK_FALSE(board.describes(0, ahead.getPosition(), grid.gridToWorld(5, 4)));
+    CHECK(board.isInPlayerLine(1));
+    CHECK(board.isFacedByPlayer(0));
+    CHECK_FALSE(board.isFacedByPlayer(1));
+    CHECK(board.isPlayerApproaching(0));
+    CHECK_FALSE(board.isPlayerApproaching(1));
+
+    CHECK(board.getOccupantCount(9, 4) == 2);
+    CHECK(board.getOccupantCount(2, 4) == 1);
+    CHECK(board.getOccupantCount(5, 4) == 0);
+}
+
+TEST_CASE("PerceptionBlackboard spreads the squad across the approaches to the player")
+{
+    // Arrange - a loop of tunnel, the player on its bottom side with a way in from either hand
+    Grid grid(12, 10, 32);
+    for (int x = 3; x <= 9; x++)
+    {
+        grid.setTile(x, 2, TileType::TUNNEL);
+        grid.setTile(x, 5, TileType::TUNNEL);
+    }
+    for (int y = 2; y <= 5; y++)
+    {
+        grid.setTile(3, y, TileType::TUNNEL);
+        grid.setTile(9, y, TileType::TUNNEL);
+    }
+
+    Player player(grid.gridToWorld(6, 5));
+    Vector2 farApproach = grid.gridToWorld(7, 5);
+    MonsterStore monsters;
+    monsters.resize(3);
+    Monster first(grid.gridToWorld(4, 2), MonsterState::IN_TUNNEL);
+    Monster second(grid.gridToWorld(5, 2), MonsterState::IN_TUNNEL);
+    Monster third(grid.gridToWorld(6, 2), MonsterState::IN_TUNNEL);
+    monsters.write(0, first, MonsterKind::BASIC);
+    monsters.write(1, second, MonsterKind::BASIC);
+    monsters.write(2, third, MonsterKind::BASIC);
+    PerceptionBlackboard board;
+    second.setBlackboard(&board, 1);
+
+    // Act
+    board.build(grid, player, monsters);
+
+    // Assert - the second monster goes round the far side rather than queue behind the first
+    CHECK_FALSE(board.hasSquadTarget(0));
+    CHECK(board.hasSquadTarget(1));
+    CHECK(board.getSquadTarget(1).x == farApproach.x);
+    CHECK(board.getSquadTarget(1).y == farApproach.y);
+    CHECK_FALSE(board.hasSquadTarget(2));
+    CHECK(second.chaseTarget(player).x == farApproach.x);
+    CHECK(first.chaseTarget(player).x == player.getPosition().x);
+
+    // Act - without coordination everyone chases the player
+    board.setSquadSpreading(false);
+    board.build(grid, player, monsters);
+
+    // Assert
+    CHECK_FALSE(board.hasSquadTarget(1));
+    CHECK(second.chaseTarget(player).x == player.getPosition().x);
+}
+
+// ==================== DISEMBODIMENT SCHEDULER TESTS ====================
+
+TEST_CASE("DisembodimentScheduler leases its slots and queues the monsters turned away")
+{
+    // Arrange
+    MonsterStore monsters;
+    monsters.resize(4);
+    for (int i = 0; i < 4; i++)
+    {
+        Monster monster({static_cast<float>(i * 32), 0}, MonsterState::IN_TUNNEL);
+        monsters.write(i, monster, MonsterKind::BASIC);
+    }
+    DisembodimentScheduler scheduler;
+    scheduler.setSlots(2);
+    scheduler.setCooldown(0.0f);
+
+    // Act
+    bool firstGoes = scheduler.askForSlot(0) && scheduler.acquire(0);
+    bool secondGoes = scheduler.askForSlot(1) && scheduler.acquire(1);
+    bool thirdMay = scheduler.askForSlot(2);
+    bool fourthMay = scheduler.askForSlot(3);
+
+    // Assert
+    CHECK(firstGoes);
+    CHECK(secondGoes);
+    CHECK_FALSE(thirdMay);
+    CHECK_FALSE(fourthMay);
+    CHECK(scheduler.getActiveCount() == 2);
+    CHECK(scheduler.getQueuedCount() == 2);
+
+    // Act - a ghost resurfaces; its slot is kept for the first monster in the queue
+    scheduler.release(0);
+
+    // Assert
+    CHECK(scheduler.isReservedFor(2));
+    CHECK_FALSE(scheduler.askForSlot(3));
+    CHECK_FALSE(scheduler.acquire(3));
+    CHECK(scheduler.askForSlot(2));
+    CHECK(scheduler.acquire(2));
+    CHECK(scheduler.isHolding(2));
+    CHECK(scheduler.getActiveCount() == 2);
+}
+
+TEST_CASE("DisembodimentScheduler frees the slots of dead ghosts and lets unused reservations lapse")
+{
+    // Arrange
+    MonsterStore monsters;
+    monsters.resize(3);
+    Monster ghost({0, 0}, MonsterState::DISEMBODIED);
+    Monster waiting({32, 0}, MonsterState::IN_TUNNEL);
+    Monster other({64, 0}, MonsterState::IN_TUNNEL);
+    monsters.write(0, ghost, MonsterKind::BASIC);
+    monsters.write(1, waiting, MonsterKind::BASIC);
+    monsters.write(2, other, MonsterKind::BASIC);
+    DisembodimentScheduler scheduler;
+    scheduler.acquire(0);
+    scheduler.askForSlot(1);
+
+    // Act - the ghost is harpooned while the cooldown still runs
+    monsters.setState(0, MonsterState::DEAD);
+    scheduler.advance(1.0f, monsters);
+
+    // Assert
+    CHECK(scheduler.getActiveCount() == 0);
+    CHECK(scheduler.isReservedFor(1));
+    CHECK_FALSE(scheduler.askForSlot(1));
+
+    // Act - the cooldown ends, then the waiting monster lets its turn pass
+    scheduler.advance(DisembodimentScheduler::DEFAULT_COOLDOWN, monsters);
+    bool waitingMay = scheduler.askForSlot(1);
+    bool otherMay = scheduler.askForSlot(2);
+    scheduler.advance(DisembodimentScheduler::RESERVATION_TIME, monsters);
+
+    // Assert
+    CHECK(waitingMay);
+    CHECK_FALSE(otherMay);
+    CHECK_FALSE(scheduler.isReservedFor(1));
+    CHECK(scheduler.askForSlot(2));
+}
+
+// ==================== DECISION PIPELINE TESTS ====================
+
+TEST_CASE("DecisionPipeline runs every item of a batch exactly once")
+{
+    // Arrange
+    DecisionPipeline pipeline(4);
+    std::vector<int> runs(1000, 0);
+
+    // Act
+    for (int batch = 0; batch < 3; batch++)
+        pipeline.run(static_cast<int>(runs.size()), [&runs](int i)
+                     { runs[i]++; });
+    pipeline.setThreadCount(1);
+    pipeline.run(5, [&runs](int i)
+                 { runs[i]++; });
+
+    // Assert
+    CHECK(pipeline.getThreadCount() == 1);
+    CHECK(runs[0] == 4);
+    CHECK(runs[4] == 4);
+    CHECK(std::count(runs.begin() + 5, runs.end(), 3) == static_cast<long>(runs.size()) - 5);
+}
+
+TEST_CASE("MonsterManager decisions come out the same on any number of threads")
+{
+    // Arrange - a crowded level, so the monsters contend for the ghost leases
+    auto play = [](int threads)
+    {
+        srand(11);
+        Level level;
+        Player player(level.getPlayerStartPosition());
+        MonsterManager manager;
+        manager.initialize(level, level.getPlayerStartPosition());
+        manager.getDecisionPipeline().setThreadCount(threads);
+        manager.getPathRequestQueue().setLockstep(true);
+        manager.getDisembodimentScheduler().setCooldown(0.0f);
+
+        const Grid &grid = level.getGrid();
+        int added = 0;
+        for (int y = 0; y < grid.getHeight() && added < 40; y++)
+        {
+            for (int x = 0; x < grid.getWidth() && added < 40; x++)
+            {
+                if (!grid.isTunnel(x, y))
+                    continue;
+                auto monster = std::make_unique<Monster>(grid.gridToWorld(x, y), MonsterState::IN_TUNNEL);
+                monster->setPathRequestQueue(&manager.getPathRequestQueue());
+                monster->setDisembodimentScheduler(&manager.getDisembodimentScheduler());
+                manager.getMonsters().push_back(std::move(monster));
+                added++;
+            }
+        }
+
+        // Act
+        for (int frame = 0; frame < 600; frame++)
+            manager.update(player, level.getGrid());
+
+        std::vector<float> outcome;
+        for (const auto &monster : manager.getMonsters())
+        {
+            outcome.push_back(monster->getPosition().x);
+            outcome.push_back(monster->getPosition().y);
+            outcome.push_back(static_cast<float>(monster->getState()));
+        }
+        return outcome;
+    };
+
+    std::vector<float> serial = play(1);
+    std::vector<float> parallel = play(4);
+
+    // Assert
+    CHECK(serial.size() > 40 * 3);
+    CHECK(serial == parallel);
+}
+
+// ==================== BEHAVIOR SCRIPT TESTS ====================
+
+namespace
+{
+    BehaviorTask countDown(std::vector<std::string> &log)
+    {
+        log.push_back("sub start");
+        co_await nextThink();
+        log.push_back("sub end");
+    }
+
+    BehaviorTask sleepThenCount(std::vector<std::string> &log)
+    {
+        log.push_back("start");
+        co_await seconds(2.0f);
+        log.push_back("awake");
+        co_await countDown(log);
+        log.push_back("back");
+        co_await reachedTile();
+    }
+}
+
+TEST_CASE("BehaviorTask runs scripts as sequential code and reuses pooled frames")
+{
+    // Arrange
+    ScriptFramePool &pool = ScriptFramePool::getShared();
+    int blocksBefore = pool.getBlocksInUse();
+    std::vector<std::string> log;
+
+    {
+        BehaviorTask task = sleepThenCount(log);
+
+        // Act - created suspended, then resumed once per think
+        bool startedEarly = !log.empty();
+        task.resume();
+        ScriptWait firstWait = task.getWait();
+        float sleep = task.getSleepSeconds();
+        task.resume();
+        int blocksInSubScript = pool.getBlocksInUse();
+        ScriptWait subWait = task.getWait();
+        task.resume();
+        ScriptWait lastWait = task.getWait();
+        task.resume();
+
+        // Assert
+        CHECK_FALSE(startedEarly);
+        CHECK(firstWait == ScriptWait::TIME);
+        CHECK(sleep == doctest::Approx(2.0f));
+        CHECK(subWait == ScriptWait::NEXT_THINK);
+        CHECK(blocksInSubScript == blocksBefore + 2);
+        CHECK(lastWait == ScriptWait::TILE);
+        CHECK(task.isDone());
+        REQUIRE(log.size() == 5);
+        CHECK(log[2] == "sub start");
+        CHECK(log[3] == "sub end");
+        CHECK(log[4] == "back");
+    }
+
+    CHECK(pool.getBlocksInUse() == blocksBefore);
+    CHECK(pool.getOversizeCount() == 0);
+}
+
+TEST_CASE("ScriptScheduler wakes sleepers in time order and ignores stale entries")
+{
+    // Arrange
+    ScriptScheduler scheduler;
+    scheduler.sleep(0, 1.0f);
+    scheduler.sleep(1, 0.5f);
+    scheduler.sleep(2, 2.0f);
+
+    // Act - 2 is woken early and sent back to sleep for longer
+    scheduler.wake(2);
+    scheduler.sleep(2, 3.0f);
+    scheduler.advance(0.75f);
+
+    // Assert
+    CHECK(scheduler.getSleepingCount() == 2);
+    CHECK_FALSE(scheduler.isAsleep(1));
+    CHECK(scheduler.isAsleep(0));
+
+    // Act
+    scheduler.advance(1.5f);
+
+    // Assert - the stale two-second entry did not wake it
+    CHECK_FALSE(scheduler.isAsleep(0));
+    CHECK(scheduler.isAsleep(2));
+    CHECK(scheduler.getSleepingCount() == 1);
+
+    // Act
+    scheduler.advance(1.0f);
+
+    // Assert
+    CHECK(scheduler.getSleepingCount() == 0);
+}
+
+TEST_CASE("Scripted monsters sleep without thinking and then hunt")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 8; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player elsewhere(grid.gridToWorld(8, 8));
+    Player nearby(grid.gridToWorld(3, 5));
+    ScriptScheduler scheduler;
+    Monster monster(grid.gridToWorld(1, 5), MonsterState::IN_TUNNEL);
+    monster.setBlackboard(nullptr, 0);
+    monster.setBehaviorScript(MonsterScripts::monster, &scheduler);
+
+    // Act - with the player out of line, the first think settles in
+    for (int frame = 0; frame < 60 && !scheduler.isAsleep(0); frame++)
+    {
+        monster.update();
+        scheduler.advance(GetFrameTime());
+        if (monster.isDecisionDue())
+            monster.updateAI(elsewhere, grid);
+    }
+    bool asleep = scheduler.isAsleep(0);
+    int framesAsleep = 0;
+    bool thoughtWhileAsleep = false;
+    while (scheduler.isAsleep(0) && framesAsleep < 1000)
+    {
+        monster.update();
+        scheduler.advance(GetFrameTime());
+        thoughtWhileAsleep = thoughtWhileAsleep || (scheduler.isAsleep(0) && monster.isDecisionDue());
+        framesAsleep++;
+    }
+    for (int frame = 0; frame < 60 && !monster.isDecisionDue(); frame++)
+        monster.update();
+    monster.updateAI(nearby, grid);
+
+    // Assert
+    CHECK(monster.runsScript());
+    CHECK(asleep);
+    CHECK_FALSE(thoughtWhileAsleep);
+    CHECK(framesAsleep * GetFrameTime() == doctest::Approx(MonsterScripts::SETTLE_TIME).epsilon(0.05));
+    CHECK(monster.getTargetPosition().x > monster.getPosition().x); // Awake, it closes in on the player
+}
+
+TEST_CASE("Green dragons run their script by default and play as the tree does")
+{
+    // Arrange - the same game twice, with the dragons on the script and then on the tree
+    auto play = [](bool scripted, bool hardMode, int &scriptedDragons, int &ghostFrames)
+    {
+        srand(5);
+        Level level;
+        Grid &grid = level.getGrid();
+        Player player(level.getPlayerStartPosition());
+        MonsterManager manager;
+        manager.initialize(level, level.getPlayerStartPosition());
+        manager.getPathRequestQueue().setLockstep(true);
+        manager.setDragonLookahead(hardMode);
+        manager.getLookaheadSearch().setTimeBudget(0); // No deadline, so only the rollout limit stops a search
+        manager.getLookaheadSearch().setRolloutLimit(16);
+
+        scriptedDragons = 0;
+        ghostFrames = 0;
+        for (auto &monster : manager.getMonsters())
+        {
+            if (monster->getKind() != MonsterKind::GREEN_DRAGON)
+                continue;
+            scriptedDragons += monster->runsScript() ? 1 : 0;
+            if (!scripted)
+                monster->setBehaviorScript(nullptr, nullptr);
+        }
+
+        // Act - the player wanders, digging, so the dragons close in, fire and go ghost
+        std::vector<float> outcome;
+        for (int frame = 0; frame < 3000; frame++)
+        {
+            if (frame % 20 == 0)
+                player.move(static_cast<Direction>((frame / 200) % 4), grid);
+            player.update();
+            manager.update(player, grid);
+            for (const auto &monster : manager.getMonsters())
+            {
+                outcome.push_back(monster->getPosition().x);
+                outcome.push_back(monster->getPosition().y);
+                outcome.push_back(static_cast<float>(monster->getState()));
+                if (monster->getKind() == MonsterKind::GREEN_DRAGON && monster->getState() == MonsterState::DISEMBODIED)
+                    ghostFrames++;
+            }
+        }
+        return outcome;
+    };
+    int scriptedDragons = 0;
+    int ghostFrames = 0;
+    int unused = 0;
+
+    for (bool hardMode : {false, true})
+    {
+        // Act
+        std::vector<float> byScript = play(true, hardMode, scriptedDragons, ghostFrames);
+        std::vector<float> byTree = play(false, hardMode, unused, unused);
+
+        // Assert
+        CHECK(scriptedDragons >= 2);
+        CHECK(ghostFrames > 0);
+        CHECK(byScript == byTree);
+    }
+}
+
+// ==================== TIMER WHEEL TESTS ====================
+
+TEST_CASE("TimerWheel fires timers on their tick across levels and ignores cancelled ones")
+{
+    // Arrange
+    TimerWheel wheel;
+    std::vector<int> fired;
+    wheel.schedule(0.5f, [&fired]
+                   { fired.push_back(1); });
+    TimerHandle cancelled = wheel.schedule(0.25f, [&fired]
+                                           { fired.push_back(2); });
+    TimerHandle distant = wheel.schedule(100.0f, [&fired]
+                                         { fired.push_back(3); }); // 6000 ticks: starts two levels up
+    wheel.schedule(0.1f, [&wheel, &fired]
+                   { wheel.schedule(0.1f, [&fired]
+                                    { fired.push_back(4); }); });
+
+    // Act
+    CHECK(wheel.cancel(cancelled));
+    CHECK_FALSE(wheel.cancel(cancelled));
+    for (int frame = 0; frame < 60; frame++)
+        wheel.advance(1.0f / 60.0f);
+
+    // Assert - a timer scheduled from a callback fires too
+    CHECK((fired == std::vector<int>{4, 1}));
+    CHECK(wheel.isPending(distant));
+    CHECK(wheel.getRemaining(distant) == doctest::Approx(99.0f).epsilon(0.001));
+
+    // Act - one frame short of the deadline, then the frame that reaches it
+    for (int frame = 60; frame < 5999; frame++)
+        wheel.advance(1.0f / 60.0f);
+    bool earlyFire = fired.size() > 2;
+    wheel.advance(1.0f / 60.0f);
+
+    // Assert
+    CHECK_FALSE(earlyFire);
+    CHECK(fired.back() == 3);
+    CHECK_FALSE(wheel.isPending(distant));
+    CHECK(wheel.getPendingCount() == 0);
+}
+
+TEST_CASE("Monsters on a timer wheel read their timers off its clock")
+{
+    // Arrange
+    TimerWheel wheel;
+    GreenDragon dragon(Vector2{100, 100});
+    dragon.setTimerWheel(&wheel);
+    Monster monster(Vector2{200, 100});
+    for (int frame = 0; frame < 30; frame++)
+        monster.update();
+    monster.setTimerWheel(&wheel);
+
+    // Act - the dragon's cooldown is a deadline; update() counts nothing
+    bool breathed = dragon.breatheFire(Vector2{132, 100});
+    dragon.getFire().deactivate();
+    for (int frame = 0; frame < 60; frame++)
+    {
+        dragon.update();
+        monster.update();
+    }
+    bool coolingAfterUpdates = !dragon.canBreatheFire();
+    float stateTimeBeforeClock = monster.getStateTimer();
+    for (int frame = 0; frame < 121; frame++)
+        wheel.advance(GetFrameTime());
+
+    // Assert
+    CHECK(breathed);
+    CHECK(coolingAfterUpdates);
+    CHECK(stateTimeBeforeClock == doctest::Approx(30 * GetFrameTime())); // Carried over, not counted on
+    CHECK(dragon.canBreatheFire());
+    CHECK(monster.getStateTimer() == doctest::Approx(stateTimeBeforeClock + 121 * GetFrameTime()));
+}
+
+// ==================== COARSE SIMULATION TESTS ====================
+
+TEST_CASE("Distant monsters step tile to tile until the player comes near")
+{
+    // Arrange - a long corridor with the monster far down it
+    Grid grid(80, 5, 32);
+    for (int x = 1; x < 79; x++)
+        grid.setTile(x, 2, TileType::TUNNEL);
+    Player player(grid.gridToWorld(2, 2));
+    MonsterManager manager;
+    manager.getMonsters().push_back(std::make_unique<Monster>(grid.gridToWorld(70, 2), MonsterState::IN_TUNNEL));
+    manager.setCoarseSimulation(true);
+    manager.setActivationRadius(10.0f);
+
+    // Act
+    manager.update(player, grid);
+    bool coarseAtStart = manager.isCoarse(0);
+    bool onWholeTiles = true;
+    int coarseFrames = 0;
+    while (manager.isCoarse(0) && coarseFrames < 60 * 60)
+    {
+        manager.update(player, grid);
+        Vector2 pos = manager.getMonsters()[0]->getPosition();
+        Vector2 tile = grid.worldToGrid(pos);
+        Vector2 tileCorner = grid.gridToWorld(static_cast<int>(tile.x), static_cast<int>(tile.y));
+        onWholeTiles = onWholeTiles && pos.x == tileCorner.x && pos.y == tileCorner.y;
+        coarseFrames++;
+    }
+    Vector2 activatedAt = manager.getMonsters()[0]->getPosition();
+    bool steppedPerPixel = false;
+    for (int frame = 0; frame < 180; frame++)
+    {
+        manager.update(player, grid);
+        steppedPerPixel = steppedPerPixel || static_cast<int>(manager.getMonsters()[0]->getPosition().x) % 32 != 0;
+    }
+
+    // Assert
+    CHECK(coarseAtStart);
+    CHECK(onWholeTiles);
+    CHECK_FALSE(manager.isCoarse(0));
+    CHECK(manager.getCoarseCount() == 0);
+    CHECK(grid.worldToGrid(activatedAt).x <= 12.0f);
+    // About the pace of full simulation: 1.5 pixels a frame
+    CHECK(coarseFrames * 1.5f / 32.0f == doctest::Approx(70 - grid.worldToGrid(activatedAt).x).epsilon(0.25));
+    CHECK(steppedPerPixel);
+}
+
+// ==================== DECISION TRACE TESTS ====================
+
+TEST_CASE("DecisionTrace keeps the latest decisions and writes them oldest first")
+{
+    // Arrange
+    DecisionTrace trace;
+    const int recorded = DecisionTrace::CAPACITY + 5;
+
+    // Act
+    for (int i = 0; i < recorded; i++)
+    {
+        DecisionRecord decision{};
+        decision.tick = static_cast<std::uint32_t>(i);
+        decision.chosen = static_cast<std::uint8_t>(Direction::LEFT);
+        trace.record(decision);
+    }
+    std::ostringstream out;
+    trace.write(out);
+    std::string bytes = out.str();
+    std::uint32_t count = 0;
+    DecisionRecord first{};
+    DecisionRecord last{};
+    std::memcpy(&count, bytes.data(), sizeof(count));
+    std::memcpy(&first, bytes.data() + sizeof(count), sizeof(first));
+    std::memcpy(&last, bytes.data() + bytes.size() - sizeof(last), sizeof(last));
+
+    // Assert - the five oldest were overwritten
+    CHECK(trace.getCount() == DecisionTrace::CAPACITY);
+    CHECK(trace.getTotalRecorded() == static_cast<std::uint32_t>(recorded));
+    CHECK(trace.getRecord(0).tick == 5);
+    CHECK(trace.getRecord(DecisionTrace::CAPACITY - 1).tick == static_cast<std::uint32_t>(recorded - 1));
+    CHECK(bytes.size() == sizeof(count) + DecisionTrace::CAPACITY * sizeof(DecisionRecord));
+    CHECK(count == static_cast<std::uint32_t>(DecisionTrace::CAPACITY));
+    CHECK(first.tick == 5);
+    CHECK(last.tick == static_cast<std::uint32_t>(recorded - 1));
+    CHECK(last.chosen == static_cast<std::uint8_t>(Direction::LEFT));
+}
+
+TEST_CASE("Monsters trace their thinks only when tracing is compiled in")
+{
+    // Arrange
+    Grid grid(10, 10, 32);
+    for (int x = 1; x <= 8; x++)
+        grid.setTile(x, 5, TileType::TUNNEL);
+    Player player(grid.gridToWorld(4, 5)); // Close enough to be chased
+    MonsterManager manager;
+    manager.getMonsters().push_back(std::make_unique<Monster>(grid.gridToWorld(1, 5), MonsterState::IN_TUNNEL));
+    const std::string path = "decision_trace_test.bin";
+
+    // Act
+    for (int frame = 0; frame < 240; frame++)
+        manager.update(player, grid);
+    bool dumped = manager.dumpDecisionTraces(path);
+    std::remove(path.c_str());
+
+    // Assert
+#if MONSTER_DECISION_TRACE
+    const DecisionTrace &trace = manager.getMonsters()[0]->getDecisionTrace();
+    CHECK(dumped);
+    REQUIRE(trace.getCount() > 0);
+    int firstStep = 0;
+    while (firstStep < trace.getCount() && trace.getRecord(firstStep).chosen == static_cast<std::uint8_t>(Direction::NONE))
+        firstStep++;
+    REQUIRE(firstStep < trace.getCount());
+    const DecisionRecord &stepped = trace.getRecord(firstStep);
+    CHECK(trace.getRecord(0).scorer == DecisionRecord::SCORED_BY_NONE); // Settling in, nothing scored
+    CHECK(stepped.scorer == DecisionRecord::SCORED_BY_ROUTE_TABLE);
+    CHECK(stepped.chosen == static_cast<std::uint8_t>(Direction::RIGHT));
+    CHECK(stepped.scores[static_cast<int>(Direction::UP)] == DecisionRecord::NOT_A_CANDIDATE);
+    CHECK(stepped.scores[static_cast<int>(Direction::RIGHT)] == 2); // From (2,5) to the player at (4,5)
+#else
+    CHECK_FALSE(dumped);
+#endif
+}
+
+// ==================== SPATIAL HASH TESTS ====================
+
+TEST_CASE("SpatialHash hands back every rectangle that overlaps, anywhere on the plane")
+{
+    // Arrange
+    SpatialHash cells;
+    cells.begin(32.0f);
+    cells.insert(0, Rectangle{-70, -70, 28, 28}); // Off the map, to the top left: four cells
+    cells.insert(1, Rectangle{100, 100, 28, 28}); // Four cells
+    cells.insert(2, Rectangle{128, 100, 28, 28}); // Touches 1 edge to edge: two cells
+    cells.insert(3, Rectangle{5000, 40, 28, 28}); // Far right: four cells
+    cells.finish();
+    std::vector<int> nearFirst;
+    std::vector<int> offMap;
+    std::vector<int> everything;
+
+    // Act
+    cells.query(Rectangle{110, 110, 4, 4}, nearFirst);
+    cells.query(Rectangle{-60, -60, 4, 4}, offMap);
+    cells.query(Rectangle{-100000, -100000, 200000, 200000}, everything);
+
+    // Assert - candidates may include near misses, never miss an overlap, and come ascending
+    CHECK(std::find(nearFirst.begin(), nearFirst.end(), 1) != nearFirst.end());
+    CHECK(std::is_sorted(nearFirst.begin(), nearFirst.end()));
+    CHECK(std::find(nearFirst.begin(), nearFirst.end(), 3) == nearFirst.end());
+    CHECK(std::find(offMap.begin(), offMap.end(), 0) != offMap.end());
+    CHECK((everything == std::vector<int>{0, 1, 2, 3}));
+    CHECK(cells.getEntryCount() == 4 + 4 + 2 + 4);
+}
+
+TEST_CASE("MonsterManager broadphase finds the same monsters as a full scan")
+{
+    // Arrange - a crowd at random spots, some dead, probed from random spots
+    MonsterManager manager;
+    unsigned int seed = 12345u;
+    auto next = [&seed](int range)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return static_cast<int>(seed % static_cast<unsigned int>(range));
+    };
+    for (int i = 0; i < 200; i++)
+    {
+        MonsterState state = next(5) == 0 ? MonsterState::DEAD : MonsterState::IN_TUNNEL;
+        Vector2 position = {static_cast<float>(next(640) - 32), static_cast<float>(next(640) - 32)};
+        manager.getMonsters().push_back(std::make_unique<Monster>(position, state));
+    }
+    const MonsterStore &store = manager.getStore();
+    int mismatches = 0;
+    int hits = 0;
+
+    // Act - every probe, and every hit after the first, as the rock check walks them
+    for (int probe = 0; probe < 500; probe++)
+    {
+        Rectangle bounds = {static_cast<float>(next(700) - 50), static_cast<float>(next(700) - 50),
+                            static_cast<float>(1 + next(64)), static_cast<float>(1 + next(64))};
+        int expected = store.findOverlapping(bounds);
+        int actual = manager.findOverlapping(bounds);
+        while (expected != -1 || actual != -1)
+        {
+            if (expected != actual)
+            {
+                mismatches++;
+                break;
+            }
+            hits++;
+            expected = store.findOverlapping(bounds, expected + 1);
+            actual = manager.findOverlapping(bounds, actual + 1);
+        }
+
+        // Kills between queries must be seen without a rebuild
+        if (probe % 50 == 0)
+        {
+            int victim = manager.findOverlapping(bounds);
+            if (victim != -1)
+                manager.killMonster(victim);
+        }
+    }
+
+    // Assert
+    CHECK(hits > 0);
+    CHECK(mismatches == 0);
+}